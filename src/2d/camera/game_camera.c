@@ -0,0 +1,100 @@
+// =============================================================
+// Game Camera source
+// =============================================================
+// Simple 2D camera system for the framework
+#include "game_camera.h"
+#include <math.h>
+#include <stddef.h>
+
+// Copy the camera settings into the raylib camera
+static void SyncGameCamera(GameCamera* camera) {
+    camera->camera.target = camera->target;
+    camera->camera.offset = camera->offset;
+    camera->camera.rotation = camera->rotation;
+    camera->camera.zoom = camera->zoom;
+}
+
+GameCamera InitGameCamera(Vector2 target, Vector2 offset, float rotation, float zoom) {
+    GameCamera camera = {0};
+    camera.target = target;
+    camera.offset = offset;
+    camera.rotation = rotation;
+    camera.zoom = zoom > 0.0f ? zoom : 1.0f;
+    camera.followingTarget = true;
+    camera.smoothing = (Vector2){ 0.0f, 0.0f };
+    SyncGameCamera(&camera);
+    return camera;
+}
+
+// Follow a target. Smoothing is the fraction of the remaining distance
+// covered per second on each axis; 0 snaps straight to the target.
+void UpdateGameCamera(GameCamera* camera, Vector2 newTarget, float deltaTime) {
+    if (camera == NULL) return;
+    if (camera->followingTarget) {
+        float tx = camera->smoothing.x > 0.0f ? fminf(1.0f, camera->smoothing.x * deltaTime) : 1.0f;
+        float ty = camera->smoothing.y > 0.0f ? fminf(1.0f, camera->smoothing.y * deltaTime) : 1.0f;
+        camera->target.x += (newTarget.x - camera->target.x) * tx;
+        camera->target.y += (newTarget.y - camera->target.y) * ty;
+    }
+    SyncGameCamera(camera);
+}
+
+void SetGameCameraTarget(GameCamera* camera, Vector2 target) {
+    if (camera == NULL) return;
+    camera->target = target;
+    SyncGameCamera(camera);
+}
+
+void SetGameCameraOffset(GameCamera* camera, Vector2 offset) {
+    if (camera == NULL) return;
+    camera->offset = offset;
+    SyncGameCamera(camera);
+}
+
+void SetGameCameraZoom(GameCamera* camera, float zoom) {
+    if (camera == NULL || zoom <= 0.0f) return;
+    camera->zoom = zoom;
+    SyncGameCamera(camera);
+}
+
+// World-space rectangle covering everything the camera shows on a
+// viewWidth x viewHeight screen. With rotation this is the bounding box
+// of the rotated view, so it may include a little off-screen space.
+Rectangle GetGameCameraViewRect(const GameCamera* camera, float viewWidth, float viewHeight) {
+    if (camera == NULL || camera->zoom <= 0.0f) return (Rectangle){0};
+    float inverseZoom = 1.0f / camera->zoom;
+    // Screen corners relative to the offset, in world units
+    float left = -camera->offset.x * inverseZoom;
+    float top = -camera->offset.y * inverseZoom;
+    float right = (viewWidth - camera->offset.x) * inverseZoom;
+    float bottom = (viewHeight - camera->offset.y) * inverseZoom;
+    if (camera->rotation == 0.0f) {
+        return (Rectangle){ camera->target.x + left, camera->target.y + top, right - left, bottom - top };
+    }
+
+    // Rotate the corners back into world space (the camera rotates the world by +rotation)
+    float angle = -camera->rotation * DEG2RAD;
+    float c = cosf(angle);
+    float s = sinf(angle);
+    const float xs[4] = { left, right, right, left };
+    const float ys[4] = { top, top, bottom, bottom };
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (int i = 0; i < 4; i++) {
+        float x = xs[i] * c - ys[i] * s;
+        float y = xs[i] * s + ys[i] * c;
+        minX = fminf(minX, x);
+        minY = fminf(minY, y);
+        maxX = fmaxf(maxX, x);
+        maxY = fmaxf(maxY, y);
+    }
+    return (Rectangle){ camera->target.x + minX, camera->target.y + minY, maxX - minX, maxY - minY };
+}
+
+void BeginGameCameraMode(GameCamera* camera) {
+    if (camera == NULL) return;
+    BeginMode2D(camera->camera);
+}
+
+void EndGameCameraMode(void) {
+    EndMode2D();
+}
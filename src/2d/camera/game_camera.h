@@ -23,6 +23,7 @@ void UpdateGameCamera(GameCamera* camera, Vector2 newTarget, float deltaTime);
 void SetGameCameraTarget(GameCamera* camera, Vector2 target);
 void SetGameCameraOffset(GameCamera* camera, Vector2 offset);
 void SetGameCameraZoom(GameCamera* camera, float zoom);
+Rectangle GetGameCameraViewRect(const GameCamera* camera, float viewWidth, float viewHeight);
 void BeginGameCameraMode(GameCamera* camera);
 void EndGameCameraMode(void);
 
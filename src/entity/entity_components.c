@@ -0,0 +1,25 @@
+// =============================================================
+// Entity Components implementation
+// =============================================================
+// Row maintenance for the struct-of-arrays component columns.
+#include "entity_components.h"
+
+// Write every column of a row
+void WriteEntityComponentRow(EntityComponentSpan* span, size_t row, Vector2 position, Vector2 size, Hitbox_t hitbox, SpriteObject* sprite, bool active) {
+    if (span == NULL) return;
+    span->positions[row] = position;
+    span->sizes[row] = size;
+    span->hitboxes[row] = hitbox;
+    span->sprites[row] = sprite;
+    SetEntityRowActive(span, row, active);
+}
+
+// Copy a row over another one, possibly in another span (used by swap-remove)
+void MoveEntityComponentRow(EntityComponentSpan* toSpan, size_t to, const EntityComponentSpan* fromSpan, size_t from) {
+    if (toSpan == NULL || fromSpan == NULL || (toSpan->positions == fromSpan->positions && to == from)) return;
+    toSpan->positions[to] = fromSpan->positions[from];
+    toSpan->sizes[to] = fromSpan->sizes[from];
+    toSpan->hitboxes[to] = fromSpan->hitboxes[from];
+    toSpan->sprites[to] = fromSpan->sprites[from];
+    SetEntityRowActive(toSpan, to, IsEntityRowActive(fromSpan, from));
+}
@@ -0,0 +1,64 @@
+// =============================================================
+// Entity Components header
+// =============================================================
+// Struct-of-arrays storage for the hot entity fields. Rows line up
+// with the dense entity array of the EntityManager, so a system can
+// walk positions/sizes/hitboxes without touching the Entity structs.
+#ifndef ENTITY_COMPONENTS_H
+#define ENTITY_COMPONENTS_H
+
+#include "raylib.h"
+#include "../sprite/sprite_object.h"
+#include "../util/globals.h"
+
+// Simple hitbox definition
+typedef struct {
+    int x, y, w, h;
+} Hitbox_t;
+
+// Rows per active bitset word
+#define ENTITY_ACTIVE_WORD_BITS 64
+#define ENTITY_ACTIVE_WORDS(rows) (((rows) + ENTITY_ACTIVE_WORD_BITS - 1) / ENTITY_ACTIVE_WORD_BITS)
+
+// A contiguous run of component rows (one storage chunk). Every row
+// below count is a live entity; the active bitset tells which of them
+// are active.
+typedef struct {
+    Vector2* positions;
+    Vector2* sizes;
+    Hitbox_t* hitboxes;
+    SpriteObject** sprites;
+    uint64_t* active;
+    size_t count;
+} EntityComponentSpan;
+
+// Active bit helpers
+static inline bool IsEntityRowActive(const EntityComponentSpan* span, size_t row) {
+    return (span->active[row / ENTITY_ACTIVE_WORD_BITS] >> (row % ENTITY_ACTIVE_WORD_BITS)) & 1u;
+}
+
+static inline void SetEntityRowActive(EntityComponentSpan* span, size_t row, bool active) {
+    uint64_t bit = (uint64_t)1 << (row % ENTITY_ACTIVE_WORD_BITS);
+    if (active) span->active[row / ENTITY_ACTIVE_WORD_BITS] |= bit;
+    else span->active[row / ENTITY_ACTIVE_WORD_BITS] &= ~bit;
+}
+
+// Return the first active row at or after row, or span->count if none.
+// for (size_t r = NextActiveEntityRow(&span, 0); r < span.count; r = NextActiveEntityRow(&span, r + 1))
+static inline size_t NextActiveEntityRow(const EntityComponentSpan* span, size_t row) {
+    while (row < span->count) {
+        uint64_t bits = span->active[row / ENTITY_ACTIVE_WORD_BITS] >> (row % ENTITY_ACTIVE_WORD_BITS);
+        if (bits != 0) {
+            row += (size_t)__builtin_ctzll(bits);
+            return row < span->count ? row : span->count;
+        }
+        row = (row | (ENTITY_ACTIVE_WORD_BITS - 1)) + 1;
+    }
+    return span->count;
+}
+
+// Row helpers used by the EntityManager to keep columns in step with its dense array
+void WriteEntityComponentRow(EntityComponentSpan* span, size_t row, Vector2 position, Vector2 size, Hitbox_t hitbox, SpriteObject* sprite, bool active);
+void MoveEntityComponentRow(EntityComponentSpan* toSpan, size_t to, const EntityComponentSpan* fromSpan, size_t from);
+
+#endif // ENTITY_COMPONENTS_H
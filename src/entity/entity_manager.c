@@ -3,132 +3,1946 @@
 // =============================================================
 // Entity management system for handling game entities.
 #include "entity_manager.h"
+#include "../util/asset_manager.h"
+#include "../util/hash_utils.h"
+#include <math.h>
 #include <string.h>
 
 EntityManager* g_EntityManager = NULL;
+MemoryPool g_entityPool = {0};
 
-// Initialize the Entity Manager
+// Number of live rows in a chunk
+static size_t ChunkRowCount(const EntityManager* manager, size_t chunkIndex) {
+    size_t first = chunkIndex * ENTITY_CHUNK_SIZE;
+    if (manager->entityCount <= first) return 0;
+    size_t rows = manager->entityCount - first;
+    return rows < ENTITY_CHUNK_SIZE ? rows : ENTITY_CHUNK_SIZE;
+}
+
+// Build a span over one chunk's component columns
+static EntityComponentSpan ChunkSpan(const EntityManager* manager, size_t chunkIndex) {
+    EntityChunk* chunk = manager->chunks[chunkIndex];
+    return (EntityComponentSpan){
+        chunk->positions, chunk->sizes, chunk->hitboxes,
+        chunk->sprites, chunk->active, ChunkRowCount(manager, chunkIndex)
+    };
+}
+
+// Store an entity pointer at a dense row
+static void SetEntityAtRow(EntityManager* manager, size_t row, Entity* entity) {
+    GetEntityChunk(manager, row)->entities[row & ENTITY_CHUNK_MASK] = entity;
+}
+
+// Copy an entity's hot fields into its component row
+static void WriteEntityRow(EntityManager* manager, size_t row, const Entity* entity) {
+    EntityComponentSpan span = ChunkSpan(manager, row >> ENTITY_CHUNK_SHIFT);
+    WriteEntityComponentRow(&span, row & ENTITY_CHUNK_MASK, entity->position, (Vector2){ entity->width, entity->height },
+                            entity->hitbox, entity->sprite, entity->isActive);
+}
+
+// Allocate one more chunk. Only the directory is ever reallocated, so
+// entities, slots and component rows already handed out stay where they are.
+static bool AddEntityChunk(EntityManager* manager) {
+    // Slot indices must stay clear of the name index markers
+    if ((manager->chunkCount + 1) * (size_t)ENTITY_CHUNK_SIZE >= ENTITY_SLOT_NONE - 1) {
+        printf("Error: Entity slot space exhausted.\n");
+        return false;
+    }
+    if (manager->chunkCount == manager->chunkDirectoryCapacity) {
+        size_t capacity = manager->chunkDirectoryCapacity ? manager->chunkDirectoryCapacity * 2 : 4;
+        EntityChunk** chunks = (EntityChunk**)realloc(manager->chunks, capacity * sizeof(EntityChunk*));
+        if (chunks == NULL) {
+            printf("Error: Memory allocation for entity chunk directory failed.\n");
+            return false;
+        }
+        manager->chunks = chunks;
+        manager->chunkDirectoryCapacity = capacity;
+    }
+    EntityChunk* chunk = (EntityChunk*)malloc(sizeof(EntityChunk));
+    if (chunk == NULL) {
+        printf("Error: Memory allocation for entity chunk failed.\n");
+        return false;
+    }
+    for (size_t i = 0; i < ENTITY_CHUNK_SIZE; i++) {
+        chunk->entities[i] = NULL;
+        // Generations start at 1 so a zeroed handle never validates
+        chunk->slots[i] = (EntitySlot){ 1, ENTITY_SLOT_NONE, ENTITY_SLOT_NONE };
+    }
+    chunk->liveSlots = 0;
+    memset(chunk->active, 0, sizeof(chunk->active));
+    manager->chunks[manager->chunkCount++] = chunk;
+    return true;
+}
+
+// Grow a bucket to hold at least count members
+static bool ReserveBucket(EntityBucket* bucket, size_t count) {
+    if (count <= bucket->capacity) return true;
+    size_t capacity = bucket->capacity ? bucket->capacity : 16;
+    while (capacity < count) capacity *= 2;
+    Entity** members = (Entity**)realloc(bucket->members, capacity * sizeof(Entity*));
+    if (members == NULL) {
+        printf("Error: Memory allocation for entity bucket failed.\n");
+        return false;
+    }
+    bucket->members = members;
+    bucket->capacity = capacity;
+    return true;
+}
+
+// Append an entity to a bucket, growing it if needed
+static bool PushToBucket(EntityBucket* bucket, Entity* entity, uint32_t* outRow) {
+    if (!ReserveBucket(bucket, bucket->count + 1)) return false;
+    *outRow = (uint32_t)bucket->count;
+    bucket->members[bucket->count++] = entity;
+    return true;
+}
+
+// Swap-remove a bucket member. Returns the entity moved into row, or NULL.
+static Entity* RemoveFromBucket(EntityBucket* bucket, uint32_t row) {
+    size_t last = --bucket->count;
+    Entity* moved = NULL;
+    if (row != last) {
+        moved = bucket->members[last];
+        bucket->members[row] = moved;
+    }
+    bucket->members[last] = NULL;
+    return moved;
+}
+
+// Release a bucket's storage
+static void FreeBucket(EntityBucket* bucket) {
+    free(bucket->members);
+    *bucket = (EntityBucket){0};
+}
+
+// Name index markers
+#define NAME_INDEX_EMPTY ENTITY_SLOT_NONE
+#define NAME_INDEX_TOMBSTONE (ENTITY_SLOT_NONE - 1)
+#define NAME_INDEX_MIN_CAPACITY 64
+
+// Place a slot in the name index without any growth checks
+static void InsertNameEntry(EntityNameEntry* table, size_t capacity, uint32_t hash, uint32_t slot) {
+    size_t mask = capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (table[i].slot == NAME_INDEX_EMPTY || table[i].slot == NAME_INDEX_TOMBSTONE) {
+            table[i] = (EntityNameEntry){ hash, slot };
+            return;
+        }
+    }
+}
+
+// Rebuild the name index at a new capacity, dropping tombstones
+static bool RehashNameIndex(EntityManager* manager, size_t capacity) {
+    EntityNameEntry* table = (EntityNameEntry*)malloc(capacity * sizeof(EntityNameEntry));
+    if (table == NULL) {
+        printf("Error: Memory allocation for entity name index failed.\n");
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        table[i] = (EntityNameEntry){ 0, NAME_INDEX_EMPTY };
+    }
+    for (size_t i = 0; i < manager->nameIndexCapacity; i++) {
+        EntityNameEntry entry = manager->nameIndex[i];
+        if (entry.slot != NAME_INDEX_EMPTY && entry.slot != NAME_INDEX_TOMBSTONE) {
+            InsertNameEntry(table, capacity, entry.hash, entry.slot);
+        }
+    }
+    free(manager->nameIndex);
+    manager->nameIndex = table;
+    manager->nameIndexCapacity = capacity;
+    manager->nameIndexUsed = manager->nameIndexCount;
+    return true;
+}
+
+// Make sure extra more names fit without a rehash.
+// Keeps the load factor (tombstones included) at or below one half;
+// a rehash leaves live entries at a quarter so tombstones have room.
+static bool ReserveNameIndex(EntityManager* manager, size_t extra) {
+    if ((manager->nameIndexUsed + extra) * 2 <= manager->nameIndexCapacity) return true;
+    size_t capacity = manager->nameIndexCapacity ? manager->nameIndexCapacity : NAME_INDEX_MIN_CAPACITY;
+    while ((manager->nameIndexCount + extra) * 4 > capacity) capacity *= 2;
+    return RehashNameIndex(manager, capacity);
+}
+
+// Index an entity's name. Unnamed entities are not indexed.
+static void IndexEntityName(EntityManager* manager, const Entity* entity) {
+    if (entity->name[0] == '\0') return;
+    if (!ReserveNameIndex(manager, 1)) return;
+    InsertNameEntry(manager->nameIndex, manager->nameIndexCapacity, entity->nameHash, entity->handle.index);
+    manager->nameIndexCount++;
+    manager->nameIndexUsed++;
+}
+
+// Remove an entity's name from the index, leaving a tombstone
+static void UnindexEntityName(EntityManager* manager, const Entity* entity) {
+    if (entity->name[0] == '\0' || manager->nameIndex == NULL) return;
+    size_t mask = manager->nameIndexCapacity - 1;
+    for (size_t i = entity->nameHash & mask; manager->nameIndex[i].slot != NAME_INDEX_EMPTY; i = (i + 1) & mask) {
+        if (manager->nameIndex[i].slot == entity->handle.index) {
+            manager->nameIndex[i].slot = NAME_INDEX_TOMBSTONE;
+            manager->nameIndexCount--;
+            return;
+        }
+    }
+}
+
+// Take an entity out of its behaviour's member list
+static void LeaveBehaviour(EntityManager* manager, Entity* entity) {
+    if (entity->behaviourId == ENTITY_BEHAVIOUR_NONE) return;
+    Entity* movedMember = RemoveFromBucket(&manager->behaviours[entity->behaviourId].bucket, entity->behaviourRow);
+    if (movedMember != NULL) movedMember->behaviourRow = entity->behaviourRow;
+    entity->behaviourId = ENTITY_BEHAVIOUR_NONE;
+}
+
+// Put an entity in a behaviour's member list
+static bool JoinBehaviour(EntityManager* manager, Entity* entity, EntityBehaviourId behaviourId) {
+    if (behaviourId == ENTITY_BEHAVIOUR_NONE || behaviourId > manager->behaviourCount) {
+        entity->behaviourId = ENTITY_BEHAVIOUR_NONE;
+        return behaviourId == ENTITY_BEHAVIOUR_NONE;
+    }
+    if (!PushToBucket(&manager->behaviours[behaviourId].bucket, entity, &entity->behaviourRow)) {
+        entity->behaviourId = ENTITY_BEHAVIOUR_NONE;
+        return false;
+    }
+    entity->behaviourId = behaviourId;
+    return true;
+}
+
+// Whether a signature has every required bit and no excluded one
+static bool QueryMatches(const EntityQuery* query, EntitySignature signature) {
+    return (signature & query->required) == query->required && (signature & query->excluded) == 0;
+}
+
+// Grow a query's member arrays to hold at least count members
+static bool ReserveQueryMembers(EntityQuery* query, size_t count) {
+    if (count <= query->capacity) return true;
+    size_t capacity = query->capacity ? query->capacity : 16;
+    while (capacity < count) capacity *= 2;
+    Entity** members = (Entity**)realloc(query->members, capacity * sizeof(Entity*));
+    if (members == NULL) {
+        printf("Error: Memory allocation for entity query failed.\n");
+        return false;
+    }
+    query->members = members;
+    uint32_t* rows = (uint32_t*)realloc(query->rows, capacity * sizeof(uint32_t));
+    if (rows == NULL) {
+        printf("Error: Memory allocation for entity query failed.\n");
+        return false;
+    }
+    query->rows = rows;
+    query->capacity = capacity;
+    return true;
+}
+
+// Grow a query's position table to cover slotCount slots
+static bool ReserveQueryPositions(EntityQuery* query, size_t slotCount) {
+    if (slotCount <= query->positionCapacity) return true;
+    size_t capacity = query->positionCapacity ? query->positionCapacity : ENTITY_CHUNK_SIZE;
+    while (capacity < slotCount) capacity *= 2;
+    uint32_t* positions = (uint32_t*)realloc(query->positions, capacity * sizeof(uint32_t));
+    if (positions == NULL) {
+        printf("Error: Memory allocation for entity query failed.\n");
+        return false;
+    }
+    for (size_t i = query->positionCapacity; i < capacity; i++) {
+        positions[i] = ENTITY_SLOT_NONE;
+    }
+    query->positions = positions;
+    query->positionCapacity = capacity;
+    return true;
+}
+
+// Append an entity (living at a dense row) to a query
+static void AddQueryMember(EntityQuery* query, Entity* entity, uint32_t row) {
+    if (!ReserveQueryPositions(query, (size_t)entity->handle.index + 1) ||
+        !ReserveQueryMembers(query, query->count + 1)) {
+        return;
+    }
+    query->positions[entity->handle.index] = (uint32_t)query->count;
+    query->members[query->count] = entity;
+    query->rows[query->count++] = row;
+}
+
+// Swap-remove an entity from a query if it is a member
+static void RemoveQueryMember(EntityQuery* query, const Entity* entity) {
+    uint32_t slot = entity->handle.index;
+    if (slot >= query->positionCapacity || query->positions[slot] == ENTITY_SLOT_NONE) return;
+    uint32_t position = query->positions[slot];
+    size_t last = --query->count;
+    if (position != last) {
+        Entity* moved = query->members[last];
+        query->members[position] = moved;
+        query->rows[position] = query->rows[last];
+        query->positions[moved->handle.index] = position;
+    }
+    query->positions[slot] = ENTITY_SLOT_NONE;
+}
+
+// Release a query's members, keeping its signature
+static void ClearQuery(EntityQuery* query) {
+    free(query->members);
+    free(query->rows);
+    free(query->positions);
+    *query = (EntityQuery){ .required = query->required, .excluded = query->excluded };
+}
+
+// Switch a managed entity to a new signature, joining and leaving
+// only the queries whose result changes
+static void ChangeEntitySignature(EntityManager* manager, Entity* entity, EntitySignature signature) {
+    if (signature == entity->signature) return;
+    uint32_t row = GetEntitySlot(manager, entity->handle.index)->row;
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        EntityQuery* query = &manager->queries[i];
+        bool matched = QueryMatches(query, entity->signature);
+        bool matches = QueryMatches(query, signature);
+        if (matched && !matches) RemoveQueryMember(query, entity);
+        else if (!matched && matches) AddQueryMember(query, entity, row);
+    }
+    entity->signature = signature;
+}
+
+// Add an entity to the simulation awake list
+static void PushAwakeEntity(EntitySimulationLod* simulation, EntityHandle handle) {
+    if (simulation->awakeCount == simulation->awakeCapacity) {
+        size_t capacity = simulation->awakeCapacity ? simulation->awakeCapacity * 2 : 256;
+        EntityHandle* awake = (EntityHandle*)realloc(simulation->awake, capacity * sizeof(EntityHandle));
+        if (awake == NULL) {
+            printf("Error: Memory allocation for entity simulation list failed.\n");
+            return;
+        }
+        simulation->awake = awake;
+        simulation->awakeCapacity = capacity;
+    }
+    simulation->awake[simulation->awakeCount++] = handle;
+}
+
+// Free an entity and the sprite it owns. Entities not created by
+// CreateEntity are assumed to come from malloc. Only for entities the
+// manager does not hold; managed ones go through RemoveEntity.
+void DestroyEntity(Entity* entity) {
+    if (entity == NULL) return;
+    UnloadSpriteObject(entity->sprite);
+    if (PoolOwns(&g_entityPool, entity)) {
+        PoolFree(&g_entityPool, entity);
+    } else {
+        free(entity);
+    }
+}
+
+// Drop an entity's slot, name and type membership, then free it.
+// Leaves a NULL hole at its row for the caller to fill.
+static void DetachEntityRow(EntityManager* manager, size_t row) {
+    Entity* entity = GetEntityAtRow(manager, row);
+    manager->gridDirty = true;
+    UnindexEntityName(manager, entity);
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        RemoveQueryMember(&manager->queries[i], entity);
+    }
+    RemoveEntityTransformNode(&manager->transforms, entity->transformNode);
+    EntitySlot* slot = GetEntitySlot(manager, entity->handle.index);
+    GetEntityChunk(manager, entity->handle.index)->liveSlots--;
+    slot->generation++;
+    slot->row = ENTITY_SLOT_NONE;
+    slot->nextFree = manager->freeSlot;
+    manager->freeSlot = entity->handle.index;
+
+    if (entity->typeId != ENTITY_TYPE_NONE) {
+        Entity* movedMember = RemoveFromBucket(&manager->types[entity->typeId].bucket, entity->typeRow);
+        if (movedMember != NULL) movedMember->typeRow = entity->typeRow;
+    }
+    LeaveBehaviour(manager, entity);
+    SetEntityAtRow(manager, row, NULL);
+    DestroyEntity(entity);
+}
+
+// Move a row (and its component columns) to a new position
+static void MoveEntityRow(EntityManager* manager, size_t to, size_t from) {
+    Entity* moved = GetEntityAtRow(manager, from);
+    SetEntityAtRow(manager, to, moved);
+    SetEntityAtRow(manager, from, NULL);
+    GetEntitySlot(manager, moved->handle.index)->row = (uint32_t)to;
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        EntityQuery* query = &manager->queries[i];
+        if (moved->handle.index < query->positionCapacity && query->positions[moved->handle.index] != ENTITY_SLOT_NONE) {
+            query->rows[query->positions[moved->handle.index]] = (uint32_t)to;
+        }
+    }
+    if (manager->useComponentStore) {
+        EntityComponentSpan toSpan = ChunkSpan(manager, to >> ENTITY_CHUNK_SHIFT);
+        EntityComponentSpan fromSpan = ChunkSpan(manager, from >> ENTITY_CHUNK_SHIFT);
+        MoveEntityComponentRow(&toSpan, to & ENTITY_CHUNK_MASK, &fromSpan, from & ENTITY_CHUNK_MASK);
+    }
+}
+
+// Release the entity at the given row and swap the last row into the hole
+static void ReleaseEntityRow(EntityManager* manager, size_t row) {
+    DetachEntityRow(manager, row);
+    size_t last = --manager->entityCount;
+    if (row != last) {
+        MoveEntityRow(manager, row, last);
+    }
+}
+
+// Close every hole left by DetachEntityRow in one ordered pass
+static void CompactEntityRows(EntityManager* manager) {
+    size_t write = 0;
+    for (size_t read = 0; read < manager->entityCount; read++) {
+        if (GetEntityAtRow(manager, read) == NULL) continue;
+        if (write != read) {
+            MoveEntityRow(manager, write, read);
+        }
+        write++;
+    }
+    manager->entityCount = write;
+}
+
+// Set up the entity pool on first use
+static bool EnsureEntityPool(void) {
+    return g_entityPool.initialized ||
+           InitMemoryPool(&g_entityPool, "Entity", sizeof(Entity), ENTITY_POOL_SLAB_SIZE);
+}
+
+// Allocate a zeroed entity from the entity pool. Ownership passes to the
+// manager on AddEntity.
+Entity* CreateEntity(void) {
+    if (!EnsureEntityPool()) return NULL;
+    Entity* entity = (Entity*)PoolAlloc(&g_entityPool);
+    if (entity == NULL) {
+        printf("Error: Memory allocation for entity failed.\n");
+        return NULL;
+    }
+    memset(entity, 0, sizeof(Entity));
+    return entity;
+}
+
+// Initialize the Entity Manager with the default capacity and no limit
 void InitEntityManager(EntityManager* manager) {
-    if (manager == NULL) return;
+    InitEntityManagerWithCapacity(manager, DEFAULT_ENTITY_CAPACITY, 0);
+}
+
+// Initialize the Entity Manager, reserving room for initialCapacity
+// entities up front. maxEntities caps growth (0 for no limit).
+bool InitEntityManagerWithCapacity(EntityManager* manager, size_t initialCapacity, size_t maxEntities) {
+    if (manager == NULL) return false;
+    manager->chunks = NULL;
+    manager->chunkCount = 0;
+    manager->chunkDirectoryCapacity = 0;
+    manager->maxEntities = maxEntities;
     manager->entityCount = 0;
+    manager->slotCount = 0;
+    manager->freeSlot = ENTITY_SLOT_NONE;
     manager->state = ENTITY_MANAGER_INITIALIZED;
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        manager->entities[i] = NULL;
+    manager->useComponentStore = false;
+    memset(manager->types, 0, sizeof(manager->types));
+    manager->typeCount = 0;
+    memset(manager->behaviours, 0, sizeof(manager->behaviours));
+    manager->behaviourCount = 0;
+    memset(manager->prefabs, 0, sizeof(manager->prefabs));
+    manager->prefabCount = 0;
+    memset(manager->componentTypes, 0, sizeof(manager->componentTypes));
+    manager->componentTypeCount = 0;
+    memset(manager->queries, 0, sizeof(manager->queries));
+    manager->queryCount = 0;
+    manager->nameIndex = NULL;
+    manager->nameIndexCapacity = 0;
+    manager->nameIndexCount = 0;
+    manager->nameIndexUsed = 0;
+    InitEntityCommandBuffer(&manager->commands);
+    manager->updating = false;
+    InitEntitySpatialGrid(&manager->grid, ENTITY_GRID_DEFAULT_CELL_SIZE);
+    manager->gridDirty = true;
+    manager->gridScratch = NULL;
+    manager->gridScratchCapacity = 0;
+    manager->pairScratch = NULL;
+    manager->pairScratchCapacity = 0;
+    InitEntityTransformHierarchy(&manager->transforms);
+    memset(&manager->simulation, 0, sizeof(manager->simulation));
+    return ReserveEntities(manager, initialCapacity);
+}
+
+// Make sure capacity entities fit without further allocation
+bool ReserveEntities(EntityManager* manager, size_t capacity) {
+    if (manager == NULL) return false;
+    if (manager->maxEntities > 0 && capacity > manager->maxEntities) {
+        capacity = manager->maxEntities;
+    }
+    while (GetEntityCapacity(manager) < capacity) {
+        if (!AddEntityChunk(manager)) return false;
     }
+    return true;
+}
+
+// Number of entities that fit in the chunks allocated so far
+size_t GetEntityCapacity(const EntityManager* manager) {
+    if (manager == NULL) return 0;
+    return manager->chunkCount * ENTITY_CHUNK_SIZE;
+}
+
+// Occupancy of one chunk. Returns false past the last chunk.
+bool GetEntityChunkStats(const EntityManager* manager, size_t chunkIndex, EntityChunkStats* outStats) {
+    if (manager == NULL || outStats == NULL || chunkIndex >= manager->chunkCount) return false;
+    size_t firstSlot = chunkIndex * ENTITY_CHUNK_SIZE;
+    size_t usedSlots = manager->slotCount > firstSlot ? manager->slotCount - firstSlot : 0;
+    *outStats = (EntityChunkStats){
+        .rows = ChunkRowCount(manager, chunkIndex),
+        .liveSlots = manager->chunks[chunkIndex]->liveSlots,
+        .usedSlots = usedSlots < ENTITY_CHUNK_SIZE ? usedSlots : ENTITY_CHUNK_SIZE,
+        .bytes = sizeof(EntityChunk)
+    };
+    return true;
+}
+
+// Print capacity and per-chunk occupancy
+void PrintEntityMemoryStats(const EntityManager* manager) {
+    if (manager == NULL) return;
+
+    printf("=== Entity Manager Stats ===\n");
+    printf("Entities: %zu / %zu\n", manager->entityCount, GetEntityCapacity(manager));
+    if (manager->maxEntities > 0) {
+        printf("Entity Limit: %zu\n", manager->maxEntities);
+    }
+    printf("Chunks: %zu x %zu bytes\n", manager->chunkCount, sizeof(EntityChunk));
+
+    EntityChunkStats stats;
+    for (size_t i = 0; GetEntityChunkStats(manager, i, &stats); i++) {
+        printf("  Chunk %zu - rows %zu/%u - slots %zu live, %zu used\n",
+               i, stats.rows, ENTITY_CHUNK_SIZE, stats.liveSlots, stats.usedSlots);
+    }
+}
+
+// Unload every entity and release all of the manager's storage
+void FreeEntityManager(EntityManager* manager) {
+    if (manager == NULL) return;
+    UnloadAllEntities(manager);
+    // Prefabs hold a reference to their template texture
+    for (size_t i = 0; i < manager->prefabCount; i++) {
+        const SpriteObject* sprite = &manager->prefabs[i].prefab.sprite;
+        if (sprite->sharedTexture) ReleaseAssetTexture(sprite->textureHandle);
+    }
+    manager->prefabCount = 0;
+    for (size_t i = 0; i < manager->chunkCount; i++) {
+        free(manager->chunks[i]);
+    }
+    free(manager->chunks);
+    manager->chunks = NULL;
+    manager->chunkCount = 0;
+    manager->chunkDirectoryCapacity = 0;
+    manager->slotCount = 0;
+    manager->freeSlot = ENTITY_SLOT_NONE;
+}
+
+// Give an entity a slot and a row and link it into the type and behaviour
+// indexes, but not the name index. The type must already be interned and
+// the chunks must have room for one more slot.
+static EntityHandle LinkEntity(EntityManager* manager, Entity* entity) {
+    // Join the member lists before taking a slot
+    if (!JoinBehaviour(manager, entity, entity->behaviourId)) {
+        printf("Warning: Entity %d has an unknown behaviour, adding it without one.\n", entity->id);
+    }
+    if (entity->typeId != ENTITY_TYPE_NONE &&
+        !PushToBucket(&manager->types[entity->typeId].bucket, entity, &entity->typeRow)) {
+        LeaveBehaviour(manager, entity);
+        return (EntityHandle){0};
+    }
+
+    // Reuse a free slot if there is one, otherwise take a fresh one
+    uint32_t index = manager->freeSlot;
+    if (index != ENTITY_SLOT_NONE) {
+        manager->freeSlot = GetEntitySlot(manager, index)->nextFree;
+    } else {
+        index = manager->slotCount++;
+    }
+
+    EntitySlot* slot = GetEntitySlot(manager, index);
+    GetEntityChunk(manager, index)->liveSlots++;
+    slot->row = (uint32_t)manager->entityCount;
+    slot->nextFree = ENTITY_SLOT_NONE;
+    entity->handle = (EntityHandle){ index, slot->generation };
+    // New entities run at full rate until the next simulation refresh
+    entity->simulationTier = ENTITY_SIMULATION_FULL;
+    if (manager->simulation.enabled) PushAwakeEntity(&manager->simulation, entity->handle);
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        if (QueryMatches(&manager->queries[i], entity->signature)) {
+            AddQueryMember(&manager->queries[i], entity, (uint32_t)manager->entityCount);
+        }
+    }
+    if (manager->useComponentStore) {
+        WriteEntityRow(manager, manager->entityCount, entity);
+    }
+    SetEntityAtRow(manager, manager->entityCount++, entity);
+    manager->gridDirty = true;
+    return entity->handle;
+}
+
+// Link an entity and index its name. The name must already be hashed.
+static EntityHandle InsertEntity(EntityManager* manager, Entity* entity) {
+    EntityHandle handle = LinkEntity(manager, entity);
+    if (handle.generation != 0) IndexEntityName(manager, entity);
+    return handle;
 }
 
 // Add an entity to the manager
-void AddEntity(EntityManager* manager, Entity* entity) {
-    if (manager == NULL || entity == NULL) return;
-    if (manager->entityCount >= MAX_ENTITIES) {
+// While entities are updating the spawn is deferred and the returned handle
+// is zero; the entity's handle field is filled in when the spawn is flushed.
+// A deferred spawn hands ownership to the manager.
+EntityHandle AddEntity(EntityManager* manager, Entity* entity) {
+    if (manager == NULL || entity == NULL) return (EntityHandle){0};
+    if (manager->updating) {
+        RecordSpawnEntity(&manager->commands, entity);
+        return (EntityHandle){0};
+    }
+    if (manager->maxEntities > 0 && manager->entityCount >= manager->maxEntities) {
         printf("Error: Maximum entity limit reached.\n");
-        return;
+        return (EntityHandle){0};
     }
-    manager->entities[manager->entityCount++] = entity;
+    // Every slot is live once the free list is empty, so that is the only time to grow
+    if (manager->freeSlot == ENTITY_SLOT_NONE && manager->slotCount == GetEntityCapacity(manager) &&
+        !AddEntityChunk(manager)) {
+        return (EntityHandle){0};
+    }
+
+    // A transform node from another manager (or a copied entity) is not ours
+    entity->transformNode = ENTITY_TRANSFORM_NONE;
+    // Intern the type and hash the name, then take a slot
+    entity->typeId = entity->entityType != NULL ? RegisterEntityType(manager, entity->entityType) : ENTITY_TYPE_NONE;
+    if (entity->typeId != ENTITY_TYPE_NONE) {
+        entity->entityType = manager->types[entity->typeId].name;
+    }
+    entity->nameHash = HashEntityName(entity->name);
+    return InsertEntity(manager, entity);
+}
+
+// Make room for count entities (spriteCount of them with sprites) in one
+// pass. typeCounts and behaviourCounts are indexed by ID and may be NULL.
+// Query members are reserved for entities with an empty signature.
+bool ReserveEntityInsertion(EntityManager* manager, size_t count, size_t spriteCount,
+                            const size_t* typeCounts, const size_t* behaviourCounts) {
+    if (manager == NULL || manager->updating) return false;
+    if (manager->maxEntities > 0 && manager->entityCount + count > manager->maxEntities) {
+        printf("Error: Maximum entity limit reached.\n");
+        return false;
+    }
+    bool reserved = ReserveEntities(manager, manager->entityCount + count) &&
+                    EnsureEntityPool() &&
+                    ReserveMemoryPool(&g_entityPool, g_entityPool.liveCount + count) &&
+                    (spriteCount == 0 || ReserveSpriteObjects(spriteCount)) &&
+                    ReserveNameIndex(manager, count);
+    for (size_t i = 0; reserved && typeCounts != NULL && i < manager->typeCount; i++) {
+        EntityBucket* bucket = &manager->types[i].bucket;
+        reserved = ReserveBucket(bucket, bucket->count + typeCounts[i]);
+    }
+    for (size_t i = 1; reserved && behaviourCounts != NULL && i <= manager->behaviourCount; i++) {
+        EntityBucket* bucket = &manager->behaviours[i].bucket;
+        reserved = ReserveBucket(bucket, bucket->count + behaviourCounts[i]);
+    }
+    for (size_t i = 0; reserved && i < manager->queryCount; i++) {
+        EntityQuery* query = &manager->queries[i];
+        if (QueryMatches(query, 0)) {
+            reserved = ReserveQueryPositions(query, GetEntityCapacity(manager)) &&
+                       ReserveQueryMembers(query, query->count + count);
+        }
+    }
+    if (!reserved) printf("Error: Could not reserve room for %zu entities.\n", count);
+    return reserved;
+}
+
+// Add entities after ReserveEntityInsertion. Each one's type must already
+// be interned (typeId and entityType) and its nameHash set. Names are
+// indexed once the whole batch is linked, so the index probes do not wait
+// on each other. Returns how many were added, from the front of the array;
+// the rest still belong to the caller.
+size_t InsertReservedEntities(EntityManager* manager, Entity** entities, size_t count) {
+    if (manager == NULL || entities == NULL || manager->updating) return 0;
+    size_t inserted = 0;
+    for (; inserted < count; inserted++) {
+        Entity* entity = entities[inserted];
+        if ((manager->maxEntities > 0 && manager->entityCount >= manager->maxEntities) ||
+            (manager->freeSlot == ENTITY_SLOT_NONE && manager->slotCount == GetEntityCapacity(manager)) ||
+            (entity->typeId != ENTITY_TYPE_NONE && entity->typeId >= manager->typeCount)) {
+            printf("Error: Entity %d was not reserved for insertion.\n", entity->id);
+            break;
+        }
+        entity->transformNode = ENTITY_TRANSFORM_NONE;
+        if (LinkEntity(manager, entity).generation == 0) break;
+    }
+    for (size_t i = 0; i < inserted; i++) {
+        IndexEntityName(manager, entities[i]);
+    }
+    return inserted;
 }
 
 // Remove an entity by ID
 void RemoveEntity(EntityManager* manager, int entityId) {
     if (manager == NULL) return;
     for (size_t i = 0; i < manager->entityCount; i++) {
-        if (manager->entities[i] != NULL && manager->entities[i]->id == entityId) {
-            if (manager->entities[i]->sprite != NULL) {
-                UnloadTexture(manager->entities[i]->sprite->texture);
-                free(manager->entities[i]->sprite);
-            }
-            free(manager->entities[i]);
-            manager->entities[i] = NULL;
-            // Shift remaining entities
-            for (size_t j = i; j < manager->entityCount - 1; j++) {
-                manager->entities[j] = manager->entities[j + 1];
+        Entity* entity = GetEntityAtRow(manager, i);
+        if (entity->id == entityId) {
+            if (manager->updating) {
+                RecordDespawnEntity(&manager->commands, entity->handle);
+            } else {
+                ReleaseEntityRow(manager, i);
             }
-            manager->entities[--manager->entityCount] = NULL;
             return;
         }
     }
     printf("Warning: Entity with ID %d not found.\n", entityId);
 }
 
-// Update all entities
+// Remove an entity by handle. Stale handles are ignored.
+// While entities are updating the removal is deferred.
+bool RemoveEntityByHandle(EntityManager* manager, EntityHandle handle) {
+    if (!IsEntityHandleValid(manager, handle)) return false;
+    if (manager->updating) {
+        RecordDespawnEntity(&manager->commands, handle);
+        return true;
+    }
+    ReleaseEntityRow(manager, GetEntitySlot(manager, handle.index)->row);
+    return true;
+}
+
+// Advance the simulation frame and work out which tiers run in it
+static void BeginSimulationFrame(EntitySimulationLod* simulation, float deltaTime, bool* due) {
+    simulation->frame++;
+    simulation->refreshTime += deltaTime;
+    memset(simulation->stats.updated, 0, sizeof(simulation->stats.updated));
+    for (size_t tier = 0; tier < ENTITY_SIMULATION_AWAKE_TIERS; tier++) {
+        simulation->tierTime[tier] += deltaTime;
+        due[tier] = (simulation->frame & (simulation->settings.interval[tier] - 1)) == 0;
+    }
+}
+
+// Whether an entity's tier runs this frame, and with what time step
+static bool TakeSimulationStep(EntitySimulationLod* simulation, const Entity* entity, const bool* due, float* outStep) {
+    uint8_t tier = entity->simulationTier;
+    if (tier >= ENTITY_SIMULATION_AWAKE_TIERS || !due[tier]) return false;
+    *outStep = simulation->tierTime[tier];
+    return true;
+}
+
+// Run a behaviour's batch once per due tier, each with its own time step
+static void UpdateBehaviourByTier(EntitySimulationLod* simulation, const EntityBehaviourInfo* info, const bool* due) {
+    const EntityBucket* bucket = &info->bucket;
+    if (bucket->count > simulation->batchCapacity) {
+        Entity** batch = (Entity**)realloc(simulation->batch, bucket->count * sizeof(Entity*));
+        if (batch == NULL) {
+            printf("Error: Memory allocation for entity simulation batch failed.\n");
+            return;
+        }
+        simulation->batch = batch;
+        simulation->batchCapacity = bucket->count;
+    }
+
+    // Counting sort of the members by tier
+    size_t start[ENTITY_SIMULATION_TIER_COUNT + 1] = {0};
+    for (size_t i = 0; i < bucket->count; i++) {
+        start[bucket->members[i]->simulationTier + 1]++;
+    }
+    for (size_t tier = 0; tier < ENTITY_SIMULATION_TIER_COUNT; tier++) {
+        start[tier + 1] += start[tier];
+    }
+    size_t cursor[ENTITY_SIMULATION_TIER_COUNT];
+    memcpy(cursor, start, sizeof(cursor));
+    for (size_t i = 0; i < bucket->count; i++) {
+        simulation->batch[cursor[bucket->members[i]->simulationTier]++] = bucket->members[i];
+    }
+
+    for (size_t tier = 0; tier < ENTITY_SIMULATION_AWAKE_TIERS; tier++) {
+        if (due[tier] && start[tier + 1] > start[tier]) {
+            info->behaviour.UpdateBatch(simulation->batch + start[tier], start[tier + 1] - start[tier],
+                                        simulation->tierTime[tier], info->behaviour.userData);
+            simulation->stats.updated[tier] += start[tier + 1] - start[tier];
+        }
+    }
+}
+
+// Reset the tiers that ran and refresh tiers once every tier has run
+static void EndSimulationFrame(EntityManager* manager, const bool* due) {
+    EntitySimulationLod* simulation = &manager->simulation;
+    for (size_t tier = 0; tier < ENTITY_SIMULATION_AWAKE_TIERS; tier++) {
+        if (due[tier]) simulation->tierTime[tier] = 0.0f;
+    }
+    uint32_t refreshInterval = simulation->settings.interval[ENTITY_SIMULATION_AWAKE_TIERS - 1];
+    if ((simulation->frame & (refreshInterval - 1)) == 0) {
+        RefreshEntitySimulationTiers(manager);
+    }
+}
+
+// Update all entities. Spawns and removals made by Update callbacks are
+// deferred and applied once the walk is over, as the frame's sync point.
+// With simulation LOD enabled, entities in reduced tiers are updated every
+// Nth frame with the time accumulated since, and sleeping ones are skipped.
 void UpdateEntities(EntityManager* manager, float deltaTime) {
     if (manager == NULL) return;
-    for (size_t i = 0; i < manager->entityCount; i++) {
-        Entity* entity = manager->entities[i];
-        if (entity != NULL && entity->isActive && entity->interface != NULL && entity->interface->Update != NULL) {
-            entity->interface->Update(deltaTime);
+    EntitySimulationLod* simulation = &manager->simulation;
+    bool due[ENTITY_SIMULATION_AWAKE_TIERS];
+    if (simulation->enabled) BeginSimulationFrame(simulation, deltaTime, due);
+    manager->updating = true;
+    for (size_t c = 0; c < manager->chunkCount; c++) {
+        EntityChunk* chunk = manager->chunks[c];
+        EntityComponentSpan span = ChunkSpan(manager, c);
+        if (span.count == 0) break;
+        if (manager->useComponentStore) {
+            // Walk the active bitset instead of loading every Entity
+            for (size_t i = NextActiveEntityRow(&span, 0); i < span.count; i = NextActiveEntityRow(&span, i + 1)) {
+                Entity* entity = chunk->entities[i];
+                float step = deltaTime;
+                if (simulation->enabled && !TakeSimulationStep(simulation, entity, due, &step)) continue;
+                if (entity->interface != NULL && entity->interface->Update != NULL) {
+                    entity->interface->Update(step);
+                    if (simulation->enabled) simulation->stats.updated[entity->simulationTier]++;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < span.count; i++) {
+                Entity* entity = chunk->entities[i];
+                float step = deltaTime;
+                if (!entity->isActive) continue;
+                if (simulation->enabled && !TakeSimulationStep(simulation, entity, due, &step)) continue;
+                if (entity->interface != NULL && entity->interface->Update != NULL) {
+                    entity->interface->Update(step);
+                    if (simulation->enabled) simulation->stats.updated[entity->simulationTier]++;
+                }
+            }
         }
     }
+
+    // One call per behaviour covers all of its entities
+    for (size_t i = 1; i <= manager->behaviourCount; i++) {
+        EntityBehaviourInfo* info = &manager->behaviours[i];
+        if (info->behaviour.UpdateBatch == NULL || info->bucket.count == 0) continue;
+        if (simulation->enabled) {
+            UpdateBehaviourByTier(simulation, info, due);
+        } else {
+            info->behaviour.UpdateBatch(info->bucket.members, info->bucket.count, deltaTime, info->behaviour.userData);
+        }
+    }
+    manager->updating = false;
+    // Update and UpdateBatch move entities by writing position directly
+    manager->gridDirty = true;
+    FlushEntityCommands(manager, &manager->commands);
+    UpdateEntityTransforms(manager);
+    if (simulation->enabled) EndSimulationFrame(manager, due);
 }
 
-// Draw all entities
-void DrawEntities(const EntityManager* manager) {
-    if (manager == NULL) return;
-    for (size_t i = 0; i < manager->entityCount; i++) {
-        Entity* entity = manager->entities[i];
-        if (entity != NULL && entity->isActive) {
-            if (entity->sprite != NULL) {
-                DrawSpriteObject(entity->sprite);
+// Queue the sprites of all active entities into a batch
+void BatchEntitySprites(const EntityManager* manager, SpriteBatch* batch) {
+    if (manager == NULL || batch == NULL) return;
+    for (size_t c = 0; c < manager->chunkCount; c++) {
+        const EntityChunk* chunk = manager->chunks[c];
+        EntityComponentSpan span = ChunkSpan(manager, c);
+        if (span.count == 0) break;
+        if (manager->useComponentStore) {
+            for (size_t i = NextActiveEntityRow(&span, 0); i < span.count; i = NextActiveEntityRow(&span, i + 1)) {
+                AddSpriteObjectToBatch(batch, span.sprites[i]);
             }
-            if (entity->interface != NULL && entity->interface->Draw != NULL) {
-                entity->interface->Draw();
+        } else {
+            for (size_t i = 0; i < span.count; i++) {
+                Entity* entity = chunk->entities[i];
+                if (entity->isActive) {
+                    AddSpriteObjectToBatch(batch, entity->sprite);
+                }
             }
         }
     }
 }
 
+// Run custom Draw callbacks and behaviour DrawBatch
+static void DrawEntityCallbacks(const EntityManager* manager) {
+    for (size_t c = 0; c < manager->chunkCount; c++) {
+        const EntityChunk* chunk = manager->chunks[c];
+        EntityComponentSpan span = ChunkSpan(manager, c);
+        if (span.count == 0) break;
+        if (manager->useComponentStore) {
+            for (size_t i = NextActiveEntityRow(&span, 0); i < span.count; i = NextActiveEntityRow(&span, i + 1)) {
+                IEntity* interface = chunk->entities[i]->interface;
+                if (interface != NULL && interface->Draw != NULL) {
+                    interface->Draw();
+                }
+            }
+        } else {
+            for (size_t i = 0; i < span.count; i++) {
+                Entity* entity = chunk->entities[i];
+                if (entity->isActive && entity->interface != NULL && entity->interface->Draw != NULL) {
+                    entity->interface->Draw();
+                }
+            }
+        }
+    }
+
+    for (size_t i = 1; i <= manager->behaviourCount; i++) {
+        const EntityBehaviourInfo* info = &manager->behaviours[i];
+        if (info->behaviour.DrawBatch != NULL && info->bucket.count > 0) {
+            info->behaviour.DrawBatch(info->bucket.members, info->bucket.count, info->behaviour.userData);
+        }
+    }
+}
+
+// Draw all entities. Sprites go first, sorted by layer and texture in
+// one batch; custom Draw callbacks and behaviour DrawBatch run on top.
+void DrawEntities(const EntityManager* manager) {
+    if (manager == NULL) return;
+    BeginSpriteBatch(&g_spriteBatch);
+    BatchEntitySprites(manager, &g_spriteBatch);
+    EndSpriteBatch(&g_spriteBatch);
+    DrawEntityCallbacks(manager);
+}
+
+// Draw all entities, skipping sprites outside a world-space view
+// (e.g. from GetGameCameraViewRect). Callbacks are not culled.
+void DrawEntitiesInView(const EntityManager* manager, Rectangle view) {
+    if (manager == NULL) return;
+    BeginSpriteBatch(&g_spriteBatch);
+    SetSpriteBatchView(&g_spriteBatch, view);
+    BatchEntitySprites(manager, &g_spriteBatch);
+    EndSpriteBatch(&g_spriteBatch);
+    DrawEntityCallbacks(manager);
+}
+
 // Unload all entities
 void UnloadAllEntities(EntityManager* manager) {
     if (manager == NULL) return;
-    for (size_t i = 0; i < manager->entityCount; i++) {
-        if (manager->entities[i] != NULL) {
-            if (manager->entities[i]->sprite != NULL) {
-                UnloadTexture(manager->entities[i]->sprite->texture);
-                free(manager->entities[i]->sprite);
-            }
-            free(manager->entities[i]);
-            manager->entities[i] = NULL;
+    // Pending spawns are owned by the manager too
+    for (size_t i = 0; i < manager->commands.count; i++) {
+        if (manager->commands.commands[i].type == ENTITY_COMMAND_SPAWN) {
+            DestroyEntity(manager->commands.commands[i].entity);
         }
     }
+    FreeEntityCommandBuffer(&manager->commands);
+    for (size_t i = 0; i < manager->entityCount; i++) {
+        DestroyEntity(GetEntityAtRow(manager, i));
+        SetEntityAtRow(manager, i, NULL);
+    }
+    // With every entity gone the pools can restart from their first slab
+    if (g_entityPool.liveCount == 0) ResetMemoryPool(&g_entityPool);
+    if (g_spriteObjectPool.liveCount == 0) ResetMemoryPool(&g_spriteObjectPool);
+    FreeEntitySpatialGrid(&manager->grid);
+    free(manager->gridScratch);
+    manager->gridScratch = NULL;
+    manager->gridScratchCapacity = 0;
+    free(manager->pairScratch);
+    manager->pairScratch = NULL;
+    manager->pairScratchCapacity = 0;
+    manager->gridDirty = true;
+    FreeEntityTransformHierarchy(&manager->transforms);
+    // Simulation settings and regions are kept for the next level
+    free(manager->simulation.awake);
+    free(manager->simulation.batch);
+    manager->simulation.awake = NULL;
+    manager->simulation.awakeCount = 0;
+    manager->simulation.awakeCapacity = 0;
+    manager->simulation.batch = NULL;
+    manager->simulation.batchCapacity = 0;
+    free(manager->nameIndex);
+    manager->nameIndex = NULL;
+    manager->nameIndexCapacity = 0;
+    manager->nameIndexCount = 0;
+    manager->nameIndexUsed = 0;
+    // Type, behaviour and query registrations survive, their member lists do not
+    for (size_t i = 0; i < manager->typeCount; i++) {
+        FreeBucket(&manager->types[i].bucket);
+    }
+    for (size_t i = 1; i <= manager->behaviourCount; i++) {
+        FreeBucket(&manager->behaviours[i].bucket);
+    }
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        ClearQuery(&manager->queries[i]);
+    }
+    // Free every slot, bumping live generations so outstanding handles go stale.
+    // The chunks are kept for the next level; FreeEntityManager releases them.
+    manager->freeSlot = ENTITY_SLOT_NONE;
+    for (size_t i = 0; i < manager->chunkCount; i++) {
+        manager->chunks[i]->liveSlots = 0;
+    }
+    for (uint32_t i = manager->slotCount; i-- > 0;) {
+        EntitySlot* slot = GetEntitySlot(manager, i);
+        if (slot->row != ENTITY_SLOT_NONE) slot->generation++;
+        slot->row = ENTITY_SLOT_NONE;
+        slot->nextFree = manager->freeSlot;
+        manager->freeSlot = i;
+    }
     manager->entityCount = 0;
+    manager->useComponentStore = false;
     manager->state = ENTITY_MANAGER_UNINITIALIZED;
 }
 
+// Check that a handle still refers to a live entity
+bool IsEntityHandleValid(const EntityManager* manager, EntityHandle handle) {
+    if (manager == NULL || handle.index >= manager->slotCount) return false;
+    const EntitySlot* slot = GetEntitySlot(manager, handle.index);
+    return slot->generation == handle.generation && slot->row != ENTITY_SLOT_NONE;
+}
+
+// Get entity by handle, or NULL if the handle is stale
+Entity* GetEntity(const EntityManager* manager, EntityHandle handle) {
+    if (!IsEntityHandleValid(manager, handle)) return NULL;
+    return GetEntityAtRow(manager, GetEntitySlot(manager, handle.index)->row);
+}
+
 // Get entity by ID
 Entity* GetEntityByID(const EntityManager* manager, int entityId) {
     if (manager == NULL) return NULL;
     for (size_t i = 0; i < manager->entityCount; i++) {
-        if (manager->entities[i] != NULL && manager->entities[i]->id == entityId) {
-            return manager->entities[i];
+        Entity* entity = GetEntityAtRow(manager, i);
+        if (entity != NULL && entity->id == entityId) {
+            return entity;
         }
     }
     return NULL;
 }
 
+// Hash an entity name (FNV-1a). Precompute this for names looked up every frame.
+uint32_t HashEntityName(const char* name) {
+    return HashString(name);
+}
+
 // Get entity by Name
 Entity* GetEntityByName(const EntityManager* manager, const char* name) {
     if (manager == NULL || name == NULL) return NULL;
-    for (size_t i = 0; i < manager->entityCount; i++) {
-        if (manager->entities[i] != NULL && strcmp(manager->entities[i]->name, name) == 0) {
-            return manager->entities[i];
+    return GetEntityByNameHash(manager, HashEntityName(name), name);
+}
+
+// Get entity by Name with a precomputed hash
+Entity* GetEntityByNameHash(const EntityManager* manager, uint32_t nameHash, const char* name) {
+    if (manager == NULL || name == NULL || manager->nameIndex == NULL) return NULL;
+    size_t mask = manager->nameIndexCapacity - 1;
+    for (size_t i = nameHash & mask; manager->nameIndex[i].slot != NAME_INDEX_EMPTY; i = (i + 1) & mask) {
+        EntityNameEntry entry = manager->nameIndex[i];
+        if (entry.slot == NAME_INDEX_TOMBSTONE || entry.hash != nameHash) continue;
+        Entity* entity = GetEntityAtRow(manager, GetEntitySlot(manager, entry.slot)->row);
+        if (strcmp(entity->name, name) == 0) {
+            return entity;
         }
     }
     return NULL;
 }
 
-// Get entities by Type
+// Rename an entity and move it in the name index
+bool RenameEntity(EntityManager* manager, Entity* entity, const char* newName) {
+    if (entity == NULL || newName == NULL) return false;
+    bool managed = manager != NULL && GetEntity(manager, entity->handle) == entity;
+    if (managed) UnindexEntityName(manager, entity);
+    strncpy(entity->name, newName, MAX_ENTITY_NAME_LENGTH - 1);
+    entity->name[MAX_ENTITY_NAME_LENGTH - 1] = '\0';
+    entity->nameHash = HashEntityName(entity->name);
+    if (managed) IndexEntityName(manager, entity);
+    return true;
+}
+
+// Get entities by Type. The returned array is borrowed from the manager:
+// do not free it, and do not hold it across AddEntity/RemoveEntity.
 Entity** GetEntitiesByType(const EntityManager* manager, const char* type, size_t* outCount) {
     if (manager == NULL || type == NULL || outCount == NULL) return NULL;
-    Entity** matchedEntities = (Entity**)malloc(MAX_ENTITIES * sizeof(Entity*));
-    if (matchedEntities == NULL) {
-        *outCount = 0;
-        return NULL;
+    EntityView view = GetEntityViewByType(manager, FindEntityType(manager, type));
+    *outCount = view.count;
+    return (Entity**)view.items;
+}
+
+// Initialize an empty command buffer
+void InitEntityCommandBuffer(EntityCommandBuffer* buffer) {
+    if (buffer == NULL) return;
+    *buffer = (EntityCommandBuffer){0};
+}
+
+// Append a command, growing the buffer if needed
+static void PushEntityCommand(EntityCommandBuffer* buffer, EntityCommand command) {
+    if (buffer == NULL) return;
+    if (buffer->count == buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 64;
+        EntityCommand* commands = (EntityCommand*)realloc(buffer->commands, capacity * sizeof(EntityCommand));
+        if (commands == NULL) {
+            printf("Error: Memory allocation for entity command buffer failed.\n");
+            return;
+        }
+        buffer->commands = commands;
+        buffer->capacity = capacity;
+    }
+    buffer->commands[buffer->count++] = command;
+}
+
+// Record commands
+void RecordSpawnEntity(EntityCommandBuffer* buffer, Entity* entity) {
+    if (entity == NULL) return;
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_SPAWN, .entity = entity });
+}
+
+void RecordDespawnEntity(EntityCommandBuffer* buffer, EntityHandle handle) {
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_DESPAWN, .handle = handle });
+}
+
+void RecordSetEntityPosition(EntityCommandBuffer* buffer, EntityHandle handle, Vector2 position) {
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_SET_POSITION, .handle = handle, .value.position = position });
+}
+
+void RecordSetEntityActive(EntityCommandBuffer* buffer, EntityHandle handle, bool active) {
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_SET_ACTIVE, .handle = handle, .value.active = active });
+}
+
+void RecordSetEntityBehaviour(EntityCommandBuffer* buffer, EntityHandle handle, EntityBehaviourId behaviourId) {
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_SET_BEHAVIOUR, .handle = handle, .value.behaviourId = behaviourId });
+}
+
+// Components are recorded as bits to add and remove rather than a whole
+// signature, so several changes in one frame compose
+void RecordChangeEntityComponents(EntityCommandBuffer* buffer, EntityHandle handle, EntitySignature add, EntitySignature remove) {
+    PushEntityCommand(buffer, (EntityCommand){ .type = ENTITY_COMMAND_CHANGE_COMPONENTS, .handle = handle,
+                                               .value.components = { add, remove } });
+}
+
+// Drop recorded commands but keep the storage
+void ClearEntityCommandBuffer(EntityCommandBuffer* buffer) {
+    if (buffer == NULL) return;
+    buffer->count = 0;
+}
+
+// Release the buffer's storage
+void FreeEntityCommandBuffer(EntityCommandBuffer* buffer) {
+    if (buffer == NULL) return;
+    free(buffer->commands);
+    *buffer = (EntityCommandBuffer){0};
+}
+
+// Apply and clear a command buffer. Despawns go first: a handful are
+// swap-removed, larger batches are coalesced into one compaction pass.
+// Spawns and component changes follow in recorded order.
+void FlushEntityCommands(EntityManager* manager, EntityCommandBuffer* buffer) {
+    if (manager == NULL || buffer == NULL || buffer->count == 0) return;
+    if (manager->updating) {
+        printf("Warning: Entity commands cannot be flushed while entities are updating.\n");
+        return;
+    }
+
+    size_t despawns = 0;
+    for (size_t i = 0; i < buffer->count; i++) {
+        if (buffer->commands[i].type == ENTITY_COMMAND_DESPAWN) despawns++;
+    }
+    if (despawns > 0) {
+        bool compact = despawns * 8 >= manager->entityCount;
+        for (size_t i = 0; i < buffer->count; i++) {
+            const EntityCommand* command = &buffer->commands[i];
+            if (command->type != ENTITY_COMMAND_DESPAWN || !IsEntityHandleValid(manager, command->handle)) continue;
+            size_t row = GetEntitySlot(manager, command->handle.index)->row;
+            if (compact) DetachEntityRow(manager, row);
+            else ReleaseEntityRow(manager, row);
+        }
+        if (compact) CompactEntityRows(manager);
+    }
+
+    for (size_t i = 0; i < buffer->count; i++) {
+        const EntityCommand* command = &buffer->commands[i];
+        switch (command->type) {
+            case ENTITY_COMMAND_SPAWN:
+                if (!IsEntityHandleValid(manager, AddEntity(manager, command->entity))) {
+                    DestroyEntity(command->entity);
+                }
+                break;
+            case ENTITY_COMMAND_SET_POSITION:
+                SetEntityPosition(manager, GetEntity(manager, command->handle), command->value.position);
+                break;
+            case ENTITY_COMMAND_SET_ACTIVE:
+                SetEntityActive(manager, GetEntity(manager, command->handle), command->value.active);
+                break;
+            case ENTITY_COMMAND_SET_BEHAVIOUR:
+                SetEntityBehaviour(manager, GetEntity(manager, command->handle), command->value.behaviourId);
+                break;
+            case ENTITY_COMMAND_CHANGE_COMPONENTS: {
+                Entity* entity = GetEntity(manager, command->handle);
+                if (entity != NULL) {
+                    ChangeEntitySignature(manager, entity, (entity->signature & ~command->value.components.remove) |
+                                                           command->value.components.add);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    ClearEntityCommandBuffer(buffer);
+}
+
+// Intern an entity type name, returning its ID (existing or new)
+EntityTypeId RegisterEntityType(EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_TYPE_NONE;
+    EntityTypeId existing = FindEntityType(manager, name);
+    if (existing != ENTITY_TYPE_NONE) return existing;
+    // A cut-off name would never be found again
+    if (strlen(name) >= MAX_ENTITY_TYPE_NAME_LENGTH) {
+        printf("Error: Entity type name %s is too long.\n", name);
+        return ENTITY_TYPE_NONE;
+    }
+    if (manager->typeCount >= MAX_ENTITY_TYPES) {
+        printf("Error: Maximum entity type limit reached.\n");
+        return ENTITY_TYPE_NONE;
+    }
+    EntityTypeInfo* type = &manager->types[manager->typeCount];
+    strcpy(type->name, name);
+    type->bucket = (EntityBucket){0};
+    return (EntityTypeId)manager->typeCount++;
+}
+
+// Look up a registered entity type by name
+EntityTypeId FindEntityType(const EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_TYPE_NONE;
+    for (size_t i = 0; i < manager->typeCount; i++) {
+        // Interned names can be matched by pointer first
+        if (manager->types[i].name == name || strcmp(manager->types[i].name, name) == 0) {
+            return (EntityTypeId)i;
+        }
+    }
+    return ENTITY_TYPE_NONE;
+}
+
+// Borrow the member list of an entity type. O(1), no allocation.
+EntityView GetEntityViewByType(const EntityManager* manager, EntityTypeId typeId) {
+    if (manager == NULL || typeId >= manager->typeCount) return (EntityView){ NULL, 0 };
+    const EntityBucket* bucket = &manager->types[typeId].bucket;
+    return (EntityView){ bucket->members, bucket->count };
+}
+
+// Call back once per entity of a type. The callback must not add or remove entities.
+void ForEachEntityOfType(const EntityManager* manager, EntityTypeId typeId, void (*callback)(Entity* entity, void* userData), void* userData) {
+    if (callback == NULL) return;
+    EntityView view = GetEntityViewByType(manager, typeId);
+    for (size_t i = 0; i < view.count; i++) {
+        callback(view.items[i], userData);
+    }
+}
+
+// Register a behaviour. The struct is copied; the name must outlive the manager.
+EntityBehaviourId RegisterEntityBehaviour(EntityManager* manager, const EntityBehaviour* behaviour) {
+    if (manager == NULL || behaviour == NULL) return ENTITY_BEHAVIOUR_NONE;
+    if (manager->behaviourCount >= MAX_ENTITY_BEHAVIOURS) {
+        printf("Error: Maximum entity behaviour limit reached.\n");
+        return ENTITY_BEHAVIOUR_NONE;
+    }
+    EntityBehaviourInfo* info = &manager->behaviours[++manager->behaviourCount];
+    info->behaviour = *behaviour;
+    info->bucket = (EntityBucket){0};
+    return (EntityBehaviourId)manager->behaviourCount;
+}
+
+// Look up a registered behaviour by name
+EntityBehaviourId FindEntityBehaviour(const EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_BEHAVIOUR_NONE;
+    for (size_t i = 1; i <= manager->behaviourCount; i++) {
+        const char* behaviourName = manager->behaviours[i].behaviour.name;
+        if (behaviourName != NULL && strcmp(behaviourName, name) == 0) {
+            return (EntityBehaviourId)i;
+        }
+    }
+    return ENTITY_BEHAVIOUR_NONE;
+}
+
+// Move an entity to another behaviour (or none). Deferred while updating.
+void SetEntityBehaviour(EntityManager* manager, Entity* entity, EntityBehaviourId behaviourId) {
+    if (entity == NULL) return;
+    if (manager == NULL || GetEntity(manager, entity->handle) != entity) {
+        // Not managed yet: AddEntity will pick it up
+        entity->behaviourId = behaviourId;
+        return;
+    }
+    if (entity->behaviourId == behaviourId) return;
+    if (manager->updating) {
+        RecordSetEntityBehaviour(&manager->commands, entity->handle, behaviourId);
+        return;
+    }
+    LeaveBehaviour(manager, entity);
+    JoinBehaviour(manager, entity, behaviourId);
+}
+
+// Borrow the member list of a behaviour
+EntityView GetEntityViewByBehaviour(const EntityManager* manager, EntityBehaviourId behaviourId) {
+    if (manager == NULL || behaviourId == ENTITY_BEHAVIOUR_NONE || behaviourId > manager->behaviourCount) {
+        return (EntityView){ NULL, 0 };
+    }
+    const EntityBucket* bucket = &manager->behaviours[behaviourId].bucket;
+    return (EntityView){ bucket->members, bucket->count };
+}
+
+// Intern a component type name, returning its signature bit (existing or new)
+EntityComponentId RegisterEntityComponent(EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_COMPONENT_NONE;
+    EntityComponentId existing = FindEntityComponent(manager, name);
+    if (existing != ENTITY_COMPONENT_NONE) return existing;
+    if (strlen(name) >= MAX_ENTITY_TYPE_NAME_LENGTH) {
+        printf("Error: Entity component name %s is too long.\n", name);
+        return ENTITY_COMPONENT_NONE;
+    }
+    if (manager->componentTypeCount >= MAX_ENTITY_COMPONENT_TYPES) {
+        printf("Error: Maximum entity component type limit reached.\n");
+        return ENTITY_COMPONENT_NONE;
+    }
+    strcpy(manager->componentTypes[manager->componentTypeCount], name);
+    return (EntityComponentId)manager->componentTypeCount++;
+}
+
+// Look up a registered component type by name
+EntityComponentId FindEntityComponent(const EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_COMPONENT_NONE;
+    for (size_t i = 0; i < manager->componentTypeCount; i++) {
+        if (strcmp(manager->componentTypes[i], name) == 0) {
+            return (EntityComponentId)i;
+        }
+    }
+    return ENTITY_COMPONENT_NONE;
+}
+
+// Add and remove component bits. Deferred while updating.
+static void ChangeEntityComponents(EntityManager* manager, Entity* entity, EntitySignature add, EntitySignature remove) {
+    if (entity == NULL) return;
+    if (manager == NULL || GetEntity(manager, entity->handle) != entity) {
+        // Not managed yet: AddEntity will pick it up
+        entity->signature = (entity->signature & ~remove) | add;
+        return;
+    }
+    if (manager->updating) {
+        RecordChangeEntityComponents(&manager->commands, entity->handle, add, remove);
+        return;
+    }
+    ChangeEntitySignature(manager, entity, (entity->signature & ~remove) | add);
+}
+
+void SetEntitySignature(EntityManager* manager, Entity* entity, EntitySignature signature) {
+    ChangeEntityComponents(manager, entity, signature, ~(EntitySignature)0);
+}
+
+void AddEntityComponents(EntityManager* manager, Entity* entity, EntitySignature components) {
+    ChangeEntityComponents(manager, entity, components, 0);
+}
+
+void RemoveEntityComponents(EntityManager* manager, Entity* entity, EntitySignature components) {
+    ChangeEntityComponents(manager, entity, 0, components);
+}
+
+// Register a query, returning the existing one for the same signature.
+// The matching set is built with one scan here and kept up to date
+// incrementally afterwards.
+EntityQueryId RegisterEntityQuery(EntityManager* manager, EntitySignature required, EntitySignature excluded) {
+    if (manager == NULL) return ENTITY_QUERY_NONE;
+    for (size_t i = 0; i < manager->queryCount; i++) {
+        if (manager->queries[i].required == required && manager->queries[i].excluded == excluded) {
+            return (EntityQueryId)i;
+        }
+    }
+    if (manager->queryCount >= MAX_ENTITY_QUERIES) {
+        printf("Error: Maximum entity query limit reached.\n");
+        return ENTITY_QUERY_NONE;
+    }
+    if ((required & excluded) != 0) {
+        printf("Warning: Entity query requires and excludes the same component, it will never match.\n");
+    }
+    EntityQuery* query = &manager->queries[manager->queryCount];
+    *query = (EntityQuery){ .required = required, .excluded = excluded };
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        Entity* entity = GetEntityAtRow(manager, row);
+        if (QueryMatches(query, entity->signature)) {
+            AddQueryMember(query, entity, (uint32_t)row);
+        }
+    }
+    return (EntityQueryId)manager->queryCount++;
+}
+
+// Borrow the matching entities of a query. O(1), no allocation.
+EntityView GetEntityQueryView(const EntityManager* manager, EntityQueryId queryId) {
+    if (manager == NULL || queryId >= manager->queryCount) return (EntityView){ NULL, 0 };
+    const EntityQuery* query = &manager->queries[queryId];
+    return (EntityView){ query->members, query->count };
+}
+
+// Borrow the dense rows of a query's matches, in the same order as its
+// view. Valid until the next add, remove or signature change.
+const uint32_t* GetEntityQueryRows(const EntityManager* manager, EntityQueryId queryId, size_t* outCount) {
+    if (outCount != NULL) *outCount = 0;
+    if (manager == NULL || queryId >= manager->queryCount) return NULL;
+    const EntityQuery* query = &manager->queries[queryId];
+    if (outCount != NULL) *outCount = query->count;
+    return query->rows;
+}
+
+// Register a prefab. The template is copied; its type is interned, its
+// behaviour checked and its shared texture retained.
+EntityPrefabId RegisterEntityPrefab(EntityManager* manager, const char* name, const EntityPrefab* prefab) {
+    if (manager == NULL || name == NULL || prefab == NULL) return ENTITY_PREFAB_NONE;
+    if (manager->prefabCount >= MAX_ENTITY_PREFABS) {
+        printf("Error: Maximum entity prefab limit reached.\n");
+        return ENTITY_PREFAB_NONE;
+    }
+    if (FindEntityPrefab(manager, name) != ENTITY_PREFAB_NONE) {
+        printf("Error: Entity prefab %s is already registered.\n", name);
+        return ENTITY_PREFAB_NONE;
+    }
+    if (prefab->hasSprite && !prefab->sprite.sharedTexture && prefab->sprite.texture.id != 0) {
+        printf("Error: Prefab %s sprite must use a shared texture.\n", name);
+        return ENTITY_PREFAB_NONE;
+    }
+
+    EntityPrefabInfo* info = &manager->prefabs[manager->prefabCount];
+    strncpy(info->name, name, MAX_ENTITY_PREFAB_NAME_LENGTH - 1);
+    info->name[MAX_ENTITY_PREFAB_NAME_LENGTH - 1] = '\0';
+    info->prefab = *prefab;
+
+    // Resolve everything AddEntity would otherwise redo per instance
+    Entity* entity = &info->prefab.entity;
+    entity->sprite = NULL;
+    entity->transformNode = ENTITY_TRANSFORM_NONE;
+    entity->handle = (EntityHandle){0};
+    entity->typeRow = 0;
+    entity->behaviourRow = 0;
+    entity->typeId = entity->entityType != NULL ? RegisterEntityType(manager, entity->entityType) : ENTITY_TYPE_NONE;
+    entity->entityType = entity->typeId != ENTITY_TYPE_NONE ? manager->types[entity->typeId].name : NULL;
+    entity->nameHash = HashEntityName(entity->name);
+    if (entity->behaviourId > manager->behaviourCount) {
+        printf("Warning: Prefab %s has an unknown behaviour, instances will have none.\n", name);
+        entity->behaviourId = ENTITY_BEHAVIOUR_NONE;
+    }
+
+    SpriteObject* sprite = &info->prefab.sprite;
+    if (!info->prefab.hasSprite) {
+        *sprite = (SpriteObject){ .textureHandle = ASSET_TEXTURE_NONE };
+    } else if (sprite->sharedTexture) {
+        RetainAssetTexture(sprite->textureHandle);
+    } else {
+        sprite->textureHandle = ASSET_TEXTURE_NONE;
+    }
+    return (EntityPrefabId)manager->prefabCount++;
+}
+
+// Look up a registered prefab by name
+EntityPrefabId FindEntityPrefab(const EntityManager* manager, const char* name) {
+    if (manager == NULL || name == NULL) return ENTITY_PREFAB_NONE;
+    for (size_t i = 0; i < manager->prefabCount; i++) {
+        if (strcmp(manager->prefabs[i].name, name) == 0) {
+            return (EntityPrefabId)i;
+        }
+    }
+    return ENTITY_PREFAB_NONE;
+}
+
+// Borrow a registered prefab's template
+const EntityPrefab* GetEntityPrefab(const EntityManager* manager, EntityPrefabId prefabId) {
+    if (manager == NULL || prefabId >= manager->prefabCount) return NULL;
+    return &manager->prefabs[prefabId].prefab;
+}
+
+// Copy a prefab into a new pooled entity (and sprite) at a position
+static Entity* ClonePrefab(const EntityPrefab* prefab, Vector2 position) {
+    Entity* entity = CreateEntity();
+    if (entity == NULL) return NULL;
+    *entity = prefab->entity;
+    entity->position = position;
+    if (prefab->hasSprite) {
+        SpriteObject* sprite = CreateSpriteObject();
+        if (sprite == NULL) {
+            DestroyEntity(entity);
+            return NULL;
+        }
+        *sprite = prefab->sprite;
+        sprite->position.x += position.x;
+        sprite->position.y += position.y;
+        if (sprite->sharedTexture) RetainAssetTexture(sprite->textureHandle);
+        entity->sprite = sprite;
+    }
+    return entity;
+}
+
+// Create count instances of a prefab. positions may be NULL to use the
+// template position for all of them; outHandles may be NULL. Every
+// allocation (chunks, pools, member lists, queries, name index) is made up front,
+// so the per-instance work is a copy and a few index updates.
+// While entities are updating the spawns are deferred and the handles are
+// zero. Returns the number of instances created.
+size_t InstantiatePrefab(EntityManager* manager, EntityPrefabId prefabId, size_t count, const Vector2* positions, EntityHandle* outHandles) {
+    const EntityPrefab* prefab = GetEntityPrefab(manager, prefabId);
+    if (prefab == NULL || count == 0) return 0;
+    if (manager->maxEntities > 0 && manager->entityCount + count > manager->maxEntities) {
+        printf("Warning: Maximum entity limit reached, instantiating %zu of %zu.\n",
+               manager->maxEntities - manager->entityCount, count);
+        count = manager->maxEntities - manager->entityCount;
+    }
+
+    // Reserve everything the instances will need in one pass
+    const Entity* entityTemplate = &prefab->entity;
+    bool reserved = ReserveEntities(manager, manager->entityCount + count) &&
+                    EnsureEntityPool() &&
+                    ReserveMemoryPool(&g_entityPool, g_entityPool.liveCount + count) &&
+                    (!prefab->hasSprite || ReserveSpriteObjects(count));
+    if (reserved && !manager->updating) {
+        if (entityTemplate->typeId != ENTITY_TYPE_NONE) {
+            EntityBucket* bucket = &manager->types[entityTemplate->typeId].bucket;
+            reserved = ReserveBucket(bucket, bucket->count + count);
+        }
+        if (reserved && entityTemplate->behaviourId != ENTITY_BEHAVIOUR_NONE) {
+            EntityBucket* bucket = &manager->behaviours[entityTemplate->behaviourId].bucket;
+            reserved = ReserveBucket(bucket, bucket->count + count);
+        }
+        if (reserved && entityTemplate->name[0] != '\0') {
+            reserved = ReserveNameIndex(manager, count);
+        }
+        for (size_t i = 0; reserved && i < manager->queryCount; i++) {
+            EntityQuery* query = &manager->queries[i];
+            if (QueryMatches(query, entityTemplate->signature)) {
+                reserved = ReserveQueryPositions(query, GetEntityCapacity(manager)) &&
+                           ReserveQueryMembers(query, query->count + count);
+            }
+        }
     }
-    size_t count = 0;
+    if (!reserved) {
+        printf("Error: Could not reserve room for %zu prefab instances.\n", count);
+        return 0;
+    }
+
+    size_t created = 0;
+    for (; created < count; created++) {
+        Entity* entity = ClonePrefab(prefab, positions != NULL ? positions[created] : entityTemplate->position);
+        if (entity == NULL) break;
+        EntityHandle handle = {0};
+        if (manager->updating) {
+            RecordSpawnEntity(&manager->commands, entity);
+        } else {
+            handle = InsertEntity(manager, entity);
+            if (handle.generation == 0) {
+                DestroyEntity(entity);
+                break;
+            }
+        }
+        if (outHandles != NULL) outHandles[created] = handle;
+    }
+    return created;
+}
+
+// World-space bounds of an entity's hitbox
+Rectangle GetEntityBounds(const Entity* entity) {
+    if (entity == NULL) return (Rectangle){0};
+    if (entity->hitbox.w > 0 && entity->hitbox.h > 0) {
+        return (Rectangle){ entity->position.x + entity->hitbox.x, entity->position.y + entity->hitbox.y,
+                            (float)entity->hitbox.w, (float)entity->hitbox.h };
+    }
+    return (Rectangle){ entity->position.x, entity->position.y, entity->width, entity->height };
+}
+
+// Bounds of a row, read from the columns when the component store is on.
+// Inactive rows get a negative width so the grid skips them.
+static Rectangle GetRowBounds(const EntityManager* manager, size_t row) {
+    EntityChunk* chunk = GetEntityChunk(manager, row);
+    size_t local = row & ENTITY_CHUNK_MASK;
+    if (!manager->useComponentStore) {
+        const Entity* entity = chunk->entities[local];
+        return entity->isActive ? GetEntityBounds(entity) : (Rectangle){ 0, 0, -1.0f, -1.0f };
+    }
+    EntityComponentSpan span = ChunkSpan(manager, row >> ENTITY_CHUNK_SHIFT);
+    if (!IsEntityRowActive(&span, local)) return (Rectangle){ 0, 0, -1.0f, -1.0f };
+    Vector2 position = span.positions[local];
+    Hitbox_t hitbox = span.hitboxes[local];
+    if (hitbox.w > 0 && hitbox.h > 0) {
+        return (Rectangle){ position.x + hitbox.x, position.y + hitbox.y, (float)hitbox.w, (float)hitbox.h };
+    }
+    return (Rectangle){ position.x, position.y, span.sizes[local].x, span.sizes[local].y };
+}
+
+// Make the scratch row buffer hold at least count rows
+static bool ReserveGridScratch(EntityManager* manager, size_t count) {
+    if (count <= manager->gridScratchCapacity) return true;
+    size_t capacity = manager->gridScratchCapacity ? manager->gridScratchCapacity : 256;
+    while (capacity < count) capacity *= 2;
+    uint32_t* scratch = (uint32_t*)realloc(manager->gridScratch, capacity * sizeof(uint32_t));
+    if (scratch == NULL) {
+        printf("Error: Memory allocation for entity query failed.\n");
+        return false;
+    }
+    manager->gridScratch = scratch;
+    manager->gridScratchCapacity = capacity;
+    return true;
+}
+
+// Make the scratch row pair buffer hold at least count pairs
+static bool ReservePairScratch(EntityManager* manager, size_t count) {
+    if (count <= manager->pairScratchCapacity) return true;
+    size_t capacity = manager->pairScratchCapacity ? manager->pairScratchCapacity : 256;
+    while (capacity < count) capacity *= 2;
+    EntityGridPair* scratch = (EntityGridPair*)realloc(manager->pairScratch, capacity * sizeof(EntityGridPair));
+    if (scratch == NULL) {
+        printf("Error: Memory allocation for entity collision pairs failed.\n");
+        return false;
+    }
+    manager->pairScratch = scratch;
+    manager->pairScratchCapacity = capacity;
+    return true;
+}
+
+// Set the grid cell size. Roughly the size of a typical hitbox works best.
+void SetEntityGridCellSize(EntityManager* manager, float cellSize) {
+    if (manager == NULL || cellSize <= 0.0f) return;
+    manager->grid.cellSize = cellSize;
+    manager->grid.inverseCellSize = 1.0f / cellSize;
+    manager->gridDirty = true;
+}
+
+// Rebuild the grid from current hitboxes. Queries rebuild on their own
+// after UpdateEntities, SetEntityPosition and adding or removing entities;
+// call this after moving entities by their position field outside an update.
+void RebuildEntitySpatialGrid(EntityManager* manager) {
+    if (manager == NULL) return;
+    if (!ReserveEntitySpatialGrid(&manager->grid, manager->entityCount)) return;
     for (size_t i = 0; i < manager->entityCount; i++) {
-        if (manager->entities[i] != NULL && strcmp(manager->entities[i]->entityType, type) == 0) {
-            matchedEntities[count++] = manager->entities[i];
+        manager->grid.bounds[i] = GetRowBounds(manager, i);
+    }
+    BuildEntitySpatialGrid(&manager->grid, manager->entityCount);
+    manager->gridDirty = false;
+}
+
+// Rebuild the grid if anything moved since the last rebuild
+static void RefreshEntitySpatialGrid(EntityManager* manager) {
+    if (manager->gridDirty) RebuildEntitySpatialGrid(manager);
+}
+
+// Run a grid query into the scratch buffer, growing it to fit every match
+static size_t QueryGridRows(EntityManager* manager, Rectangle area) {
+    RefreshEntitySpatialGrid(manager);
+    size_t found = QueryEntitySpatialGrid(&manager->grid, area, manager->gridScratch, manager->gridScratchCapacity);
+    if (found > manager->gridScratchCapacity) {
+        if (!ReserveGridScratch(manager, found)) return 0;
+        found = QueryEntitySpatialGrid(&manager->grid, area, manager->gridScratch, manager->gridScratchCapacity);
+    }
+    return found;
+}
+
+// Collect active entities whose bounds overlap an area. Returns the number
+// of matches; at most maxEntities are written.
+size_t QueryEntitiesInRect(EntityManager* manager, Rectangle area, Entity** outEntities, size_t maxEntities) {
+    if (manager == NULL) return 0;
+    size_t found = QueryGridRows(manager, area);
+    for (size_t i = 0; i < found && i < maxEntities; i++) {
+        outEntities[i] = GetEntityAtRow(manager, manager->gridScratch[i]);
+    }
+    return found;
+}
+
+// Collect active entities whose bounds touch a circle
+size_t QueryEntitiesInRadius(EntityManager* manager, Vector2 center, float radius, Entity** outEntities, size_t maxEntities) {
+    if (manager == NULL || radius < 0.0f) return 0;
+    Rectangle area = { center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f };
+    size_t candidates = QueryGridRows(manager, area);
+    size_t found = 0;
+    float radiusSquared = radius * radius;
+    for (size_t i = 0; i < candidates; i++) {
+        uint32_t row = manager->gridScratch[i];
+        Rectangle bounds = manager->grid.bounds[row];
+        // Distance from the centre to the closest point of the box
+        float dx = center.x - fmaxf(bounds.x, fminf(center.x, bounds.x + bounds.width));
+        float dy = center.y - fmaxf(bounds.y, fminf(center.y, bounds.y + bounds.height));
+        if (dx * dx + dy * dy <= radiusSquared) {
+            if (found < maxEntities) outEntities[found] = GetEntityAtRow(manager, row);
+            found++;
         }
     }
-    *outCount = count;
-    return matchedEntities;
-}
\ No newline at end of file
+    return found;
+}
+
+// Broadphase: every pair of active entities whose bounds overlap, each
+// reported once. Returns the number of pairs; at most maxPairs are written.
+size_t FindEntityCollisionPairs(EntityManager* manager, EntityPair* outPairs, size_t maxPairs) {
+    if (manager == NULL) return 0;
+    RefreshEntitySpatialGrid(manager);
+    // Row pairs go through the scratch buffer, grown to fit every pair
+    size_t found = FindEntitySpatialGridPairs(&manager->grid, manager->pairScratch, manager->pairScratchCapacity);
+    if (found > manager->pairScratchCapacity) {
+        if (!ReservePairScratch(manager, found)) return 0;
+        found = FindEntitySpatialGridPairs(&manager->grid, manager->pairScratch, manager->pairScratchCapacity);
+    }
+    for (size_t i = 0; i < found && i < maxPairs; i++) {
+        EntityGridPair pair = manager->pairScratch[i];
+        outPairs[i] = (EntityPair){ GetEntityAtRow(manager, pair.a), GetEntityAtRow(manager, pair.b) };
+    }
+    return found;
+}
+
+// Whether an entity is held by this manager
+static bool IsEntityManaged(const EntityManager* manager, const Entity* entity) {
+    return manager != NULL && entity != NULL && GetEntity(manager, entity->handle) == entity;
+}
+
+// Give a managed entity a node in the transform hierarchy, as a root.
+// An entity that already has one just takes the new local transform.
+bool AttachEntityTransform(EntityManager* manager, Entity* entity, EntityTransform local) {
+    if (!IsEntityManaged(manager, entity)) {
+        printf("Warning: Only managed entities can have a transform.\n");
+        return false;
+    }
+    if (entity->transformNode != ENTITY_TRANSFORM_NONE) {
+        SetEntityTransformLocal(&manager->transforms, entity->transformNode, local);
+        return true;
+    }
+    entity->transformNode = AddEntityTransformNode(&manager->transforms, entity->handle.index, local);
+    return entity->transformNode != ENTITY_TRANSFORM_NONE;
+}
+
+// Drop an entity's transform. Its children become roots where they are.
+void DetachEntityTransform(EntityManager* manager, Entity* entity) {
+    if (!IsEntityManaged(manager, entity)) return;
+    RemoveEntityTransformNode(&manager->transforms, entity->transformNode);
+    entity->transformNode = ENTITY_TRANSFORM_NONE;
+}
+
+// Parent one entity's transform to another's (NULL makes it a root).
+// Changing parents rebuilds the hierarchy order on the next update.
+bool SetEntityParent(EntityManager* manager, Entity* child, Entity* parent) {
+    if (!IsEntityManaged(manager, child) || child->transformNode == ENTITY_TRANSFORM_NONE) return false;
+    uint32_t parentNode = ENTITY_TRANSFORM_NONE;
+    if (parent != NULL) {
+        if (!IsEntityManaged(manager, parent) || parent->transformNode == ENTITY_TRANSFORM_NONE) return false;
+        parentNode = parent->transformNode;
+    }
+    return SetEntityTransformParent(&manager->transforms, child->transformNode, parentNode);
+}
+
+void SetEntityLocalTransform(EntityManager* manager, Entity* entity, EntityTransform local) {
+    if (!IsEntityManaged(manager, entity)) return;
+    SetEntityTransformLocal(&manager->transforms, entity->transformNode, local);
+}
+
+EntityTransform GetEntityLocalTransform(const EntityManager* manager, const Entity* entity) {
+    if (!IsEntityManaged(manager, entity) || entity->transformNode == ENTITY_TRANSFORM_NONE) {
+        return ENTITY_TRANSFORM_IDENTITY;
+    }
+    return manager->transforms.nodes[entity->transformNode].local;
+}
+
+// World transform as of the last UpdateEntityTransforms
+EntityTransform GetEntityWorldTransform(const EntityManager* manager, const Entity* entity) {
+    if (!IsEntityManaged(manager, entity) || entity->transformNode == ENTITY_TRANSFORM_NONE) {
+        return ENTITY_TRANSFORM_IDENTITY;
+    }
+    return manager->transforms.nodes[entity->transformNode].world;
+}
+
+// Recompute the world transforms that changed and write them into the
+// entities and their sprites. Called at the end of UpdateEntities.
+void UpdateEntityTransforms(EntityManager* manager) {
+    if (manager == NULL) return;
+    EntityTransformHierarchy* transforms = &manager->transforms;
+    size_t changed = UpdateEntityTransformHierarchy(transforms);
+    for (size_t i = 0; i < changed; i++) {
+        const EntityTransformNode* node = &transforms->nodes[transforms->changed[i]];
+        Entity* entity = GetEntityAtRow(manager, GetEntitySlot(manager, node->owner)->row);
+        SetEntityPosition(manager, entity, node->world.position);
+        if (entity->sprite != NULL) {
+            entity->sprite->position = node->world.position;
+            entity->sprite->rotation = node->world.rotation;
+            entity->sprite->scale = node->world.scale;
+        }
+    }
+}
+
+// Round up to a power of two (at least 1)
+static uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result < (1u << 31)) result <<= 1;
+    return result;
+}
+
+// Turn on distance-based update rates. settings may be NULL for the
+// defaults. Every entity restarts at full rate until the first refresh.
+void EnableEntitySimulationLod(EntityManager* manager, const EntitySimulationSettings* settings) {
+    if (manager == NULL) return;
+    DisableEntitySimulationLod(manager);
+    EntitySimulationLod* simulation = &manager->simulation;
+    simulation->settings = settings != NULL ? *settings : ENTITY_SIMULATION_DEFAULT_SETTINGS;
+
+    // Outer tiers never run more often or reach less far than inner ones
+    uint32_t interval = 1;
+    float radius = 0.0f;
+    for (size_t tier = 0; tier < ENTITY_SIMULATION_AWAKE_TIERS; tier++) {
+        uint32_t tierInterval = RoundUpToPowerOfTwo(simulation->settings.interval[tier]);
+        if (tierInterval > interval) interval = tierInterval;
+        radius = fmaxf(radius, simulation->settings.radius[tier]);
+        simulation->settings.interval[tier] = interval;
+        simulation->settings.radius[tier] = radius;
+    }
+
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        Entity* entity = GetEntityAtRow(manager, row);
+        entity->simulationTier = ENTITY_SIMULATION_FULL;
+        PushAwakeEntity(simulation, entity->handle);
+    }
+    simulation->enabled = true;
+}
+
+// Turn off simulation LOD; every entity goes back to updating each frame
+void DisableEntitySimulationLod(EntityManager* manager) {
+    if (manager == NULL) return;
+    EntitySimulationLod* simulation = &manager->simulation;
+    free(simulation->awake);
+    free(simulation->batch);
+    simulation->awake = NULL;
+    simulation->awakeCount = 0;
+    simulation->awakeCapacity = 0;
+    simulation->batch = NULL;
+    simulation->batchCapacity = 0;
+    simulation->frame = 0;
+    simulation->refreshTime = 0.0f;
+    memset(simulation->tierTime, 0, sizeof(simulation->tierTime));
+    memset(&simulation->stats, 0, sizeof(simulation->stats));
+    simulation->enabled = false;
+}
+
+// Set the points entities are simulated around, usually the camera and
+// the players. Takes effect at the next refresh.
+void SetEntitySimulationRegions(EntityManager* manager, const Vector2* centers, size_t count) {
+    if (manager == NULL || (centers == NULL && count > 0)) return;
+    if (count > MAX_SIMULATION_REGIONS) {
+        printf("Warning: Only %d simulation regions are supported.\n", MAX_SIMULATION_REGIONS);
+        count = MAX_SIMULATION_REGIONS;
+    }
+    for (size_t i = 0; i < count; i++) {
+        manager->simulation.regions[i] = centers[i];
+    }
+    manager->simulation.regionCount = count;
+}
+
+// Reassign simulation tiers. Everything awake is put to sleep unless its
+// wake time holds it up, then grid queries around each region lift the
+// entities they find to the tier for their distance. The tier pass visits
+// only entities near a region or awake before, but UpdateEntities marks
+// the spatial grid dirty every frame and the first grid query rebuilds
+// all of it, so a refresh after an update costs O(entities) regardless.
+// UpdateEntities calls this once every tier has run; calling it in
+// between drops the time accumulated by entities moved out of a reduced
+// tier.
+void RefreshEntitySimulationTiers(EntityManager* manager) {
+    if (manager == NULL || !manager->simulation.enabled) return;
+    EntitySimulationLod* simulation = &manager->simulation;
+    float elapsed = simulation->refreshTime;
+    simulation->refreshTime = 0.0f;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < simulation->awakeCount; i++) {
+        Entity* entity = GetEntity(manager, simulation->awake[i]);
+        if (entity == NULL) continue;
+        entity->wakeTime -= elapsed;
+        if (entity->wakeTime > 0.0f) {
+            entity->simulationTier = ENTITY_SIMULATION_FULL;
+            simulation->awake[kept++] = entity->handle;
+        } else {
+            entity->wakeTime = 0.0f;
+            entity->simulationTier = ENTITY_SIMULATION_SLEEPING;
+        }
+    }
+    simulation->awakeCount = kept;
+
+    float outerRadius = simulation->settings.radius[ENTITY_SIMULATION_AWAKE_TIERS - 1];
+    for (size_t r = 0; r < simulation->regionCount; r++) {
+        Vector2 center = simulation->regions[r];
+        Rectangle area = { center.x - outerRadius, center.y - outerRadius, outerRadius * 2.0f, outerRadius * 2.0f };
+        size_t found = QueryGridRows(manager, area);
+        for (size_t i = 0; i < found; i++) {
+            uint32_t row = manager->gridScratch[i];
+            Rectangle bounds = manager->grid.bounds[row];
+            float dx = fmaxf(fmaxf(bounds.x - center.x, center.x - (bounds.x + bounds.width)), 0.0f);
+            float dy = fmaxf(fmaxf(bounds.y - center.y, center.y - (bounds.y + bounds.height)), 0.0f);
+            float distanceSquared = dx * dx + dy * dy;
+            uint8_t tier = 0;
+            while (tier < ENTITY_SIMULATION_AWAKE_TIERS &&
+                   distanceSquared > simulation->settings.radius[tier] * simulation->settings.radius[tier]) {
+                tier++;
+            }
+            Entity* entity = GetEntityAtRow(manager, row);
+            if (tier >= entity->simulationTier) continue;
+            if (entity->simulationTier == ENTITY_SIMULATION_SLEEPING) {
+                PushAwakeEntity(simulation, entity->handle);
+            }
+            entity->simulationTier = tier;
+        }
+    }
+
+    memset(simulation->stats.population, 0, sizeof(simulation->stats.population));
+    for (size_t i = 0; i < simulation->awakeCount; i++) {
+        simulation->stats.population[GetEntity(manager, simulation->awake[i])->simulationTier]++;
+    }
+    simulation->stats.population[ENTITY_SIMULATION_SLEEPING] = manager->entityCount - simulation->awakeCount;
+}
+
+// Keep an entity at full rate for at least duration seconds, wherever it is
+void WakeEntity(EntityManager* manager, Entity* entity, float duration) {
+    if (entity == NULL) return;
+    if (duration > entity->wakeTime) entity->wakeTime = duration;
+    if (!IsEntityManaged(manager, entity) || !manager->simulation.enabled) return;
+    if (entity->simulationTier == ENTITY_SIMULATION_SLEEPING) {
+        PushAwakeEntity(&manager->simulation, entity->handle);
+    }
+    entity->simulationTier = ENTITY_SIMULATION_FULL;
+}
+
+// Per-tier update counts for the last frame and populations at the last refresh
+EntitySimulationStats GetEntitySimulationStats(const EntityManager* manager) {
+    if (manager == NULL) return (EntitySimulationStats){0};
+    return manager->simulation.stats;
+}
+
+// Switch the manager to struct-of-arrays storage for the hot fields
+void EnableEntityComponentStore(EntityManager* manager) {
+    if (manager == NULL || manager->useComponentStore) return;
+    for (size_t c = 0; c < manager->chunkCount; c++) {
+        memset(manager->chunks[c]->active, 0, sizeof(manager->chunks[c]->active));
+    }
+    for (size_t i = 0; i < manager->entityCount; i++) {
+        WriteEntityRow(manager, i, GetEntityAtRow(manager, i));
+    }
+    manager->useComponentStore = true;
+}
+
+// Get a contiguous run of component rows, one per chunk. Span i covers
+// dense rows [i * ENTITY_CHUNK_SIZE, i * ENTITY_CHUNK_SIZE + count).
+// Returns false past the last span.
+bool GetEntityComponentSpan(EntityManager* manager, size_t spanIndex, EntityComponentSpan* outSpan) {
+    if (manager == NULL || outSpan == NULL || !manager->useComponentStore) return false;
+    if (spanIndex >= manager->chunkCount || ChunkRowCount(manager, spanIndex) == 0) return false;
+    *outSpan = ChunkSpan(manager, spanIndex);
+    return true;
+}
+
+// Refresh the Entity view from the component columns
+void SyncEntityViews(EntityManager* manager) {
+    if (manager == NULL || !manager->useComponentStore) return;
+    for (size_t c = 0; c < manager->chunkCount; c++) {
+        EntityChunk* chunk = manager->chunks[c];
+        EntityComponentSpan span = ChunkSpan(manager, c);
+        for (size_t i = 0; i < span.count; i++) {
+            Entity* entity = chunk->entities[i];
+            entity->position = span.positions[i];
+            entity->width = span.sizes[i].x;
+            entity->height = span.sizes[i].y;
+            entity->hitbox = span.hitboxes[i];
+            entity->isActive = IsEntityRowActive(&span, i);
+        }
+    }
+}
+
+// Push fields written through Entity pointers back into the columns
+void SyncEntityComponents(EntityManager* manager) {
+    if (manager == NULL || !manager->useComponentStore) return;
+    for (size_t i = 0; i < manager->entityCount; i++) {
+        WriteEntityRow(manager, i, GetEntityAtRow(manager, i));
+    }
+}
+
+// Set an entity's position in both the view and the column
+void SetEntityPosition(EntityManager* manager, Entity* entity, Vector2 position) {
+    if (entity == NULL) return;
+    entity->position = position;
+    if (manager != NULL) manager->gridDirty = true;
+    if (manager != NULL && manager->useComponentStore && IsEntityHandleValid(manager, entity->handle)) {
+        uint32_t row = GetEntitySlot(manager, entity->handle.index)->row;
+        GetEntityChunk(manager, row)->positions[row & ENTITY_CHUNK_MASK] = position;
+    }
+}
+
+// Set an entity's active flag in both the view and the bitset
+void SetEntityActive(EntityManager* manager, Entity* entity, bool active) {
+    if (entity == NULL) return;
+    entity->isActive = active;
+    if (manager != NULL) manager->gridDirty = true;
+    if (manager != NULL && manager->useComponentStore && IsEntityHandleValid(manager, entity->handle)) {
+        uint32_t row = GetEntitySlot(manager, entity->handle.index)->row;
+        EntityComponentSpan span = ChunkSpan(manager, row >> ENTITY_CHUNK_SHIFT);
+        SetEntityRowActive(&span, row & ENTITY_CHUNK_MASK, active);
+    }
+}
@@ -5,17 +5,76 @@
 #define ENTITY_MANAGER_H
 #include "raylib.h"
 #include "../sprite/sprite_object.h"
+#include "../sprite/sprite_batch.h"
+#include "entity_components.h"
+#include "entity_spatial.h"
+#include "entity_transform.h"
+#include "../world/memory_manager.h"
 
 #include "../util/globals.h"
 
-// Simple hitbox definition
+// Entities live in fixed-size chunks so growing never moves them.
+// The chunk size is a multiple of the active bitset word size.
+#define ENTITY_CHUNK_SHIFT 8
+#define ENTITY_CHUNK_SIZE (1u << ENTITY_CHUNK_SHIFT)
+#define ENTITY_CHUNK_MASK (ENTITY_CHUNK_SIZE - 1)
+#define DEFAULT_ENTITY_CAPACITY ENTITY_CHUNK_SIZE
+#define MAX_ENTITY_NAME_LENGTH 64
+#define ENTITY_POOL_SLAB_SIZE 256
+
+// Generational handle to an entity slot. A handle goes stale as soon as
+// its entity is removed, even if the slot is reused later on.
+// The zero handle is never valid.
 typedef struct {
-    int x, y, w, h;
-} Hitbox_t;
+    uint32_t index;
+    uint32_t generation;
+} EntityHandle;
 
-// Maximum number of entities the manager can handle
-#define MAX_ENTITIES 255
-#define MAX_ENTITY_NAME_LENGTH 64
+#define ENTITY_SLOT_NONE UINT32_MAX
+
+// Entity types are interned to small IDs when they are registered
+#define MAX_ENTITY_TYPES 32
+#define MAX_ENTITY_TYPE_NAME_LENGTH 32
+typedef uint16_t EntityTypeId;
+#define ENTITY_TYPE_NONE UINT16_MAX
+
+// Behaviours are registered once and shared by every entity that uses them.
+// ID 0 means "no behaviour", so zero-initialised entities have none.
+#define MAX_ENTITY_BEHAVIOURS 32
+typedef uint16_t EntityBehaviourId;
+#define ENTITY_BEHAVIOUR_NONE 0
+
+// Component signatures. Each registered component type owns one bit;
+// queries match entities by the bits they must and must not have.
+#define MAX_ENTITY_COMPONENT_TYPES 64
+typedef uint8_t EntityComponentId;
+#define ENTITY_COMPONENT_NONE UINT8_MAX
+typedef uint64_t EntitySignature;
+#define ENTITY_SIGNATURE_BIT(componentId) ((EntitySignature)1 << (componentId))
+
+// Cached queries over entity signatures
+#define MAX_ENTITY_QUERIES 32
+typedef uint16_t EntityQueryId;
+#define ENTITY_QUERY_NONE UINT16_MAX
+
+// Simulation level of detail. Entities near a simulation region update
+// every frame, farther ones every Nth frame with the time accumulated
+// since, and entities outside every region sleep.
+typedef enum {
+    ENTITY_SIMULATION_FULL,      // Zero, so new entities start at full rate
+    ENTITY_SIMULATION_REDUCED,
+    ENTITY_SIMULATION_DISTANT,
+    ENTITY_SIMULATION_SLEEPING,
+    ENTITY_SIMULATION_TIER_COUNT
+} EntitySimulationTier;
+#define ENTITY_SIMULATION_AWAKE_TIERS ENTITY_SIMULATION_SLEEPING
+#define MAX_SIMULATION_REGIONS 8
+
+// Prefabs are entity templates registered once and instantiated in bulk
+#define MAX_ENTITY_PREFABS 32
+#define MAX_ENTITY_PREFAB_NAME_LENGTH 32
+typedef uint16_t EntityPrefabId;
+#define ENTITY_PREFAB_NONE UINT16_MAX
 
 // Entity Manager States
 typedef struct {
@@ -51,29 +110,385 @@ typedef struct {
     IEntity* interface;
     float width, height;
     Hitbox_t hitbox;
+    EntityHandle handle; // Assigned by AddEntity
+    EntityTypeId typeId; // Interned from entityType by AddEntity
+    uint32_t typeRow;    // Position in the type's member list
+    uint32_t nameHash;   // HashEntityName(name), kept by AddEntity/RenameEntity
+    EntityBehaviourId behaviourId; // Set before AddEntity or with SetEntityBehaviour
+    uint32_t behaviourRow;         // Position in the behaviour's member list
+    EntitySignature signature;     // Set before AddEntity or with SetEntitySignature
+    uint32_t transformNode;        // Node in the manager's transform hierarchy, if attached; AddEntity clears it
+    uint8_t simulationTier;        // EntitySimulationTier, kept while simulation LOD is enabled
+    float wakeTime;                // Seconds WakeEntity keeps the entity at full rate
 } Entity;
 
+// Entity behaviour. The callbacks are made once per frame with every
+// entity using the behaviour, so the per-entity cost is a loop iteration
+// instead of an indirect call. Inactive members are included in the
+// batch and are expected to be skipped by the behaviour.
+typedef struct {
+    const char* name;
+    void (*UpdateBatch)(Entity** entities, size_t count, float deltaTime, void* userData);
+    void (*DrawBatch)(Entity** entities, size_t count, void* userData);
+    void* userData;
+} EntityBehaviour;
+
+// Borrowed, read-only list of entities. Valid until the next add/remove.
+typedef struct {
+    Entity* const* items;
+    size_t count;
+} EntityView;
+
+// Candidate collision pair
+typedef struct {
+    Entity* a;
+    Entity* b;
+} EntityPair;
+
+// Dense membership list that grows on demand
+typedef struct {
+    Entity** members;
+    size_t count;
+    size_t capacity;
+} EntityBucket;
+
+// Open-addressing name index entry, keyed by name hash, pointing at a slot
+typedef struct {
+    uint32_t hash;
+    uint32_t slot;
+} EntityNameEntry;
+
+// Entity command types
+typedef enum {
+    ENTITY_COMMAND_SPAWN,
+    ENTITY_COMMAND_DESPAWN,
+    ENTITY_COMMAND_SET_POSITION,
+    ENTITY_COMMAND_SET_ACTIVE,
+    ENTITY_COMMAND_SET_BEHAVIOUR,
+    ENTITY_COMMAND_CHANGE_COMPONENTS
+} EntityCommandType;
+
+// Recorded entity command
+typedef struct {
+    EntityCommandType type;
+    EntityHandle handle;    // Target of despawn and component commands
+    Entity* entity;         // Entity to spawn
+    union {
+        Vector2 position;
+        bool active;
+        EntityBehaviourId behaviourId;
+        struct {
+            EntitySignature add;
+            EntitySignature remove;
+        } components;
+    } value;
+} EntityCommand;
+
+// Command buffer. Records spawns, despawns and component changes so they
+// are applied at one sync point (FlushEntityCommands) instead of while the
+// entity list is being walked. Worker threads can each fill their own
+// buffer and have the main thread flush them in turn.
+typedef struct {
+    EntityCommand* commands;
+    size_t count;
+    size_t capacity;
+} EntityCommandBuffer;
+
+// Registered entity type and its members
+typedef struct {
+    char name[MAX_ENTITY_TYPE_NAME_LENGTH];
+    EntityBucket bucket;
+} EntityTypeInfo;
+
+// Registered behaviour and its members
+typedef struct {
+    EntityBehaviour behaviour;
+    EntityBucket bucket;
+} EntityBehaviourInfo;
+
+// Cached query. Holds every entity whose signature contains all of the
+// required bits and none of the excluded ones, kept up to date as
+// entities are added, removed or change signature. rows[i] is the dense
+// row of members[i], for loops over the chunk component columns.
+typedef struct {
+    EntitySignature required;
+    EntitySignature excluded;
+    Entity** members;
+    uint32_t* rows;
+    size_t count;
+    size_t capacity;
+    uint32_t* positions;      // Member position by slot index, ENTITY_SLOT_NONE if absent
+    size_t positionCapacity;
+} EntityQuery;
+
+// Simulation LOD settings. Tier radii increase outwards; intervals are
+// rounded up to powers of two so every tier is due on a refresh frame.
+typedef struct {
+    float radius[ENTITY_SIMULATION_AWAKE_TIERS];      // Outer radius of each awake tier
+    uint32_t interval[ENTITY_SIMULATION_AWAKE_TIERS]; // Frames between updates
+} EntitySimulationSettings;
+
+#define ENTITY_SIMULATION_DEFAULT_SETTINGS ((EntitySimulationSettings){ { 640.0f, 1280.0f, 2560.0f }, { 1, 4, 8 } })
+
+// Simulation LOD counters
+typedef struct {
+    size_t updated[ENTITY_SIMULATION_TIER_COUNT];    // Update calls plus behaviour batch members in the last frame
+    size_t population[ENTITY_SIMULATION_TIER_COUNT]; // Entities per tier at the last refresh
+} EntitySimulationStats;
+
+// Simulation LOD state. Tiers are reassigned from grid queries around
+// the regions every refresh (the longest interval); in between, every
+// entity that is not asleep is in the awake list.
+typedef struct {
+    bool enabled;
+    EntitySimulationSettings settings;
+    Vector2 regions[MAX_SIMULATION_REGIONS];
+    size_t regionCount;
+    uint32_t frame;
+    float tierTime[ENTITY_SIMULATION_AWAKE_TIERS];    // Time accumulated since each tier last ran
+    float refreshTime;                                // Time since the last refresh
+    EntityHandle* awake;
+    size_t awakeCount;
+    size_t awakeCapacity;
+    Entity** batch;                                   // Behaviour members sorted by tier
+    size_t batchCapacity;
+    EntitySimulationStats stats;
+} EntitySimulationLod;
+
+// Entity prefab. Every instance starts as a copy of the template entity
+// and, when hasSprite is set, of the template sprite. The sprite position
+// is an offset from the entity position. Template sprites must use a
+// shared (AssetManager) texture or none, since instances cannot own one.
+typedef struct {
+    Entity entity;
+    SpriteObject sprite;
+    bool hasSprite;
+} EntityPrefab;
+
+// Registered prefab. The template's type is interned and its texture is
+// retained for as long as the prefab is registered.
+typedef struct {
+    char name[MAX_ENTITY_PREFAB_NAME_LENGTH];
+    EntityPrefab prefab;
+} EntityPrefabInfo;
+
+// Slot map entry. A live slot knows its row in the dense entity array,
+// a free slot links to the next free slot.
+typedef struct {
+    uint32_t generation;
+    uint32_t row;
+    uint32_t nextFree;
+} EntitySlot;
+
+// Fixed-size block of storage. Dense row r lives in chunk r >> ENTITY_CHUNK_SHIFT,
+// and so does slot s. The component columns are struct-of-arrays copies
+// of the hot Entity fields, used while the component store is enabled.
+typedef struct {
+    Entity* entities[ENTITY_CHUNK_SIZE];
+    EntitySlot slots[ENTITY_CHUNK_SIZE];
+    uint32_t liveSlots;
+    Vector2 positions[ENTITY_CHUNK_SIZE];
+    Vector2 sizes[ENTITY_CHUNK_SIZE];
+    Hitbox_t hitboxes[ENTITY_CHUNK_SIZE];
+    SpriteObject* sprites[ENTITY_CHUNK_SIZE];
+    uint64_t active[ENTITY_ACTIVE_WORDS(ENTITY_CHUNK_SIZE)];
+} EntityChunk;
+
+// Occupancy of one chunk
+typedef struct {
+    size_t rows;       // Dense rows in use
+    size_t liveSlots;  // Slots holding a live entity
+    size_t usedSlots;  // Slots handed out at least once
+    size_t bytes;
+} EntityChunkStats;
+
 // Entity Manager Structure
 typedef struct {
-    Entity* entities[MAX_ENTITIES];
-    size_t entityCount;
+    // Chunk directory. Growing it copies pointers only; chunks never move.
+    EntityChunk** chunks;
+    size_t chunkCount;
+    size_t chunkDirectoryCapacity;
+    size_t maxEntities;             // 0 means no limit
+    size_t entityCount;             // Dense rows [0, entityCount) are live entities
+    uint32_t slotCount;             // Slots handed out so far
+    uint32_t freeSlot;              // Head of the free slot list
     int state;
+
+    // Structural changes made while entities are being updated are
+    // deferred into this buffer and flushed at the end of UpdateEntities
+    EntityCommandBuffer commands;
+    bool updating;
+
+    EntityTypeInfo types[MAX_ENTITY_TYPES];
+    size_t typeCount;
+
+    // Index 0 is the "no behaviour" entry and is never dispatched
+    EntityBehaviourInfo behaviours[MAX_ENTITY_BEHAVIOURS + 1];
+    size_t behaviourCount;
+
+    EntityPrefabInfo prefabs[MAX_ENTITY_PREFABS];
+    size_t prefabCount;
+
+    char componentTypes[MAX_ENTITY_COMPONENT_TYPES][MAX_ENTITY_TYPE_NAME_LENGTH];
+    size_t componentTypeCount;
+    EntityQuery queries[MAX_ENTITY_QUERIES];
+    size_t queryCount;
+
+    // Name -> slot index (power-of-two capacity, linear probing)
+    EntityNameEntry* nameIndex;
+    size_t nameIndexCapacity;
+    size_t nameIndexCount;  // Live entries
+    size_t nameIndexUsed;   // Live entries plus tombstones
+
+    // Broadphase over entity hitboxes, rebuilt by the first query after
+    // UpdateEntities or any add, remove or SetEntityPosition
+    EntitySpatialGrid grid;
+    bool gridDirty;
+    uint32_t* gridScratch;
+    size_t gridScratchCapacity;
+    EntityGridPair* pairScratch;
+    size_t pairScratchCapacity;
+
+    // Optional parent/child transforms, applied at the end of UpdateEntities
+    EntityTransformHierarchy transforms;
+
+    // Optional distance-based update rates, see EnableEntitySimulationLod
+    EntitySimulationLod simulation;
+
+    // While the component store is enabled the chunk columns are
+    // authoritative and the matching Entity fields are a view refreshed
+    // by SyncEntityViews.
+    bool useComponentStore;
 } EntityManager;
 
+// Chunk lookups for a dense row or a slot index
+static inline EntityChunk* GetEntityChunk(const EntityManager* manager, size_t index) {
+    return manager->chunks[index >> ENTITY_CHUNK_SHIFT];
+}
+
+static inline Entity* GetEntityAtRow(const EntityManager* manager, size_t row) {
+    return GetEntityChunk(manager, row)->entities[row & ENTITY_CHUNK_MASK];
+}
+
+static inline EntitySlot* GetEntitySlot(const EntityManager* manager, uint32_t index) {
+    return &GetEntityChunk(manager, index)->slots[index & ENTITY_CHUNK_MASK];
+}
+
 // Entity Manager States
 typedef enum {
     ENTITY_MANAGER_UNINITIALIZED,
     ENTITY_MANAGER_INITIALIZED
 } EntityManagerState;
 
+// Pool backing CreateEntity
+extern MemoryPool g_entityPool;
+
 // Entity Manager Functions
+Entity* CreateEntity(void);
+void DestroyEntity(Entity* entity);
 void InitEntityManager(EntityManager* manager);
-void AddEntity(EntityManager* manager, Entity* entity);
+bool InitEntityManagerWithCapacity(EntityManager* manager, size_t initialCapacity, size_t maxEntities);
+bool ReserveEntities(EntityManager* manager, size_t capacity);
+size_t GetEntityCapacity(const EntityManager* manager);
+bool GetEntityChunkStats(const EntityManager* manager, size_t chunkIndex, EntityChunkStats* outStats);
+void PrintEntityMemoryStats(const EntityManager* manager);
+void FreeEntityManager(EntityManager* manager);
+EntityHandle AddEntity(EntityManager* manager, Entity* entity);
 void RemoveEntity(EntityManager* manager, int entityId);
+bool RemoveEntityByHandle(EntityManager* manager, EntityHandle handle);
 void UpdateEntities(EntityManager* manager, float deltaTime);
 void DrawEntities(const EntityManager* manager);
+void DrawEntitiesInView(const EntityManager* manager, Rectangle view);
+void BatchEntitySprites(const EntityManager* manager, SpriteBatch* batch);
 void UnloadAllEntities(EntityManager* manager);
+Entity* GetEntity(const EntityManager* manager, EntityHandle handle);
+bool IsEntityHandleValid(const EntityManager* manager, EntityHandle handle);
 Entity* GetEntityByID(const EntityManager* manager, int entityId);
 Entity* GetEntityByName(const EntityManager* manager, const char* name);
+Entity* GetEntityByNameHash(const EntityManager* manager, uint32_t nameHash, const char* name);
+bool RenameEntity(EntityManager* manager, Entity* entity, const char* newName);
+uint32_t HashEntityName(const char* name);
 Entity** GetEntitiesByType(const EntityManager* manager, const char* type, size_t* outCount);
+
+// Entity command buffer functions
+void InitEntityCommandBuffer(EntityCommandBuffer* buffer);
+void RecordSpawnEntity(EntityCommandBuffer* buffer, Entity* entity);
+void RecordDespawnEntity(EntityCommandBuffer* buffer, EntityHandle handle);
+void RecordSetEntityPosition(EntityCommandBuffer* buffer, EntityHandle handle, Vector2 position);
+void RecordSetEntityActive(EntityCommandBuffer* buffer, EntityHandle handle, bool active);
+void RecordSetEntityBehaviour(EntityCommandBuffer* buffer, EntityHandle handle, EntityBehaviourId behaviourId);
+void RecordChangeEntityComponents(EntityCommandBuffer* buffer, EntityHandle handle, EntitySignature add, EntitySignature remove);
+void ClearEntityCommandBuffer(EntityCommandBuffer* buffer);
+void FreeEntityCommandBuffer(EntityCommandBuffer* buffer);
+void FlushEntityCommands(EntityManager* manager, EntityCommandBuffer* buffer);
+
+// Entity type functions
+EntityTypeId RegisterEntityType(EntityManager* manager, const char* name);
+EntityTypeId FindEntityType(const EntityManager* manager, const char* name);
+EntityView GetEntityViewByType(const EntityManager* manager, EntityTypeId typeId);
+void ForEachEntityOfType(const EntityManager* manager, EntityTypeId typeId, void (*callback)(Entity* entity, void* userData), void* userData);
+
+// Entity behaviour functions
+EntityBehaviourId RegisterEntityBehaviour(EntityManager* manager, const EntityBehaviour* behaviour);
+EntityBehaviourId FindEntityBehaviour(const EntityManager* manager, const char* name);
+void SetEntityBehaviour(EntityManager* manager, Entity* entity, EntityBehaviourId behaviourId);
+EntityView GetEntityViewByBehaviour(const EntityManager* manager, EntityBehaviourId behaviourId);
+
+// Entity signature and query functions
+EntityComponentId RegisterEntityComponent(EntityManager* manager, const char* name);
+EntityComponentId FindEntityComponent(const EntityManager* manager, const char* name);
+void SetEntitySignature(EntityManager* manager, Entity* entity, EntitySignature signature);
+void AddEntityComponents(EntityManager* manager, Entity* entity, EntitySignature components);
+void RemoveEntityComponents(EntityManager* manager, Entity* entity, EntitySignature components);
+EntityQueryId RegisterEntityQuery(EntityManager* manager, EntitySignature required, EntitySignature excluded);
+EntityView GetEntityQueryView(const EntityManager* manager, EntityQueryId queryId);
+const uint32_t* GetEntityQueryRows(const EntityManager* manager, EntityQueryId queryId, size_t* outCount);
+
+// Entity prefab functions
+EntityPrefabId RegisterEntityPrefab(EntityManager* manager, const char* name, const EntityPrefab* prefab);
+EntityPrefabId FindEntityPrefab(const EntityManager* manager, const char* name);
+const EntityPrefab* GetEntityPrefab(const EntityManager* manager, EntityPrefabId prefabId);
+size_t InstantiatePrefab(EntityManager* manager, EntityPrefabId prefabId, size_t count, const Vector2* positions, EntityHandle* outHandles);
+
+// Bulk insertion functions, for loaders that reserve once and then add
+// entities whose type is already interned and name already hashed
+bool ReserveEntityInsertion(EntityManager* manager, size_t count, size_t spriteCount,
+                            const size_t* typeCounts, const size_t* behaviourCounts);
+size_t InsertReservedEntities(EntityManager* manager, Entity** entities, size_t count);
+
+// Spatial query functions. Hitboxes are offsets from the entity position;
+// an empty hitbox falls back to the entity width and height.
+Rectangle GetEntityBounds(const Entity* entity);
+void SetEntityGridCellSize(EntityManager* manager, float cellSize);
+void RebuildEntitySpatialGrid(EntityManager* manager);
+size_t QueryEntitiesInRect(EntityManager* manager, Rectangle area, Entity** outEntities, size_t maxEntities);
+size_t QueryEntitiesInRadius(EntityManager* manager, Vector2 center, float radius, Entity** outEntities, size_t maxEntities);
+size_t FindEntityCollisionPairs(EntityManager* manager, EntityPair* outPairs, size_t maxPairs);
+
+// Transform hierarchy functions. An entity with a transform is moved
+// through its local transform; UpdateEntityTransforms writes the world
+// result into the entity position and its sprite.
+bool AttachEntityTransform(EntityManager* manager, Entity* entity, EntityTransform local);
+void DetachEntityTransform(EntityManager* manager, Entity* entity);
+bool SetEntityParent(EntityManager* manager, Entity* child, Entity* parent);
+void SetEntityLocalTransform(EntityManager* manager, Entity* entity, EntityTransform local);
+EntityTransform GetEntityLocalTransform(const EntityManager* manager, const Entity* entity);
+EntityTransform GetEntityWorldTransform(const EntityManager* manager, const Entity* entity);
+void UpdateEntityTransforms(EntityManager* manager);
+
+// Simulation LOD functions
+void EnableEntitySimulationLod(EntityManager* manager, const EntitySimulationSettings* settings);
+void DisableEntitySimulationLod(EntityManager* manager);
+void SetEntitySimulationRegions(EntityManager* manager, const Vector2* centers, size_t count);
+void RefreshEntitySimulationTiers(EntityManager* manager);
+void WakeEntity(EntityManager* manager, Entity* entity, float duration);
+EntitySimulationStats GetEntitySimulationStats(const EntityManager* manager);
+
+// Component store functions
+void EnableEntityComponentStore(EntityManager* manager);
+bool GetEntityComponentSpan(EntityManager* manager, size_t spanIndex, EntityComponentSpan* outSpan);
+void SyncEntityViews(EntityManager* manager);
+void SyncEntityComponents(EntityManager* manager);
+void SetEntityPosition(EntityManager* manager, Entity* entity, Vector2 position);
+void SetEntityActive(EntityManager* manager, Entity* entity, bool active);
 #endif // ENTITY_MANAGER_H 
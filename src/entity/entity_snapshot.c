@@ -0,0 +1,434 @@
+// =============================================================
+// Entity Snapshot implementation
+// =============================================================
+// Versioned little-endian entity save/load.
+#include "entity_snapshot.h"
+#include "../util/asset_manager.h"
+#include "../util/file_utils.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(sizeof(EntitySnapshotHeader) == 32, "EntitySnapshotHeader layout changed");
+_Static_assert(sizeof(EntitySnapshotRecord) == 116 && offsetof(EntitySnapshotRecord, nameHash) == 112,
+               "EntitySnapshotRecord layout changed");
+
+// Records are written and read as-is, so the host must be little-endian
+static bool IsHostLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+// Records are staged in batches of this many before being written, and
+// loaded entities before being inserted
+#define SNAPSHOT_WRITE_BATCH 1024
+#define SNAPSHOT_READ_BATCH 1024
+
+// String table entry: a string's hash and its offset in the table
+typedef struct {
+    uint32_t hash;
+    uint32_t offset;
+} SnapshotStringEntry;
+
+// String table built while saving. Shared strings are deduplicated
+// through the set; entity names are appended as they are.
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+    SnapshotStringEntry* entries;   // Open-addressing set over the shared strings
+    size_t entryCapacity;
+    size_t entryCount;
+    const char* lastType;           // Interned type name of the previous entity
+    uint32_t lastTypeOffset;
+} SnapshotStringTable;
+
+// Double the string set and re-place every entry
+static bool GrowStringSet(SnapshotStringTable* table) {
+    size_t capacity = table->entryCapacity ? table->entryCapacity * 2 : 64;
+    SnapshotStringEntry* entries = (SnapshotStringEntry*)malloc(capacity * sizeof(SnapshotStringEntry));
+    if (entries == NULL) return false;
+    for (size_t i = 0; i < capacity; i++) entries[i].offset = ENTITY_SNAPSHOT_NO_STRING;
+    for (size_t i = 0; i < table->entryCapacity; i++) {
+        SnapshotStringEntry entry = table->entries[i];
+        if (entry.offset == ENTITY_SNAPSHOT_NO_STRING) continue;
+        size_t slot = entry.hash & (capacity - 1);
+        while (entries[slot].offset != ENTITY_SNAPSHOT_NO_STRING) slot = (slot + 1) & (capacity - 1);
+        entries[slot] = entry;
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->entryCapacity = capacity;
+    return true;
+}
+
+// Make room for length more bytes of string data
+static bool ReserveSnapshotStringData(SnapshotStringTable* table, size_t length) {
+    if (table->size + length <= table->capacity) return true;
+    size_t capacity = table->capacity ? table->capacity : 4096;
+    while (table->size + length > capacity) capacity *= 2;
+    char* data = (char*)realloc(table->data, capacity);
+    if (data == NULL) return false;
+    table->data = data;
+    table->capacity = capacity;
+    return true;
+}
+
+// Append a string without looking for an earlier copy and return its offset.
+// Entity names are nearly always unique, so they skip the set.
+static uint32_t AppendSnapshotString(SnapshotStringTable* table, const char* string, bool* ok) {
+    size_t length = strlen(string) + 1;
+    if (!ReserveSnapshotStringData(table, length)) {
+        *ok = false;
+        return ENTITY_SNAPSHOT_NO_STRING;
+    }
+    uint32_t offset = (uint32_t)table->size;
+    memcpy(table->data + offset, string, length);
+    table->size += length;
+    return offset;
+}
+
+// Add a shared string (type, behaviour, sprite name or texture path) with
+// a known HashEntityName hash, or find its earlier copy, and return its offset
+static uint32_t AddSnapshotStringHashed(SnapshotStringTable* table, const char* string, uint32_t hash, bool* ok) {
+    if (string == NULL) return ENTITY_SNAPSHOT_NO_STRING;
+    if ((table->entryCount + 1) * 2 > table->entryCapacity && !GrowStringSet(table)) {
+        *ok = false;
+        return ENTITY_SNAPSHOT_NO_STRING;
+    }
+    size_t mask = table->entryCapacity - 1;
+    size_t slot = hash & mask;
+    for (; table->entries[slot].offset != ENTITY_SNAPSHOT_NO_STRING; slot = (slot + 1) & mask) {
+        SnapshotStringEntry entry = table->entries[slot];
+        if (entry.hash == hash && strcmp(table->data + entry.offset, string) == 0) return entry.offset;
+    }
+
+    uint32_t offset = AppendSnapshotString(table, string, ok);
+    if (offset == ENTITY_SNAPSHOT_NO_STRING) return offset;
+    table->entries[slot] = (SnapshotStringEntry){ hash, offset };
+    table->entryCount++;
+    return offset;
+}
+
+static uint32_t AddSnapshotString(SnapshotStringTable* table, const char* string, bool* ok) {
+    if (string == NULL) return ENTITY_SNAPSHOT_NO_STRING;
+    return AddSnapshotStringHashed(table, string, HashEntityName(string), ok);
+}
+
+// Fill a record from an entity
+static void WriteSnapshotRecord(const EntityManager* manager, const Entity* entity, EntitySnapshotRecord* record,
+                                SnapshotStringTable* strings, bool* ok) {
+    memset(record, 0, sizeof(EntitySnapshotRecord));
+    record->id = entity->id;
+    record->flags = entity->isActive ? ENTITY_SNAPSHOT_ACTIVE : 0;
+    record->name = entity->name[0] != '\0' ? AppendSnapshotString(strings, entity->name, ok) : ENTITY_SNAPSHOT_NO_STRING;
+    record->nameHash = entity->nameHash;
+    // Managed entities point at interned type names, so runs of one type skip the lookup
+    if (entity->entityType == NULL || entity->entityType != strings->lastType) {
+        strings->lastType = entity->entityType;
+        strings->lastTypeOffset = AddSnapshotString(strings, entity->entityType, ok);
+    }
+    record->type = strings->lastTypeOffset;
+    record->behaviour = entity->behaviourId != ENTITY_BEHAVIOUR_NONE
+        ? AddSnapshotString(strings, manager->behaviours[entity->behaviourId].behaviour.name, ok)
+        : ENTITY_SNAPSHOT_NO_STRING;
+    record->position[0] = entity->position.x;
+    record->position[1] = entity->position.y;
+    record->size[0] = entity->width;
+    record->size[1] = entity->height;
+    record->hitbox[0] = entity->hitbox.x;
+    record->hitbox[1] = entity->hitbox.y;
+    record->hitbox[2] = entity->hitbox.w;
+    record->hitbox[3] = entity->hitbox.h;
+
+    const SpriteObject* sprite = entity->sprite;
+    record->spriteName = ENTITY_SNAPSHOT_NO_STRING;
+    record->texturePath = ENTITY_SNAPSHOT_NO_STRING;
+    if (sprite == NULL) return;
+    record->flags |= ENTITY_SNAPSHOT_HAS_SPRITE;
+    if (sprite->visible) record->flags |= ENTITY_SNAPSHOT_VISIBLE;
+    if (sprite->animating) record->flags |= ENTITY_SNAPSHOT_ANIMATING;
+    record->spriteId = sprite->id;
+    record->spriteName = AddSnapshotString(strings, sprite->name, ok);
+    // Atlas sprites save the image path, so loading resolves them through the atlas again
+    const char* atlasName = GetTextureAtlasEntryName(&g_textureAtlas, sprite->atlasEntry);
+    if (atlasName != NULL) {
+        record->texturePath = AddSnapshotString(strings, atlasName, ok);
+    } else if (sprite->sharedTexture) {
+        record->texturePath = AddSnapshotString(strings, g_assetManager.texturePaths[sprite->textureHandle], ok);
+    }
+    record->spriteType = (int32_t)sprite->type;
+    record->spritePosition[0] = sprite->position.x;
+    record->spritePosition[1] = sprite->position.y;
+    record->spriteScale[0] = sprite->scale.x;
+    record->spriteScale[1] = sprite->scale.y;
+    record->spriteOrigin[0] = sprite->origin.x;
+    record->spriteOrigin[1] = sprite->origin.y;
+    record->spriteRotation = sprite->rotation;
+    record->frameTime = sprite->frameTime;
+    record->currentFrame = sprite->currentFrame;
+    record->totalFrames = sprite->totalFrames;
+    record->tint[0] = sprite->tint.r;
+    record->tint[1] = sprite->tint.g;
+    record->tint[2] = sprite->tint.b;
+    record->tint[3] = sprite->tint.a;
+}
+
+// Save every entity in the manager to a snapshot file
+bool SaveEntitySnapshot(EntityManager* manager, const char* filePath) {
+    if (manager == NULL || filePath == NULL) return false;
+    if (!IsHostLittleEndian()) {
+        printf("Error: Entity snapshots are only supported on little-endian hosts.\n");
+        return false;
+    }
+    SyncEntityViews(manager);
+
+    EntitySnapshotRecord* records = (EntitySnapshotRecord*)malloc(SNAPSHOT_WRITE_BATCH * sizeof(EntitySnapshotRecord));
+    FILE* file = records != NULL ? fopen(filePath, "wb") : NULL;
+    if (file == NULL) {
+        printf("Error: Could not write entity snapshot %s\n", filePath);
+        free(records);
+        return false;
+    }
+
+    // The string table goes last, so its offset is known before any record is built
+    EntitySnapshotHeader header = {
+        .version = ENTITY_SNAPSHOT_VERSION,
+        .headerSize = sizeof(EntitySnapshotHeader),
+        .recordSize = sizeof(EntitySnapshotRecord),
+        .entityCount = (uint32_t)manager->entityCount,
+        .recordsOffset = sizeof(EntitySnapshotHeader),
+        .stringsOffset = (uint32_t)(sizeof(EntitySnapshotHeader) + manager->entityCount * sizeof(EntitySnapshotRecord)),
+        .stringsSize = 0
+    };
+    memcpy(header.magic, ENTITY_SNAPSHOT_MAGIC, sizeof(header.magic));
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Size the string data for a short name per entity up front
+    SnapshotStringTable strings = {0};
+    ok = ok && ReserveSnapshotStringData(&strings, manager->entityCount * 16);
+    for (size_t first = 0; first < manager->entityCount && ok; first += SNAPSHOT_WRITE_BATCH) {
+        size_t count = manager->entityCount - first;
+        if (count > SNAPSHOT_WRITE_BATCH) count = SNAPSHOT_WRITE_BATCH;
+        for (size_t i = 0; i < count; i++) {
+            WriteSnapshotRecord(manager, GetEntityAtRow(manager, first + i), &records[i], &strings, &ok);
+        }
+        ok = ok && fwrite(records, sizeof(EntitySnapshotRecord), count, file) == count;
+    }
+    header.stringsSize = (uint32_t)strings.size;
+    ok = ok && fwrite(strings.data, 1, strings.size, file) == strings.size;
+    // Patch the string table size now that it is known
+    ok = ok && fseek(file, offsetof(EntitySnapshotHeader, stringsSize), SEEK_SET) == 0 &&
+         fwrite(&header.stringsSize, sizeof(header.stringsSize), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    if (!ok) printf("Error: Could not write entity snapshot %s\n", filePath);
+
+    free(records);
+    free(strings.data);
+    free(strings.entries);
+    return ok;
+}
+
+// Resolve a string table offset, or NULL
+static const char* SnapshotString(const char* strings, uint32_t stringsSize, uint32_t offset) {
+    if (offset == ENTITY_SNAPSHOT_NO_STRING || offset >= stringsSize) return NULL;
+    return strings + offset;
+}
+
+// Check that the header describes a file we can read in place
+static bool ValidateSnapshot(const MappedFile* file, const EntitySnapshotHeader* header) {
+    if (file->size < sizeof(EntitySnapshotHeader) || memcmp(header->magic, ENTITY_SNAPSHOT_MAGIC, 4) != 0) {
+        printf("Error: Not an entity snapshot.\n");
+        return false;
+    }
+    if (header->version != ENTITY_SNAPSHOT_VERSION) {
+        printf("Error: Unsupported entity snapshot version %u.\n", header->version);
+        return false;
+    }
+    if (header->recordSize < sizeof(EntitySnapshotRecord) || header->recordSize % 4 != 0 || header->recordsOffset % 4 != 0 ||
+        (uint64_t)header->recordsOffset + (uint64_t)header->entityCount * header->recordSize > file->size ||
+        (uint64_t)header->stringsOffset + header->stringsSize > file->size ||
+        (header->stringsSize > 0 && file->data[header->stringsOffset + header->stringsSize - 1] != '\0')) {
+        printf("Error: Entity snapshot is truncated or corrupt.\n");
+        return false;
+    }
+    return true;
+}
+
+// Build the sprite described by a record
+static SpriteObject* ReadSnapshotSprite(const EntitySnapshotRecord* record, const char* strings, uint32_t stringsSize,
+                                        uint32_t* cachedPath, int* cachedHandle, int* cachedEntry) {
+    SpriteObject* sprite = CreateSpriteObject();
+    if (sprite == NULL) return NULL;
+    sprite->id = record->spriteId;
+    const char* name = SnapshotString(strings, stringsSize, record->spriteName);
+    if (name != NULL) {
+        strncpy(sprite->name, name, MAX_SPRITE_NAME_LENGTH - 1);
+    }
+    sprite->type = (SpriteType)record->spriteType;
+    sprite->position = (Vector2){ record->spritePosition[0], record->spritePosition[1] };
+    sprite->scale = (Vector2){ record->spriteScale[0], record->spriteScale[1] };
+    sprite->origin = (Vector2){ record->spriteOrigin[0], record->spriteOrigin[1] };
+    sprite->rotation = record->spriteRotation;
+    sprite->frameTime = record->frameTime;
+    sprite->currentFrame = record->currentFrame;
+    sprite->totalFrames = record->totalFrames;
+    sprite->tint = (Color){ record->tint[0], record->tint[1], record->tint[2], record->tint[3] };
+    sprite->visible = (record->flags & ENTITY_SNAPSHOT_VISIBLE) != 0;
+    sprite->animating = (record->flags & ENTITY_SNAPSHOT_ANIMATING) != 0;
+
+    // Each distinct path is resolved once; runs of the same texture reuse the handle
+    const char* texturePath = SnapshotString(strings, stringsSize, record->texturePath);
+    if (texturePath != NULL) {
+        if (record->texturePath == *cachedPath) {
+            SetSpriteSharedTexture(sprite, *cachedHandle);
+            if (*cachedEntry != TEXTURE_ATLAS_ENTRY_NONE) {
+                sprite->region = GetTextureAtlasRegion(&g_textureAtlas, *cachedEntry);
+                sprite->atlasEntry = *cachedEntry;
+            }
+        } else if (LoadSpriteObjectTexture(sprite, texturePath) && sprite->sharedTexture) {
+            *cachedPath = record->texturePath;
+            *cachedHandle = sprite->textureHandle;
+            *cachedEntry = sprite->atlasEntry;
+        }
+    }
+    return sprite;
+}
+
+// Type or behaviour IDs of the string offsets seen so far. Strings are
+// deduplicated when saving, so each distinct name has one offset.
+#define SNAPSHOT_ID_CACHE_SIZE 64
+typedef struct {
+    uint32_t offsets[SNAPSHOT_ID_CACHE_SIZE];
+    uint16_t ids[SNAPSHOT_ID_CACHE_SIZE];
+    size_t count;
+} SnapshotIdCache;
+
+static bool FindCachedSnapshotId(const SnapshotIdCache* cache, uint32_t offset, uint16_t* outId) {
+    for (size_t i = 0; i < cache->count; i++) {
+        if (cache->offsets[i] == offset) {
+            *outId = cache->ids[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void CacheSnapshotId(SnapshotIdCache* cache, uint32_t offset, uint16_t id) {
+    if (cache->count >= SNAPSHOT_ID_CACHE_SIZE) return;
+    cache->offsets[cache->count] = offset;
+    cache->ids[cache->count++] = id;
+}
+
+// Intern a record's type, once per distinct type name
+static EntityTypeId ResolveSnapshotType(EntityManager* manager, SnapshotIdCache* cache,
+                                        const char* strings, uint32_t stringsSize, uint32_t offset) {
+    EntityTypeId typeId;
+    if (FindCachedSnapshotId(cache, offset, &typeId)) return typeId;
+    const char* type = SnapshotString(strings, stringsSize, offset);
+    typeId = type != NULL ? RegisterEntityType(manager, type) : ENTITY_TYPE_NONE;
+    CacheSnapshotId(cache, offset, typeId);
+    return typeId;
+}
+
+// Look up a record's behaviour, once per distinct behaviour name
+static EntityBehaviourId ResolveSnapshotBehaviour(const EntityManager* manager, SnapshotIdCache* cache,
+                                                  const char* strings, uint32_t stringsSize, uint32_t offset) {
+    EntityBehaviourId behaviourId;
+    if (FindCachedSnapshotId(cache, offset, &behaviourId)) return behaviourId;
+    const char* behaviour = SnapshotString(strings, stringsSize, offset);
+    behaviourId = behaviour != NULL ? FindEntityBehaviour(manager, behaviour) : ENTITY_BEHAVIOUR_NONE;
+    CacheSnapshotId(cache, offset, behaviourId);
+    return behaviourId;
+}
+
+// Insert a batch of loaded entities, destroying any the manager refused
+static size_t InsertSnapshotBatch(EntityManager* manager, Entity** batch, size_t count) {
+    size_t inserted = InsertReservedEntities(manager, batch, count);
+    for (size_t i = inserted; i < count; i++) {
+        DestroyEntity(batch[i]);
+    }
+    return inserted;
+}
+
+// Add the entities of a snapshot to the manager. Returns how many were added.
+// Types are interned and member lists, pools and indexes reserved in a
+// first pass over the records, so the second pass only copies and links.
+size_t LoadEntitySnapshot(EntityManager* manager, const char* filePath) {
+    if (manager == NULL || filePath == NULL) return 0;
+    if (manager->updating) {
+        printf("Warning: Entity snapshots cannot be loaded while entities are updating.\n");
+        return 0;
+    }
+    if (!IsHostLittleEndian()) {
+        printf("Error: Entity snapshots are only supported on little-endian hosts.\n");
+        return 0;
+    }
+
+    MappedFile file;
+    if (!MapFile(filePath, &file)) return 0;
+    const EntitySnapshotHeader* header = (const EntitySnapshotHeader*)file.data;
+    if (!ValidateSnapshot(&file, header)) {
+        UnmapFile(&file);
+        return 0;
+    }
+
+    const char* strings = (const char*)file.data + header->stringsOffset;
+    const unsigned char* recordData = file.data + header->recordsOffset;
+    SnapshotIdCache types = {0};
+    SnapshotIdCache behaviours = {0};
+    size_t typeCounts[MAX_ENTITY_TYPES] = {0};
+    size_t behaviourCounts[MAX_ENTITY_BEHAVIOURS + 1] = {0};
+    size_t spriteCount = 0;
+    for (uint32_t i = 0; i < header->entityCount; i++) {
+        const EntitySnapshotRecord* record = (const EntitySnapshotRecord*)(recordData + (size_t)i * header->recordSize);
+        EntityTypeId typeId = ResolveSnapshotType(manager, &types, strings, header->stringsSize, record->type);
+        if (typeId != ENTITY_TYPE_NONE) typeCounts[typeId]++;
+        behaviourCounts[ResolveSnapshotBehaviour(manager, &behaviours, strings, header->stringsSize, record->behaviour)]++;
+        if (record->flags & ENTITY_SNAPSHOT_HAS_SPRITE) spriteCount++;
+    }
+    if (!ReserveEntityInsertion(manager, header->entityCount, spriteCount, typeCounts, behaviourCounts)) {
+        UnmapFile(&file);
+        return 0;
+    }
+
+    uint32_t texturePath = ENTITY_SNAPSHOT_NO_STRING;
+    int textureHandle = ASSET_TEXTURE_NONE;
+    int atlasEntry = TEXTURE_ATLAS_ENTRY_NONE;
+    Entity* batch[SNAPSHOT_READ_BATCH];
+    size_t batchCount = 0;
+    size_t loaded = 0;
+
+    for (uint32_t i = 0; i < header->entityCount; i++) {
+        const EntitySnapshotRecord* record = (const EntitySnapshotRecord*)(recordData + (size_t)i * header->recordSize);
+        Entity* entity = CreateEntity();
+        if (entity == NULL) break;
+
+        entity->id = record->id;
+        const char* name = SnapshotString(strings, header->stringsSize, record->name);
+        if (name != NULL) {
+            strncpy(entity->name, name, MAX_ENTITY_NAME_LENGTH - 1);
+        }
+        entity->nameHash = record->nameHash;
+        entity->typeId = ResolveSnapshotType(manager, &types, strings, header->stringsSize, record->type);
+        entity->entityType = entity->typeId != ENTITY_TYPE_NONE ? manager->types[entity->typeId].name : NULL;
+        entity->behaviourId = ResolveSnapshotBehaviour(manager, &behaviours, strings, header->stringsSize, record->behaviour);
+        entity->isActive = (record->flags & ENTITY_SNAPSHOT_ACTIVE) != 0;
+        entity->position = (Vector2){ record->position[0], record->position[1] };
+        entity->width = record->size[0];
+        entity->height = record->size[1];
+        entity->hitbox = (Hitbox_t){ record->hitbox[0], record->hitbox[1], record->hitbox[2], record->hitbox[3] };
+        if (record->flags & ENTITY_SNAPSHOT_HAS_SPRITE) {
+            entity->sprite = ReadSnapshotSprite(record, strings, header->stringsSize, &texturePath, &textureHandle, &atlasEntry);
+        }
+
+        batch[batchCount++] = entity;
+        if (batchCount == SNAPSHOT_READ_BATCH) {
+            loaded += InsertSnapshotBatch(manager, batch, batchCount);
+            batchCount = 0;
+        }
+    }
+    loaded += InsertSnapshotBatch(manager, batch, batchCount);
+
+    UnmapFile(&file);
+    return loaded;
+}
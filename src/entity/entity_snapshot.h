@@ -0,0 +1,68 @@
+// =============================================================
+// Entity Snapshot header
+// =============================================================
+// Binary save/load for the entities of an EntityManager. A snapshot
+// is a header, an array of fixed-size records and a string table, all
+// little-endian. Loading maps the file and reads the records in place;
+// strings are stored as offsets into the table and resolved on load.
+#ifndef ENTITY_SNAPSHOT_H
+#define ENTITY_SNAPSHOT_H
+
+#include "entity_manager.h"
+
+// Format constants
+#define ENTITY_SNAPSHOT_MAGIC "RSES"
+#define ENTITY_SNAPSHOT_VERSION 2
+#define ENTITY_SNAPSHOT_NO_STRING UINT32_MAX
+
+// Record flags
+#define ENTITY_SNAPSHOT_ACTIVE     (1u << 0)
+#define ENTITY_SNAPSHOT_HAS_SPRITE (1u << 1)
+#define ENTITY_SNAPSHOT_VISIBLE    (1u << 2)
+#define ENTITY_SNAPSHOT_ANIMATING  (1u << 3)
+
+// File header. Offsets are from the start of the file.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;    // Stride of the record array; newer versions may append fields
+    uint32_t entityCount;
+    uint32_t recordsOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+} EntitySnapshotHeader;
+
+// One entity, its hitbox and its sprite. String fields are offsets into
+// the string table, or ENTITY_SNAPSHOT_NO_STRING.
+typedef struct {
+    int32_t id;
+    uint32_t flags;
+    uint32_t name;
+    uint32_t type;
+    uint32_t behaviour;
+    float position[2];
+    float size[2];
+    int32_t hitbox[4];
+
+    int32_t spriteId;
+    uint32_t spriteName;
+    uint32_t texturePath;   // Only shared (AssetManager) textures are saved
+    int32_t spriteType;
+    float spritePosition[2];
+    float spriteScale[2];
+    float spriteOrigin[2];
+    float spriteRotation;
+    float frameTime;
+    int32_t currentFrame;
+    int32_t totalFrames;
+    uint8_t tint[4];
+
+    uint32_t nameHash;      // HashEntityName(name), so loading does not rehash
+} EntitySnapshotRecord;
+
+// Snapshot functions
+bool SaveEntitySnapshot(EntityManager* manager, const char* filePath);
+size_t LoadEntitySnapshot(EntityManager* manager, const char* filePath);
+
+#endif // ENTITY_SNAPSHOT_H
@@ -0,0 +1,245 @@
+// =============================================================
+// Entity Spatial Grid implementation
+// =============================================================
+// Uniform grid broadphase for entity hitboxes.
+#include "entity_spatial.h"
+#include <math.h>
+#include <string.h>
+
+// Cell coordinate range covered by a rectangle
+typedef struct {
+    int32_t x0, y0, x1, y1;
+} CellRange;
+
+static CellRange GetCellRange(const EntitySpatialGrid* grid, Rectangle bounds) {
+    return (CellRange){
+        (int32_t)floorf(bounds.x * grid->inverseCellSize),
+        (int32_t)floorf(bounds.y * grid->inverseCellSize),
+        (int32_t)floorf((bounds.x + bounds.width) * grid->inverseCellSize),
+        (int32_t)floorf((bounds.y + bounds.height) * grid->inverseCellSize)
+    };
+}
+
+static bool IsOversized(CellRange range) {
+    return range.x1 - range.x0 >= ENTITY_GRID_MAX_CELL_SPAN || range.y1 - range.y0 >= ENTITY_GRID_MAX_CELL_SPAN;
+}
+
+static uint32_t HashCell(int32_t x, int32_t y, uint32_t mask) {
+    return (((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u)) & mask;
+}
+
+// Rows with negative width are left out of the grid
+static bool IsRowIncluded(const EntitySpatialGrid* grid, size_t row) {
+    return grid->bounds[row].width >= 0.0f;
+}
+
+static bool Overlaps(Rectangle a, Rectangle b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+           a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Grow an array to hold at least count elements
+static bool GrowArray(void** array, size_t* capacity, size_t count, size_t elementSize) {
+    if (count <= *capacity) return true;
+    size_t newCapacity = *capacity ? *capacity : 256;
+    while (newCapacity < count) newCapacity *= 2;
+    void* grown = realloc(*array, newCapacity * elementSize);
+    if (grown == NULL) {
+        printf("Error: Memory allocation for entity spatial grid failed.\n");
+        return false;
+    }
+    *array = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+// Initialize an empty grid
+void InitEntitySpatialGrid(EntitySpatialGrid* grid, float cellSize) {
+    if (grid == NULL) return;
+    memset(grid, 0, sizeof(EntitySpatialGrid));
+    grid->cellSize = cellSize > 0.0f ? cellSize : ENTITY_GRID_DEFAULT_CELL_SIZE;
+    grid->inverseCellSize = 1.0f / grid->cellSize;
+}
+
+// Make room for per-row bounds. Call before filling grid->bounds.
+bool ReserveEntitySpatialGrid(EntitySpatialGrid* grid, size_t rowCount) {
+    if (grid == NULL) return false;
+    if (rowCount <= grid->rowCapacity) return true;
+    size_t capacity = grid->rowCapacity;
+    size_t stampCapacity = grid->rowCapacity;
+    size_t oversizedCapacity = grid->rowCapacity;
+    if (!GrowArray((void**)&grid->bounds, &capacity, rowCount, sizeof(Rectangle))) return false;
+    if (!GrowArray((void**)&grid->queryStamp, &stampCapacity, rowCount, sizeof(uint32_t))) return false;
+    if (!GrowArray((void**)&grid->oversized, &oversizedCapacity, rowCount, sizeof(uint32_t))) return false;
+    // New stamps must not match the current query stamp
+    memset(grid->queryStamp + grid->rowCapacity, 0, (capacity - grid->rowCapacity) * sizeof(uint32_t));
+    grid->rowCapacity = capacity;
+    return true;
+}
+
+// Rebuild the cell buckets from grid->bounds[0 .. rowCount)
+void BuildEntitySpatialGrid(EntitySpatialGrid* grid, size_t rowCount) {
+    if (grid == NULL || rowCount > grid->rowCapacity) return;
+    grid->rowCount = rowCount;
+    grid->oversizedCount = 0;
+
+    // Count cell entries to size the bucket table
+    size_t entryCount = 0;
+    for (size_t row = 0; row < rowCount; row++) {
+        if (!IsRowIncluded(grid, row)) continue;
+        CellRange range = GetCellRange(grid, grid->bounds[row]);
+        if (IsOversized(range)) {
+            grid->oversized[grid->oversizedCount++] = (uint32_t)row;
+            continue;
+        }
+        entryCount += (size_t)(range.x1 - range.x0 + 1) * (size_t)(range.y1 - range.y0 + 1);
+    }
+
+    uint32_t bucketCount = 64;
+    while (bucketCount < entryCount) bucketCount *= 2;
+    if (bucketCount != grid->bucketCount || grid->bucketStart == NULL) {
+        uint32_t* bucketStart = (uint32_t*)realloc(grid->bucketStart, (bucketCount + 1) * sizeof(uint32_t));
+        if (bucketStart == NULL) {
+            printf("Error: Memory allocation for entity spatial grid failed.\n");
+            return;
+        }
+        grid->bucketStart = bucketStart;
+        grid->bucketCount = bucketCount;
+    }
+    if (!GrowArray((void**)&grid->entries, &grid->entryCapacity, entryCount, sizeof(EntityGridEntry))) return;
+    uint32_t mask = bucketCount - 1;
+
+    // Counting sort: histogram, prefix sum, scatter
+    memset(grid->bucketStart, 0, (bucketCount + 1) * sizeof(uint32_t));
+    for (size_t row = 0; row < rowCount; row++) {
+        if (!IsRowIncluded(grid, row)) continue;
+        CellRange range = GetCellRange(grid, grid->bounds[row]);
+        if (IsOversized(range)) continue;
+        for (int32_t y = range.y0; y <= range.y1; y++) {
+            for (int32_t x = range.x0; x <= range.x1; x++) {
+                grid->bucketStart[HashCell(x, y, mask) + 1]++;
+            }
+        }
+    }
+    for (uint32_t b = 0; b < bucketCount; b++) {
+        grid->bucketStart[b + 1] += grid->bucketStart[b];
+    }
+    for (size_t row = 0; row < rowCount; row++) {
+        if (!IsRowIncluded(grid, row)) continue;
+        CellRange range = GetCellRange(grid, grid->bounds[row]);
+        if (IsOversized(range)) continue;
+        for (int32_t y = range.y0; y <= range.y1; y++) {
+            for (int32_t x = range.x0; x <= range.x1; x++) {
+                // bucketStart[b] is used as the write cursor, then shifted back below
+                uint32_t* cursor = &grid->bucketStart[HashCell(x, y, mask)];
+                grid->entries[(*cursor)++] = (EntityGridEntry){ (uint32_t)row, x, y };
+            }
+        }
+    }
+    memmove(grid->bucketStart + 1, grid->bucketStart, bucketCount * sizeof(uint32_t));
+    grid->bucketStart[0] = 0;
+    grid->entryCount = entryCount;
+}
+
+// Collect the rows whose bounds overlap an area. Returns the number of
+// matches, which may exceed maxRows; only maxRows are written.
+size_t QueryEntitySpatialGrid(EntitySpatialGrid* grid, Rectangle area, uint32_t* outRows, size_t maxRows) {
+    if (grid == NULL || grid->bucketStart == NULL) return 0;
+    if (++grid->stamp == 0) {
+        memset(grid->queryStamp, 0, grid->rowCapacity * sizeof(uint32_t));
+        grid->stamp = 1;
+    }
+
+    size_t found = 0;
+    CellRange range = GetCellRange(grid, area);
+    size_t cellCount = (size_t)(range.x1 - range.x0 + 1) * (size_t)(range.y1 - range.y0 + 1);
+    if (cellCount > grid->rowCount) {
+        // Area covers more cells than there are rows: a plain scan is cheaper
+        for (size_t row = 0; row < grid->rowCount; row++) {
+            if (IsRowIncluded(grid, row) && Overlaps(grid->bounds[row], area)) {
+                if (found < maxRows) outRows[found] = (uint32_t)row;
+                found++;
+            }
+        }
+        return found;
+    }
+
+    uint32_t mask = grid->bucketCount - 1;
+    for (int32_t y = range.y0; y <= range.y1; y++) {
+        for (int32_t x = range.x0; x <= range.x1; x++) {
+            uint32_t bucket = HashCell(x, y, mask);
+            for (uint32_t i = grid->bucketStart[bucket]; i < grid->bucketStart[bucket + 1]; i++) {
+                const EntityGridEntry* entry = &grid->entries[i];
+                if (entry->cellX != x || entry->cellY != y) continue;
+                if (grid->queryStamp[entry->row] == grid->stamp) continue;
+                grid->queryStamp[entry->row] = grid->stamp;
+                if (Overlaps(grid->bounds[entry->row], area)) {
+                    if (found < maxRows) outRows[found] = entry->row;
+                    found++;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < grid->oversizedCount; i++) {
+        uint32_t row = grid->oversized[i];
+        if (Overlaps(grid->bounds[row], area)) {
+            if (found < maxRows) outRows[found] = row;
+            found++;
+        }
+    }
+    return found;
+}
+
+// Emit every pair of overlapping bounds exactly once. A pair sharing
+// several cells is only reported from the cell holding the top-left
+// corner of the overlap. Returns the number of pairs found; only
+// maxPairs are written.
+size_t FindEntitySpatialGridPairs(const EntitySpatialGrid* grid, EntityGridPair* outPairs, size_t maxPairs) {
+    if (grid == NULL || grid->bucketStart == NULL) return 0;
+    size_t found = 0;
+
+    for (uint32_t bucket = 0; bucket < grid->bucketCount; bucket++) {
+        uint32_t end = grid->bucketStart[bucket + 1];
+        for (uint32_t i = grid->bucketStart[bucket]; i < end; i++) {
+            const EntityGridEntry* a = &grid->entries[i];
+            Rectangle boundsA = grid->bounds[a->row];
+            for (uint32_t j = i + 1; j < end; j++) {
+                const EntityGridEntry* b = &grid->entries[j];
+                if (b->cellX != a->cellX || b->cellY != a->cellY) continue;
+                Rectangle boundsB = grid->bounds[b->row];
+                if (!Overlaps(boundsA, boundsB)) continue;
+                Vector2 corner = { fmaxf(boundsA.x, boundsB.x), fmaxf(boundsA.y, boundsB.y) };
+                if ((int32_t)floorf(corner.x * grid->inverseCellSize) != a->cellX ||
+                    (int32_t)floorf(corner.y * grid->inverseCellSize) != a->cellY) continue;
+                if (found < maxPairs) outPairs[found] = (EntityGridPair){ a->row, b->row };
+                found++;
+            }
+        }
+    }
+
+    // Oversized rows are tested against everything else directly
+    for (size_t i = 0; i < grid->oversizedCount; i++) {
+        uint32_t big = grid->oversized[i];
+        for (size_t row = 0; row < grid->rowCount; row++) {
+            if (row == big || !IsRowIncluded(grid, row)) continue;
+            // Oversized-oversized pairs are only reported once
+            if (IsOversized(GetCellRange(grid, grid->bounds[row])) && row < big) continue;
+            if (Overlaps(grid->bounds[big], grid->bounds[row])) {
+                if (found < maxPairs) outPairs[found] = (EntityGridPair){ big, (uint32_t)row };
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+// Release the grid's storage
+void FreeEntitySpatialGrid(EntitySpatialGrid* grid) {
+    if (grid == NULL) return;
+    free(grid->bounds);
+    free(grid->queryStamp);
+    free(grid->oversized);
+    free(grid->bucketStart);
+    free(grid->entries);
+    InitEntitySpatialGrid(grid, grid->cellSize);
+}
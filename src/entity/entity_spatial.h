@@ -0,0 +1,62 @@
+// =============================================================
+// Entity Spatial Grid header
+// =============================================================
+// Uniform grid for hitbox queries. Cells are hashed into a flat
+// table and rebuilt with a counting sort, so a rebuild is linear in
+// the number of entities and touches memory in order.
+#ifndef ENTITY_SPATIAL_H
+#define ENTITY_SPATIAL_H
+
+#include "raylib.h"
+#include "../util/globals.h"
+
+// Grid defaults
+#define ENTITY_GRID_DEFAULT_CELL_SIZE 64.0f
+#define ENTITY_GRID_MAX_CELL_SPAN 16  // Wider bounds go to the oversized list
+
+// One cell occupied by one row
+typedef struct {
+    uint32_t row;
+    int32_t cellX;
+    int32_t cellY;
+} EntityGridEntry;
+
+// Spatial grid structure. Rows index the EntityManager's dense array.
+typedef struct {
+    float cellSize;
+    float inverseCellSize;
+
+    // Per-row bounds captured at build time
+    Rectangle* bounds;
+    uint32_t* queryStamp;
+    size_t rowCount;
+    size_t rowCapacity;
+    uint32_t stamp;
+
+    // Hashed cell buckets: entries for bucket b are entries[bucketStart[b] .. bucketStart[b + 1]]
+    uint32_t* bucketStart;
+    uint32_t bucketCount;
+    EntityGridEntry* entries;
+    size_t entryCount;
+    size_t entryCapacity;
+
+    // Rows whose bounds span too many cells; checked by every query
+    uint32_t* oversized;
+    size_t oversizedCount;
+} EntitySpatialGrid;
+
+// Candidate collision pair (rows into the dense entity array)
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} EntityGridPair;
+
+// Grid functions
+void InitEntitySpatialGrid(EntitySpatialGrid* grid, float cellSize);
+bool ReserveEntitySpatialGrid(EntitySpatialGrid* grid, size_t rowCount);
+void BuildEntitySpatialGrid(EntitySpatialGrid* grid, size_t rowCount);
+size_t QueryEntitySpatialGrid(EntitySpatialGrid* grid, Rectangle area, uint32_t* outRows, size_t maxRows);
+size_t FindEntitySpatialGridPairs(const EntitySpatialGrid* grid, EntityGridPair* outPairs, size_t maxPairs);
+void FreeEntitySpatialGrid(EntitySpatialGrid* grid);
+
+#endif // ENTITY_SPATIAL_H
@@ -0,0 +1,308 @@
+// =============================================================
+// Entity Transform implementation
+// =============================================================
+// Transform hierarchy with cached world transforms.
+#include "entity_transform.h"
+#include <math.h>
+#include <string.h>
+
+// Order holes are compacted once they outnumber live nodes (and this)
+#define TRANSFORM_MIN_HOLES 64
+
+// Grow an array to hold at least count elements
+static bool GrowArray(void** array, size_t* capacity, size_t count, size_t elementSize) {
+    if (count <= *capacity) return true;
+    size_t newCapacity = *capacity ? *capacity : 64;
+    while (newCapacity < count) newCapacity *= 2;
+    void* grown = realloc(*array, newCapacity * elementSize);
+    if (grown == NULL) {
+        printf("Error: Memory allocation for entity transform hierarchy failed.\n");
+        return false;
+    }
+    *array = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static bool IsNodeLive(const EntityTransformHierarchy* hierarchy, uint32_t node) {
+    return node != ENTITY_TRANSFORM_NONE && node < hierarchy->nodeCount && hierarchy->nodes[node].live;
+}
+
+// Grow the order arrays to hold at least count entries
+static bool ReserveTransformOrder(EntityTransformHierarchy* hierarchy, size_t count) {
+    size_t orderCapacity = hierarchy->orderCapacity;
+    size_t sizesCapacity = hierarchy->orderCapacity;
+    if (!GrowArray((void**)&hierarchy->order, &orderCapacity, count, sizeof(uint32_t))) return false;
+    if (!GrowArray((void**)&hierarchy->subtreeSizes, &sizesCapacity, count, sizeof(uint32_t))) return false;
+    hierarchy->orderCapacity = orderCapacity;
+    return true;
+}
+
+// Queue a node for the next update
+static void MarkNodeDirty(EntityTransformHierarchy* hierarchy, uint32_t node) {
+    EntityTransformNode* entry = &hierarchy->nodes[node];
+    if (entry->dirty) return;
+    if (!GrowArray((void**)&hierarchy->dirtyNodes, &hierarchy->dirtyCapacity, hierarchy->dirtyCount + 1, sizeof(uint32_t))) {
+        // Without room in the dirty list, fall back to a full update
+        hierarchy->orderDirty = true;
+        return;
+    }
+    hierarchy->dirtyNodes[hierarchy->dirtyCount++] = node;
+    entry->dirty = true;
+}
+
+// Take a node out of its parent's child list
+static void UnlinkNode(EntityTransformHierarchy* hierarchy, uint32_t node) {
+    EntityTransformNode* entry = &hierarchy->nodes[node];
+    if (entry->prevSibling != ENTITY_TRANSFORM_NONE) {
+        hierarchy->nodes[entry->prevSibling].nextSibling = entry->nextSibling;
+    } else if (entry->parent != ENTITY_TRANSFORM_NONE) {
+        hierarchy->nodes[entry->parent].firstChild = entry->nextSibling;
+    }
+    if (entry->nextSibling != ENTITY_TRANSFORM_NONE) {
+        hierarchy->nodes[entry->nextSibling].prevSibling = entry->prevSibling;
+    }
+    entry->parent = ENTITY_TRANSFORM_NONE;
+    entry->prevSibling = ENTITY_TRANSFORM_NONE;
+    entry->nextSibling = ENTITY_TRANSFORM_NONE;
+}
+
+// Make a node the first child of a parent (or a root)
+static void LinkNode(EntityTransformHierarchy* hierarchy, uint32_t node, uint32_t parent) {
+    EntityTransformNode* entry = &hierarchy->nodes[node];
+    entry->parent = parent;
+    if (parent == ENTITY_TRANSFORM_NONE) return;
+    entry->nextSibling = hierarchy->nodes[parent].firstChild;
+    if (entry->nextSibling != ENTITY_TRANSFORM_NONE) {
+        hierarchy->nodes[entry->nextSibling].prevSibling = node;
+    }
+    hierarchy->nodes[parent].firstChild = node;
+}
+
+// Rebuild the depth-first order from the child lists
+static bool RebuildTransformOrder(EntityTransformHierarchy* hierarchy) {
+    if (!ReserveTransformOrder(hierarchy, hierarchy->liveCount)) return false;
+    // Subtree sizes are filled in after the walk, so their storage
+    // doubles as the walk's stack
+    uint32_t* stack = hierarchy->subtreeSizes;
+    size_t count = 0;
+    for (uint32_t root = 1; root < hierarchy->nodeCount; root++) {
+        if (!hierarchy->nodes[root].live || hierarchy->nodes[root].parent != ENTITY_TRANSFORM_NONE) continue;
+        size_t top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            uint32_t node = stack[--top];
+            hierarchy->nodes[node].order = (uint32_t)count;
+            hierarchy->order[count++] = node;
+            for (uint32_t child = hierarchy->nodes[node].firstChild; child != ENTITY_TRANSFORM_NONE;
+                 child = hierarchy->nodes[child].nextSibling) {
+                stack[top++] = child;
+            }
+        }
+    }
+
+    // Children follow their parents, so a backwards pass sums subtree sizes
+    for (size_t i = 0; i < count; i++) {
+        hierarchy->subtreeSizes[i] = 1;
+    }
+    for (size_t i = count; i-- > 0;) {
+        uint32_t parent = hierarchy->nodes[hierarchy->order[i]].parent;
+        if (parent != ENTITY_TRANSFORM_NONE) {
+            hierarchy->subtreeSizes[hierarchy->nodes[parent].order] += hierarchy->subtreeSizes[i];
+        }
+    }
+    hierarchy->orderCount = count;
+    hierarchy->orderDirty = false;
+    return true;
+}
+
+// Recompute world transforms for order[first .. end), skipping holes
+static void RecomputeTransformRange(EntityTransformHierarchy* hierarchy, size_t first, size_t end) {
+    for (size_t i = first; i < end; i++) {
+        uint32_t node = hierarchy->order[i];
+        if (node == ENTITY_TRANSFORM_NONE) continue;
+        EntityTransformNode* entry = &hierarchy->nodes[node];
+        entry->world = entry->parent == ENTITY_TRANSFORM_NONE
+            ? entry->local
+            : CombineEntityTransforms(hierarchy->nodes[entry->parent].world, entry->local);
+        hierarchy->changed[hierarchy->changedCount++] = node;
+    }
+}
+
+static int CompareOrder(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*)a;
+    uint32_t right = *(const uint32_t*)b;
+    return (left > right) - (left < right);
+}
+
+// Apply a parent transform to a local one
+EntityTransform CombineEntityTransforms(EntityTransform parent, EntityTransform local) {
+    float radians = parent.rotation * DEG2RAD;
+    float c = cosf(radians);
+    float s = sinf(radians);
+    Vector2 scaled = { local.position.x * parent.scale.x, local.position.y * parent.scale.y };
+    return (EntityTransform){
+        { parent.position.x + scaled.x * c - scaled.y * s, parent.position.y + scaled.x * s + scaled.y * c },
+        parent.rotation + local.rotation,
+        { parent.scale.x * local.scale.x, parent.scale.y * local.scale.y }
+    };
+}
+
+// Initialize an empty hierarchy
+void InitEntityTransformHierarchy(EntityTransformHierarchy* hierarchy) {
+    if (hierarchy == NULL) return;
+    memset(hierarchy, 0, sizeof(EntityTransformHierarchy));
+}
+
+// Add a root node. Its world transform starts out equal to local.
+uint32_t AddEntityTransformNode(EntityTransformHierarchy* hierarchy, uint32_t owner, EntityTransform local) {
+    if (hierarchy == NULL) return ENTITY_TRANSFORM_NONE;
+    uint32_t node = hierarchy->freeNode;
+    if (node != ENTITY_TRANSFORM_NONE) {
+        hierarchy->freeNode = hierarchy->nodes[node].nextSibling;
+    } else {
+        // Node 0 is reserved, so the first node handed out is 1
+        size_t count = hierarchy->nodeCount ? hierarchy->nodeCount + 1 : 2;
+        if (count > UINT32_MAX ||
+            !GrowArray((void**)&hierarchy->nodes, &hierarchy->nodeCapacity, count, sizeof(EntityTransformNode))) {
+            return ENTITY_TRANSFORM_NONE;
+        }
+        if (hierarchy->nodeCount == 0) {
+            hierarchy->nodes[0] = (EntityTransformNode){0};
+            hierarchy->nodeCount = 1;
+        }
+        node = (uint32_t)hierarchy->nodeCount++;
+    }
+
+    hierarchy->nodes[node] = (EntityTransformNode){ .local = local, .world = local, .owner = owner, .live = true };
+    hierarchy->liveCount++;
+    // A new root can go at the end of the order without a rebuild
+    if (!hierarchy->orderDirty) {
+        if (ReserveTransformOrder(hierarchy, hierarchy->orderCount + 1)) {
+            hierarchy->nodes[node].order = (uint32_t)hierarchy->orderCount;
+            hierarchy->order[hierarchy->orderCount] = node;
+            hierarchy->subtreeSizes[hierarchy->orderCount++] = 1;
+        } else {
+            hierarchy->orderDirty = true;
+        }
+    }
+    MarkNodeDirty(hierarchy, node);
+    return node;
+}
+
+// Remove a node. Its children become roots and keep their current world
+// transform. The node's place in the order is left as a hole until enough
+// holes build up to be worth a rebuild.
+void RemoveEntityTransformNode(EntityTransformHierarchy* hierarchy, uint32_t node) {
+    if (hierarchy == NULL || !IsNodeLive(hierarchy, node)) return;
+    EntityTransformNode* entry = &hierarchy->nodes[node];
+    uint32_t child = entry->firstChild;
+    while (child != ENTITY_TRANSFORM_NONE) {
+        EntityTransformNode* childEntry = &hierarchy->nodes[child];
+        uint32_t next = childEntry->nextSibling;
+        childEntry->parent = ENTITY_TRANSFORM_NONE;
+        childEntry->prevSibling = ENTITY_TRANSFORM_NONE;
+        childEntry->nextSibling = ENTITY_TRANSFORM_NONE;
+        childEntry->local = childEntry->world;
+        MarkNodeDirty(hierarchy, child);
+        child = next;
+    }
+    entry->firstChild = ENTITY_TRANSFORM_NONE;
+    UnlinkNode(hierarchy, node);
+
+    // Children left in the removed node's range are still after any
+    // parent they could have, so the order stays valid with a hole
+    if (!hierarchy->orderDirty) {
+        hierarchy->order[entry->order] = ENTITY_TRANSFORM_NONE;
+    }
+    entry->live = false;
+    entry->dirty = false;
+    entry->nextSibling = hierarchy->freeNode;
+    hierarchy->freeNode = node;
+    hierarchy->liveCount--;
+
+    size_t holes = hierarchy->orderCount - hierarchy->liveCount;
+    if (holes > TRANSFORM_MIN_HOLES && holes > hierarchy->liveCount) {
+        hierarchy->orderDirty = true;
+    }
+}
+
+// Move a node (and its subtree) under a new parent, or make it a root.
+// The local transform is kept, so the node follows its new parent.
+bool SetEntityTransformParent(EntityTransformHierarchy* hierarchy, uint32_t node, uint32_t parent) {
+    if (hierarchy == NULL || !IsNodeLive(hierarchy, node)) return false;
+    if (parent != ENTITY_TRANSFORM_NONE && !IsNodeLive(hierarchy, parent)) return false;
+    if (hierarchy->nodes[node].parent == parent) return true;
+    for (uint32_t ancestor = parent; ancestor != ENTITY_TRANSFORM_NONE; ancestor = hierarchy->nodes[ancestor].parent) {
+        if (ancestor == node) {
+            printf("Warning: Entity transform parent would create a cycle.\n");
+            return false;
+        }
+    }
+    UnlinkNode(hierarchy, node);
+    LinkNode(hierarchy, node, parent);
+    hierarchy->orderDirty = true;
+    MarkNodeDirty(hierarchy, node);
+    return true;
+}
+
+// Change a node's local transform. Its subtree is recomputed on the next update.
+void SetEntityTransformLocal(EntityTransformHierarchy* hierarchy, uint32_t node, EntityTransform local) {
+    if (hierarchy == NULL || !IsNodeLive(hierarchy, node)) return;
+    hierarchy->nodes[node].local = local;
+    MarkNodeDirty(hierarchy, node);
+}
+
+// Recompute the world transforms under every dirty node and list the
+// nodes that were recomputed in hierarchy->changed. Only dirty subtrees
+// are visited unless the order had to be rebuilt. Returns the number of
+// changed nodes.
+size_t UpdateEntityTransformHierarchy(EntityTransformHierarchy* hierarchy) {
+    if (hierarchy == NULL) return 0;
+    hierarchy->changedCount = 0;
+    if (!GrowArray((void**)&hierarchy->changed, &hierarchy->changedCapacity, hierarchy->liveCount, sizeof(uint32_t))) {
+        return 0;
+    }
+
+    if (hierarchy->orderDirty) {
+        if (!RebuildTransformOrder(hierarchy)) return 0;
+        for (size_t i = 0; i < hierarchy->dirtyCount; i++) {
+            hierarchy->nodes[hierarchy->dirtyNodes[i]].dirty = false;
+        }
+        hierarchy->dirtyCount = 0;
+        RecomputeTransformRange(hierarchy, 0, hierarchy->orderCount);
+        return hierarchy->changedCount;
+    }
+
+    // Turn dirty nodes into order positions. Sorted, a subtree root comes
+    // before anything inside its range, which is then skipped.
+    size_t count = 0;
+    for (size_t i = 0; i < hierarchy->dirtyCount; i++) {
+        EntityTransformNode* entry = &hierarchy->nodes[hierarchy->dirtyNodes[i]];
+        if (!entry->live || !entry->dirty) continue;
+        entry->dirty = false;
+        hierarchy->dirtyNodes[count++] = entry->order;
+    }
+    hierarchy->dirtyCount = 0;
+    if (count > 1) qsort(hierarchy->dirtyNodes, count, sizeof(uint32_t), CompareOrder);
+
+    size_t coveredEnd = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t first = hierarchy->dirtyNodes[i];
+        if (first < coveredEnd) continue;
+        coveredEnd = first + hierarchy->subtreeSizes[first];
+        RecomputeTransformRange(hierarchy, first, coveredEnd);
+    }
+    return hierarchy->changedCount;
+}
+
+// Release the hierarchy's storage
+void FreeEntityTransformHierarchy(EntityTransformHierarchy* hierarchy) {
+    if (hierarchy == NULL) return;
+    free(hierarchy->nodes);
+    free(hierarchy->order);
+    free(hierarchy->subtreeSizes);
+    free(hierarchy->dirtyNodes);
+    free(hierarchy->changed);
+    InitEntityTransformHierarchy(hierarchy);
+}
@@ -0,0 +1,77 @@
+// =============================================================
+// Entity Transform header
+// =============================================================
+// Optional parent/child hierarchy of 2D transforms. Each node keeps a
+// local transform relative to its parent; world transforms are cached
+// and only recomputed for the subtrees under nodes that changed.
+#ifndef ENTITY_TRANSFORM_H
+#define ENTITY_TRANSFORM_H
+
+#include "raylib.h"
+#include "../util/globals.h"
+
+// Node 0 is never handed out, so zero-initialised fields mean "no node"
+#define ENTITY_TRANSFORM_NONE 0
+
+// Position, rotation (in degrees, as for sprites) and scale
+typedef struct {
+    Vector2 position;
+    float rotation;
+    Vector2 scale;
+} EntityTransform;
+
+#define ENTITY_TRANSFORM_IDENTITY ((EntityTransform){ { 0.0f, 0.0f }, 0.0f, { 1.0f, 1.0f } })
+
+// Hierarchy node. Children are linked through their siblings.
+typedef struct {
+    EntityTransform local;
+    EntityTransform world;
+    uint32_t owner;        // Caller data; the EntityManager stores the entity slot
+    uint32_t parent;
+    uint32_t firstChild;
+    uint32_t nextSibling;  // Next free node while the node is unused
+    uint32_t prevSibling;
+    uint32_t order;        // Position in the depth-first order
+    bool dirty;            // Queued in the dirty list
+    bool live;
+} EntityTransformNode;
+
+// Transform hierarchy. Node IDs are stable; the depth-first order is
+// rebuilt lazily after parents change.
+typedef struct {
+    EntityTransformNode* nodes;
+    size_t nodeCount;             // Node IDs handed out so far, including 0
+    size_t nodeCapacity;
+    size_t liveCount;
+    uint32_t freeNode;
+
+    // Depth-first order. The subtree of order[i] is order[i .. i + subtreeSizes[i]),
+    // so parents always come before their children.
+    uint32_t* order;
+    uint32_t* subtreeSizes;
+    size_t orderCount;            // Entries in order, including holes left by removed nodes
+    size_t orderCapacity;
+    bool orderDirty;
+
+    // Nodes whose local transform changed since the last update
+    uint32_t* dirtyNodes;
+    size_t dirtyCount;
+    size_t dirtyCapacity;
+
+    // Nodes whose world transform the last update recomputed
+    uint32_t* changed;
+    size_t changedCount;
+    size_t changedCapacity;
+} EntityTransformHierarchy;
+
+// Transform functions
+EntityTransform CombineEntityTransforms(EntityTransform parent, EntityTransform local);
+void InitEntityTransformHierarchy(EntityTransformHierarchy* hierarchy);
+uint32_t AddEntityTransformNode(EntityTransformHierarchy* hierarchy, uint32_t owner, EntityTransform local);
+void RemoveEntityTransformNode(EntityTransformHierarchy* hierarchy, uint32_t node);
+bool SetEntityTransformParent(EntityTransformHierarchy* hierarchy, uint32_t node, uint32_t parent);
+void SetEntityTransformLocal(EntityTransformHierarchy* hierarchy, uint32_t node, EntityTransform local);
+size_t UpdateEntityTransformHierarchy(EntityTransformHierarchy* hierarchy);
+void FreeEntityTransformHierarchy(EntityTransformHierarchy* hierarchy);
+
+#endif // ENTITY_TRANSFORM_H
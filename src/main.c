@@ -14,6 +14,11 @@
 // Framework includes
 #include "util/globals.h"
 #include "util/asset_manager.h"
+#include "sprite/sprite_batch.h"
+#include "sprite/texture_atlas.h"
+#include "sprite/spritesheet.h"
+#include "sprite/animation_clip.h"
+#include "sprite/baked_animation.h"
 #include "2d/handler2d.h"
 #include "world/screen_manager.h"
 #include "world/screen_state.h"
@@ -115,6 +120,16 @@ bool InitializeGame(void) {
     // Initialize asset manager
     InitAssetManager();
     
+    // Use the packed texture atlas if one has been built (make atlas)
+    if (FileExists(TEXTURE_ATLAS_MANIFEST_PATH)) {
+        LoadTextureAtlas(&g_textureAtlas, TEXTURE_ATLAS_MANIFEST_PATH);
+    }
+    
+    // Register baked clips if they have been built (make anim)
+    if (FileExists(BAKED_ANIMATION_PATH)) {
+        LoadBakedAnimations(&g_bakedAnimations, BAKED_ANIMATION_PATH);
+    }
+    
     // Load fonts
     printf("Loading fonts...\n");
     geetRegular = LoadFont("res/font/geet.regular.ttf");
@@ -219,8 +234,17 @@ void ShutdownGame(void) {
     // Shutdown screen manager
     UnloadScreenManager(&g_screenManager);
     
+    // Release clips and spritesheets before the textures they hold
+    UnloadAnimationClips();
+    UnloadBakedAnimations(&g_bakedAnimations);
+    UnloadSpritesheets();
+    
     // Shutdown asset manager
     UnloadAssetManager();
+
+    // Release sprite batch storage and the atlas manifest
+    FreeSpriteBatch(&g_spriteBatch);
+    UnloadTextureAtlas(&g_textureAtlas);
     
     // Stop and unload music
     if (g_backgroundMusic.stream.buffer != NULL) {
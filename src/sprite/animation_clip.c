@@ -0,0 +1,228 @@
+// =============================================================
+// Animation clip source
+// =============================================================
+// Clip registry backed by an open-addressing hash table. Only
+// LoadAnimationClip can load from disk, and only the first time a
+// texture is seen; every later lookup and playback uses shared data.
+#include "animation_clip.h"
+#include "../util/hash_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+AnimationClipLibrary g_animationClips = {0};
+
+// Slot holding the clip, or the empty slot it would go in
+static int FindClipSlot(const char* name, uint32_t hash) {
+    uint32_t mask = ANIMATION_CLIP_SLOTS - 1;
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        int clip = g_animationClips.slots[i] - 1;
+        if (clip == ANIMATION_CLIP_NONE) return (int)i;
+        const AnimationClip* entry = &g_animationClips.clips[clip];
+        if (entry->nameHash == hash && strcmp(entry->name, name) == 0) return (int)i;
+    }
+}
+
+// Add a clip once its name, sheet and timing check out. Without a frame
+// table one is generated for the run; a table passed in is referenced,
+// not copied, and must outlive the clip.
+static int InsertAnimationClip(const char* name, int spritesheet, int firstFrame, int frameCount, float frameTime, AnimationSequenceType type,
+                               const AnimationFrame* frames, const AnimationEventMarker* events, int eventCount) {
+    if (name == NULL) return ANIMATION_CLIP_NONE;
+    if (strlen(name) >= MAX_ANIMATION_NAME_LENGTH) {
+        printf("Error: Animation clip name %s is too long.\n", name);
+        return ANIMATION_CLIP_NONE;
+    }
+    uint32_t hash = HashString(name);
+    int slot = FindClipSlot(name, hash);
+    if (g_animationClips.slots[slot] != 0) return g_animationClips.slots[slot] - 1;
+
+    const Spritesheet* sheet = GetSpritesheet(spritesheet);
+    if (sheet == NULL) {
+        printf("Error: Animation clip %s has no spritesheet.\n", name);
+        return ANIMATION_CLIP_NONE;
+    }
+    if (frameCount <= 0) frameCount = sheet->frameCount - firstFrame;
+    if (firstFrame < 0 || frameCount <= 0 || firstFrame + frameCount > sheet->frameCount) {
+        printf("Error: Animation clip %s lies outside spritesheet %s.\n", name, sheet->name);
+        return ANIMATION_CLIP_NONE;
+    }
+    if (frameTime <= 0.0f) {
+        printf("Error: Animation clip %s needs a positive frame time.\n", name);
+        return ANIMATION_CLIP_NONE;
+    }
+    if (g_animationClips.count >= MAX_ANIMATION_CLIPS) {
+        printf("Error: Maximum animation clip limit reached.\n");
+        return ANIMATION_CLIP_NONE;
+    }
+    bool ownsTables = frames == NULL;
+    if (ownsTables) {
+        // Frames index the whole sheet, so animators can draw them directly
+        AnimationFrame* generated = (AnimationFrame*)malloc((size_t)frameCount * sizeof(AnimationFrame));
+        if (generated == NULL) {
+            printf("Error: Memory allocation for animation clip frames failed.\n");
+            return ANIMATION_CLIP_NONE;
+        }
+        for (int i = 0; i < frameCount; i++) {
+            generated[i] = (AnimationFrame){ firstFrame + i, frameTime };
+        }
+        frames = generated;
+    }
+
+    int clipId = g_animationClips.count++;
+    AnimationClip* clip = &g_animationClips.clips[clipId];
+    strcpy(clip->name, name);
+    clip->nameHash = hash;
+    clip->spritesheet = spritesheet;
+    clip->firstFrame = firstFrame;
+    clip->frameTime = frameTime;
+    clip->sequence = (AnimationSequence){ clip->name, type, frameCount, frames };
+    clip->events = events;
+    clip->eventCount = eventCount;
+    clip->ownsTables = ownsTables;
+    g_animationClips.slots[slot] = (int16_t)(clipId + 1);
+    return clipId;
+}
+
+// Register a run of frames on a loaded spritesheet under a name.
+// Registering an existing name returns the existing clip.
+int RegisterAnimationClip(const char* name, int spritesheet, int firstFrame, int frameCount, float frameTime, AnimationSequenceType type) {
+    return InsertAnimationClip(name, spritesheet, firstFrame, frameCount, frameTime, type, NULL, NULL, 0);
+}
+
+// Register a clip over frame and event tables the caller keeps alive,
+// such as baked animation data used in place. The frames must be a run
+// of sheet frames at one frame time and the events sorted by frame.
+int RegisterAnimationClipFrames(const char* name, int spritesheet, const AnimationFrame* frames, int frameCount,
+                                AnimationSequenceType type, const AnimationEventMarker* events, int eventCount) {
+    if (name == NULL || frames == NULL || frameCount <= 0 || (events == NULL && eventCount != 0) || eventCount < 0) {
+        return ANIMATION_CLIP_NONE;
+    }
+    // Animators and the animator store step clips as runs, so check the table is one
+    for (int i = 1; i < frameCount; i++) {
+        if (frames[i].frameIndex != frames[0].frameIndex + i || frames[i].duration != frames[0].duration) {
+            printf("Error: Animation clip %s frames are not a run at one frame time.\n", name);
+            return ANIMATION_CLIP_NONE;
+        }
+    }
+    for (int i = 0; i < eventCount; i++) {
+        if (events[i].frame < 0 || events[i].frame >= frameCount || (i > 0 && events[i].frame < events[i - 1].frame)) {
+            printf("Error: Animation clip %s has unsorted or out of range events.\n", name);
+            return ANIMATION_CLIP_NONE;
+        }
+    }
+    return InsertAnimationClip(name, spritesheet, frames[0].frameIndex, frameCount, frames[0].duration, type, frames, events, eventCount);
+}
+
+// Add an event marker to a clip's frame. Markers are meant to be set up
+// with the clip, before animators play it.
+bool AddAnimationClipEvent(int clip, int frame, int eventId) {
+    if (clip < 0 || clip >= g_animationClips.count) return false;
+    AnimationClip* entry = &g_animationClips.clips[clip];
+    if (!entry->ownsTables) {
+        printf("Error: Animation clip %s uses baked events and cannot be changed.\n", entry->name);
+        return false;
+    }
+    if (frame < 0 || frame >= entry->sequence.frameCount) {
+        printf("Error: Event frame %d is outside animation clip %s.\n", frame, entry->name);
+        return false;
+    }
+    AnimationEventMarker* grown = (AnimationEventMarker*)realloc((void*)entry->events, (size_t)(entry->eventCount + 1) * sizeof(AnimationEventMarker));
+    if (grown == NULL) {
+        printf("Error: Memory allocation for animation events failed.\n");
+        return false;
+    }
+    entry->events = grown;
+    // Keep markers sorted; markers on the same frame fire in the order added
+    int at = FindAnimationEventMarker(grown, entry->eventCount, frame + 1);
+    memmove(&grown[at + 1], &grown[at], (size_t)(entry->eventCount - at) * sizeof(AnimationEventMarker));
+    grown[at] = (AnimationEventMarker){ frame, eventId };
+    entry->eventCount++;
+    return true;
+}
+
+// True if a sheet's first frame has the given size
+static bool HasSpritesheetFrameSize(int sheet, int frameWidth, int frameHeight) {
+    const Spritesheet* entry = GetSpritesheet(sheet);
+    return entry != NULL && entry->frameCount > 0 && entry->frames[0].source.width == (float)frameWidth &&
+           entry->frames[0].source.height == (float)frameHeight;
+}
+
+// Register a clip over a grid texture. The texture's sheet is named after
+// the path, so the path must fit MAX_SPRITESHEET_NAME_LENGTH. The sheet is
+// created on first use and shared by every clip that names the same path
+// with the same frame size; other frame sizes on that path are refused.
+int LoadAnimationClip(const char* name, const char* texturePath, int frameWidth, int frameHeight, int frameCount, float frameTime, AnimationSequenceType type) {
+    if (name == NULL || texturePath == NULL) return ANIMATION_CLIP_NONE;
+    int existing = FindAnimationClip(name);
+    if (existing != ANIMATION_CLIP_NONE) return existing;
+    int sheet = FindSpritesheet(texturePath);
+    if (sheet == SPRITESHEET_NONE) {
+        sheet = CreateGridSpritesheet(texturePath, texturePath, frameWidth, frameHeight, 0, (Vector2){ 0.0f, 0.0f });
+        if (sheet == SPRITESHEET_NONE) return ANIMATION_CLIP_NONE;
+    } else if (!HasSpritesheetFrameSize(sheet, frameWidth, frameHeight)) {
+        printf("Error: Animation clip %s wants %dx%d frames, but %s is already cut into other frames.\n",
+               name, frameWidth, frameHeight, texturePath);
+        return ANIMATION_CLIP_NONE;
+    }
+    return RegisterAnimationClip(name, sheet, 0, frameCount, frameTime, type);
+}
+
+// Clip ID for a name. Callers that play a clip often should keep the ID.
+int FindAnimationClip(const char* name) {
+    if (name == NULL) return ANIMATION_CLIP_NONE;
+    return g_animationClips.slots[FindClipSlot(name, HashString(name))] - 1;
+}
+
+const AnimationClip* GetAnimationClip(int clip) {
+    if (clip < 0 || clip >= g_animationClips.count) return NULL;
+    return &g_animationClips.clips[clip];
+}
+
+// Interned name; stays valid until UnloadAnimationClips
+const char* GetAnimationClipName(int clip) {
+    const AnimationClip* entry = GetAnimationClip(clip);
+    return entry != NULL ? entry->name : NULL;
+}
+
+// Shared texture the clip draws from, or an empty texture
+Texture2D GetAnimationClipTexture(int clip) {
+    const AnimationClip* entry = GetAnimationClip(clip);
+    const Spritesheet* sheet = entry != NULL ? GetSpritesheet(entry->spritesheet) : NULL;
+    return sheet != NULL ? sheet->texture : (Texture2D){0};
+}
+
+// Point a sprite at a clip's frames and start it from the first frame.
+// The sprite loops, plays once or pingpongs as the clip does.
+bool PlayAnimationClip(SpriteObject* sprite, int clip) {
+    const AnimationClip* entry = GetAnimationClip(clip);
+    if (sprite == NULL || entry == NULL) return false;
+    const Spritesheet* sheet = GetSpritesheet(entry->spritesheet);
+    if (sheet == NULL) return false;
+    // Switching clips on the same sheet keeps the texture reference
+    if (!sprite->sharedTexture || sprite->textureHandle != sheet->textureHandle) {
+        if (!SetSpriteSpritesheet(sprite, entry->spritesheet)) return false;
+    }
+    sprite->frames = sheet->frames + entry->firstFrame;
+    sprite->frameTableSize = entry->sequence.frameCount;
+    sprite->totalFrames = entry->sequence.frameCount;
+    sprite->frameTime = entry->frameTime;
+    sprite->currentFrame = 0;
+    sprite->frameTimer = 0.0f;
+    sprite->animating = entry->sequence.frameCount > 1;
+    sprite->sequenceType = entry->sequence.sequenceType;
+    sprite->reversing = false;
+    return true;
+}
+
+// Free every clip. Animators must not play them afterwards; sheets are
+// owned by the spritesheet registry and baked tables by their file.
+void UnloadAnimationClips(void) {
+    for (int i = 0; i < g_animationClips.count; i++) {
+        AnimationClip* clip = &g_animationClips.clips[i];
+        if (!clip->ownsTables) continue;
+        free((AnimationFrame*)clip->sequence.frames);
+        free((AnimationEventMarker*)clip->events);
+    }
+    memset(&g_animationClips, 0, sizeof(AnimationClipLibrary));
+}
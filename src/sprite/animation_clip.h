@@ -0,0 +1,61 @@
+// =============================================================
+// Animation clip header
+// =============================================================
+// Registry of named animation clips. A clip is a run of frames on a
+// spritesheet plus its timing, so it points at a shared texture (or
+// atlas page) and a precomputed frame table. Clip names are interned
+// once; lookups go through a hash table and never touch the disk.
+#ifndef ANIMATION_CLIP_H
+#define ANIMATION_CLIP_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "spritesheet.h"
+#include "sprite_object.h"
+#include "animation_manager.h"
+#include "animation_events.h"
+
+// Animation clip constants
+#define MAX_ANIMATION_CLIPS 1024
+#define ANIMATION_CLIP_SLOTS 2048   // Power of two, at least twice MAX_ANIMATION_CLIPS
+#define ANIMATION_CLIP_NONE -1
+
+// One clip: frames [firstFrame, firstFrame + frameCount) of a spritesheet.
+// Clips are immutable once registered and shared by every animator and
+// sprite playing them.
+typedef struct {
+    char name[MAX_ANIMATION_NAME_LENGTH];
+    uint32_t nameHash;
+    int spritesheet;
+    int firstFrame;
+    float frameTime;                // Seconds per frame
+    AnimationSequence sequence;     // Interned name, type, frame count and frames
+    const AnimationEventMarker* events; // Sorted by frame
+    int eventCount;
+    bool ownsTables;                // False when frames and events are baked data
+} AnimationClip;
+
+// All registered clips
+typedef struct {
+    AnimationClip clips[MAX_ANIMATION_CLIPS];
+    int count;
+    int16_t slots[ANIMATION_CLIP_SLOTS];    // Clip ID + 1, 0 when empty
+} AnimationClipLibrary;
+
+extern AnimationClipLibrary g_animationClips;
+
+// Animation clip functions
+int RegisterAnimationClip(const char* name, int spritesheet, int firstFrame, int frameCount, float frameTime, AnimationSequenceType type);
+int RegisterAnimationClipFrames(const char* name, int spritesheet, const AnimationFrame* frames, int frameCount,
+                                AnimationSequenceType type, const AnimationEventMarker* events, int eventCount);
+bool AddAnimationClipEvent(int clip, int frame, int eventId);
+int LoadAnimationClip(const char* name, const char* texturePath, int frameWidth, int frameHeight, int frameCount, float frameTime, AnimationSequenceType type);
+int FindAnimationClip(const char* name);
+const AnimationClip* GetAnimationClip(int clip);
+const char* GetAnimationClipName(int clip);
+Texture2D GetAnimationClipTexture(int clip);
+bool PlayAnimationClip(SpriteObject* sprite, int clip);
+void UnloadAnimationClips(void);
+
+#endif // ANIMATION_CLIP_H
@@ -0,0 +1,51 @@
+// =============================================================
+// Animation events source
+// =============================================================
+#include "animation_events.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// First marker on or after frame (markers are sorted by frame)
+int FindAnimationEventMarker(const AnimationEventMarker* markers, int markerCount, int frame) {
+    int low = 0;
+    int high = markerCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (markers[mid].frame < frame) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static bool PushAnimationEvent(AnimationEventBuffer* buffer, AnimationEvent event) {
+    if (buffer->count == buffer->capacity) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity * 2 : 64;
+        AnimationEvent* grown = (AnimationEvent*)realloc(buffer->items, newCapacity * sizeof(AnimationEvent));
+        if (grown == NULL) {
+            printf("Warning: Animation event buffer is full, dropping events.\n");
+            return false;
+        }
+        buffer->items = grown;
+        buffer->capacity = newCapacity;
+    }
+    buffer->items[buffer->count++] = event;
+    return true;
+}
+
+// Emit every marker on a frame that playback just entered
+void EmitAnimationFrameEvents(AnimationEventBuffer* buffer, const AnimationEventMarker* markers, int markerCount, int clip, int frame, int animator, int row) {
+    if (buffer == NULL || markerCount <= 0) return;
+    for (int i = FindAnimationEventMarker(markers, markerCount, frame); i < markerCount && markers[i].frame == frame; i++) {
+        if (!PushAnimationEvent(buffer, (AnimationEvent){ markers[i].eventId, clip, frame, animator, row })) return;
+    }
+}
+
+void ClearAnimationEvents(AnimationEventBuffer* buffer) {
+    if (buffer != NULL) buffer->count = 0;
+}
+
+void FreeAnimationEvents(AnimationEventBuffer* buffer) {
+    if (buffer == NULL) return;
+    free(buffer->items);
+    *buffer = (AnimationEventBuffer){0};
+}
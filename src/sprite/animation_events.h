@@ -0,0 +1,44 @@
+// =============================================================
+// Animation events header
+// =============================================================
+// Event markers carried by animation clips, and the per-frame buffer
+// UpdateAnimators fills with the markers animators crossed. A marker
+// fires each time playback enters its frame, so a step that skips
+// several frames still reports every marker in order. Gameplay code
+// drains the buffer once per frame instead of polling frame indices.
+#ifndef ANIMATION_EVENTS_H
+#define ANIMATION_EVENTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A marker on one frame of a clip. eventId is defined by the game.
+typedef struct {
+    int frame;
+    int eventId;
+} AnimationEventMarker;
+
+// One crossed marker
+typedef struct {
+    int eventId;
+    int clip;
+    int frame;      // Clip frame the marker sits on
+    int animator;   // Index into AnimationManager.animators, or -1
+    int row;        // AnimatorStore row, or -1
+} AnimationEvent;
+
+// Events emitted by the last update, in the order they were crossed
+// for each animator
+typedef struct {
+    AnimationEvent* items;
+    size_t count;
+    size_t capacity;
+} AnimationEventBuffer;
+
+// Animation event functions
+int FindAnimationEventMarker(const AnimationEventMarker* markers, int markerCount, int frame);
+void EmitAnimationFrameEvents(AnimationEventBuffer* buffer, const AnimationEventMarker* markers, int markerCount, int clip, int frame, int animator, int row);
+void ClearAnimationEvents(AnimationEventBuffer* buffer);
+void FreeAnimationEvents(AnimationEventBuffer* buffer);
+
+#endif // ANIMATION_EVENTS_H
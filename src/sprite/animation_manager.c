@@ -5,6 +5,9 @@
 // updating, and playing animations.
 // =============================================================
 #include "animation_manager.h"
+#include "animation_clip.h"
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 AnimationManager* g_animationManager = NULL;
@@ -14,11 +17,32 @@ void InitAnimationManager(AnimationManager* manager) {
     if (manager == NULL) return;
     manager->animatorCount = 0;
     manager->state = ANIMATION_MANAGER_INITIALIZED;
+    manager->spritesheet = SPRITESHEET_NONE;
+    InitAnimatorStore(&manager->store);
+    manager->events = (AnimationEventBuffer){0};
+    manager->frame = 0;
+    manager->reducedInterval = ANIMATION_LOD_REDUCED_INTERVAL;
+    manager->lodStats = (AnimationLodStats){0};
     for (int i = 0; i < MAX_ANIMATIONS; i++) {
         manager->animators[i] = NULL;
     }
 }
 
+// Set up an animator to play a clip from its first frame
+void InitAnimator(Animator* animator, int clip) {
+    if (animator == NULL) return;
+    const AnimationClip* entry = GetAnimationClip(clip);
+    animator->clip = entry != NULL ? clip : ANIMATION_CLIP_NONE;
+    animator->currentType = entry != NULL ? entry->sequence.sequenceType : ANIMATION_SEQUENCE_LOOP;
+    animator->currentFrameIndex = 0;
+    animator->frameTimer = 0.0f;
+    animator->speedMultiplier = 1.0f;
+    animator->direction = 1;
+    animator->playing = entry != NULL;
+    animator->lod = ANIMATION_LOD_EAGER;
+    animator->heldBack = false;
+}
+
 // Add an animator to the manager
 void AddAnimator(AnimationManager* manager, Animator* animator) {
     if (manager == NULL || animator == NULL) return;
@@ -29,12 +53,12 @@ void AddAnimator(AnimationManager* manager, Animator* animator) {
     manager->animators[manager->animatorCount++] = animator;
 }
 
-// Remove an animator by name
+// Remove the first animator playing the named clip
 void RemoveAnimator(AnimationManager* manager, const char* name) {
     if (manager == NULL || name == NULL) return;
-    for (size_t i = 0; i < manager->animatorCount; i++) {
-        if (manager->animators[i] != NULL && strcmp(manager->animators[i]->sequence.name, name) == 0) {
-            free(manager->animators[i]->sequence.frames);
+    int clip = FindAnimationClip(name);
+    for (size_t i = 0; clip != ANIMATION_CLIP_NONE && i < manager->animatorCount; i++) {
+        if (manager->animators[i] != NULL && manager->animators[i]->clip == clip) {
             free(manager->animators[i]);
             manager->animators[i] = NULL;
             // Shift remaining animators
@@ -48,49 +72,118 @@ void RemoveAnimator(AnimationManager* manager, const char* name) {
     printf("Warning: Animator with name %s not found.\n", name);
 }
 
-// Update all animators managed by the animation manager
+// Step to the next frame. Returns false when a ONCE clip has finished.
+static bool AdvanceAnimator(Animator* animator, int frameCount) {
+    int next = animator->currentFrameIndex + animator->direction;
+    if (next >= 0 && next < frameCount) {
+        animator->currentFrameIndex = next;
+        return true;
+    }
+    if (animator->currentType == ANIMATION_SEQUENCE_LOOP) {
+        animator->currentFrameIndex = 0;
+    } else if (animator->currentType == ANIMATION_SEQUENCE_PINGPONG && frameCount > 1) {
+        // Bounce off either end without repeating the end frame
+        animator->direction = -animator->direction;
+        animator->currentFrameIndex += animator->direction;
+    } else {
+        return false; // Stay on the last frame
+    }
+    return true;
+}
+
+// Frames for a looping or pingpong animator to come back to the same
+// frame and direction
+static int GetAnimatorPeriod(const Animator* animator, int frameCount) {
+    if (animator->currentType == ANIMATION_SEQUENCE_PINGPONG && frameCount > 1) return 2 * (frameCount - 1);
+    return frameCount;
+}
+
+// Jump a looping or pingpong animator forward by skip frames in O(1).
+// Pingpong positions are a phase in [0, period): up the clip, then down.
+static void SkipAnimatorFrames(Animator* animator, int frameCount, int period, int skip) {
+    if (animator->currentType == ANIMATION_SEQUENCE_LOOP) {
+        animator->currentFrameIndex = (animator->currentFrameIndex + skip) % frameCount;
+        return;
+    }
+    int last = frameCount - 1;
+    int phase = animator->direction > 0 ? animator->currentFrameIndex : (period - animator->currentFrameIndex) % period;
+    phase = (phase + skip) % period;
+    animator->currentFrameIndex = last - abs(phase - last);
+    animator->direction = phase > last ? -1 : 1;
+}
+
+// Update all animators managed by the animation manager. The event
+// buffer is refilled with the markers crossed during this update.
+// Animators held back by animation LOD only accumulate time.
 void UpdateAnimators(AnimationManager* manager, float deltaTime) {
     if (manager == NULL) return;
+    ClearAnimationEvents(&manager->events);
+    bool reducedDue = manager->frame++ % (manager->reducedInterval ? manager->reducedInterval : 1) == 0;
+    manager->lodStats = (AnimationLodStats){0};
     for (size_t i = 0; i < manager->animatorCount; i++) {
         Animator* animator = manager->animators[i];
-        if (animator != NULL && animator->currentFrame != NULL) {
-            animator->frameTimer += deltaTime * animator->speedMultiplier;
-                if (animator->frameTimer >= animator->currentFrame->duration) {
-                animator->frameTimer -= animator->currentFrame->duration;
-                animator->currentFrameIndex++;
-                if (animator->currentFrameIndex >= animator->sequence.frameCount) {
-                    if (animator->sequence.sequenceType == ANIMATION_SEQUENCE_LOOP) {
-                        animator->currentFrameIndex = 0;
-                    } else if (animator->sequence.sequenceType == ANIMATION_SEQUENCE_ONCE) {
-                        animator->currentFrameIndex = animator->sequence.frameCount - 1; // Stay on last frame
-                    } else if (animator->sequence.sequenceType == ANIMATION_SEQUENCE_PINGPONG) {
-                        // Implement pingpong logic if needed
-                    }
-                }
-                animator->currentFrame = &animator->sequence.frames[animator->currentFrameIndex];
+        if (animator == NULL || !animator->playing) continue;
+        const AnimationClip* clip = GetAnimationClip(animator->clip);
+        if (clip == NULL) continue;
+        const AnimationSequence* sequence = &clip->sequence;
+        animator->frameTimer += deltaTime * animator->speedMultiplier;
+        if (animator->lod == ANIMATION_LOD_DEFERRED || (animator->lod == ANIMATION_LOD_REDUCED && !reducedDue)) {
+            manager->lodStats.deferred++;
+            animator->heldBack = true;
+            continue;
+        }
+        manager->lodStats.eager++;
+        // Catching up after being held back: jump over all but the last
+        // cycle of frames in O(1), then walk that cycle for its markers.
+        // Eager animators walk every frame they cross. Clip frames share
+        // one duration.
+        if (animator->heldBack && animator->currentType != ANIMATION_SEQUENCE_ONCE && sequence->frameCount > 1) {
+            int period = GetAnimatorPeriod(animator, sequence->frameCount);
+            float steps = floorf(animator->frameTimer / clip->frameTime);
+            if (steps > (float)period) {
+                float skipped = steps - (float)period;
+                animator->frameTimer -= skipped * clip->frameTime;
+                SkipAnimatorFrames(animator, sequence->frameCount, period, (int)fmodf(skipped, (float)period));
+            }
+        }
+        animator->heldBack = false;
+        // Durations are positive, so a long step just crosses several frames
+        while (animator->frameTimer >= sequence->frames[animator->currentFrameIndex].duration) {
+            animator->frameTimer -= sequence->frames[animator->currentFrameIndex].duration;
+            if (!AdvanceAnimator(animator, sequence->frameCount)) {
+                animator->frameTimer = 0.0f;
+                animator->playing = false;
+                break;
             }
+            EmitAnimationFrameEvents(&manager->events, clip->events, clip->eventCount, animator->clip, animator->currentFrameIndex, (int)i, -1);
         }
     }
+    UpdateAnimatorStore(&manager->store, deltaTime);
+    EmitAnimatorStoreEvents(&manager->store, &manager->events);
 }
 
-// Play a specific animation by name
+// Switch an animator to a clip by name and play it from the start
 void PlayAnimation(Animator* animator, const char* animationName) {
     if (animator == NULL || animationName == NULL) return;
-    if (strcmp(animator->sequence.name, animationName) == 0) {
-        animator->currentFrameIndex = 0;
-        animator->currentFrame = &animator->sequence.frames[0];
-        animator->frameTimer = 0.0f;
-    } else {
-        printf("Warning: Animation %s not found in animator %s.\n", animationName, animator->sequence.name);
+    int clip = FindAnimationClip(animationName);
+    if (clip == ANIMATION_CLIP_NONE) {
+        printf("Warning: Animation %s not found.\n", animationName);
+        return;
     }
+    float speedMultiplier = animator->speedMultiplier;
+    uint8_t lod = animator->lod;
+    InitAnimator(animator, clip);
+    animator->speedMultiplier = speedMultiplier;
+    animator->lod = lod;
 }
 
 // Stop the current animation
 void StopAnimation(Animator* animator) {
     if (animator == NULL) return;
-    animator->currentFrame = NULL;
+    animator->playing = false;
     animator->currentFrameIndex = 0;
     animator->frameTimer = 0.0f;
+    animator->direction = 1;
 }
 
 // Set animation speed multiplier
@@ -102,56 +195,78 @@ void SetAnimationSpeed(Animator* animator, float speedMultiplier) {
 // Check if an animation is currently playing
 bool IsAnimationPlaying(const Animator* animator) {
     if (animator == NULL) return false;
-    return animator->currentFrame != NULL;
+    return animator->playing;
 }
 
 // Unload all animators managed by the animation manager
 void UnloadAllAnimators(AnimationManager* manager) {
     if (manager == NULL) return;
     for (size_t i = 0; i < manager->animatorCount; i++) {
-        if (manager->animators[i] != NULL) {
-            free(manager->animators[i]->sequence.frames);
-            free(manager->animators[i]);
-            manager->animators[i] = NULL;
-        }
+        free(manager->animators[i]);
+        manager->animators[i] = NULL;
     }
     manager->animatorCount = 0;
+    FreeAnimatorStore(&manager->store);
+    manager->store.reducedInterval = manager->reducedInterval;
+    FreeAnimationEvents(&manager->events);
 }
 
 // Set the animation state (sequence type)
 void SetAnimationState(Animator* animator, AnimationSequenceType state) {
     if (animator == NULL) return;
     animator->currentType = state;
+    if (state != ANIMATION_SEQUENCE_PINGPONG) animator->direction = 1;
+}
+
+// Resolve an animator every frame, every Nth frame or only when it is
+// made eager again, e.g. from its entity's visibility or distance
+void SetAnimatorLod(Animator* animator, AnimationLod lod) {
+    if (animator == NULL) return;
+    animator->lod = (uint8_t)lod;
+}
+
+// Updates between resolves of reduced animators, list and store alike
+void SetAnimationLodInterval(AnimationManager* manager, uint32_t interval) {
+    if (manager == NULL) return;
+    manager->reducedInterval = interval ? interval : 1;
+    manager->store.reducedInterval = manager->reducedInterval;
+}
+
+// Eager and deferred counts for the last update, list and store combined
+AnimationLodStats GetAnimationLodStats(const AnimationManager* manager) {
+    if (manager == NULL) return (AnimationLodStats){0};
+    AnimationLodStats storeStats = GetAnimatorStoreStats(&manager->store);
+    return (AnimationLodStats){ manager->lodStats.eager + storeStats.eager, manager->lodStats.deferred + storeStats.deferred };
 }
 
-// Helper function to get animation by name (stub implementation)
+// Shared sequence of a registered clip. O(1), see FindAnimationClip.
 AnimationSequence* GetAnimationByName(const char* name) {
-    (void)name; // Unused parameter
-    // This function would typically search a global or passed-in list of animations.
-    // For simplicity, we return NULL here.
-    return NULL;
+    int clip = FindAnimationClip(name);
+    if (clip == ANIMATION_CLIP_NONE) return NULL;
+    return &g_animationClips.clips[clip].sequence;
 }
 
-// Note: The above function is a placeholder. In a real implementation, you would have a collection of AnimationSequence objects to search through.
+// Events from the last UpdateAnimators. Markers fire when playback enters
+// their frame, not when a clip starts on it.
+const AnimationEventBuffer* GetAnimationEvents(const AnimationManager* manager) {
+    if (manager == NULL) return NULL;
+    return &manager->events;
+}
 
-// Get the rectangle for a specific animation frame index
+// Frame the animator is showing, or NULL without a clip
+const AnimationFrame* GetAnimatorFrame(const Animator* animator) {
+    if (animator == NULL) return NULL;
+    const AnimationClip* clip = GetAnimationClip(animator->clip);
+    if (clip == NULL) return NULL;
+    return &clip->sequence.frames[animator->currentFrameIndex];
+}
+
+// Get the rectangle for a specific animation frame index. Out-of-range
+// indices fall back to frame 0; without a spritesheet the rect is empty.
 Rectangle GetAnimationFrameRect(const AnimationManager* manager, int frameIndex) {
-    // Sonic spritesheet uses 64x64 tiles
-    // 704x704 image = 11x11 grid of 64x64 frames (704/64 = 11)
-    (void)manager; // currently unused
-    const int frameWidth = 64;
-    const int frameHeight = 64;
-    const int framesPerRow = 11; // 704 / 64 = 11
-    const int maxFrames = 11 * 11; // 121 total frames
-    
-    // Bounds check to prevent garbage values
-    if (frameIndex < 0 || frameIndex >= maxFrames) {
-        printf("[ERROR] Frame index %d out of bounds (0-%d), using frame 0\n", frameIndex, maxFrames-1);
-        frameIndex = 0;
-    }
-    
-    int row = frameIndex / framesPerRow;
-    int col = frameIndex % framesPerRow;
-    
-    return (Rectangle){ col * frameWidth, row * frameHeight, frameWidth, frameHeight };
+    if (manager == NULL) return (Rectangle){0};
+    const Spritesheet* sheet = GetSpritesheet(manager->spritesheet);
+    if (sheet == NULL) return (Rectangle){0};
+    if ((unsigned int)frameIndex >= (unsigned int)sheet->frameCount) frameIndex = 0;
+    return sheet->frames[frameIndex].source;
 }
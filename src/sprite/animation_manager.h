@@ -7,6 +7,8 @@
 
 #include "raylib.h"
 #include "../util/globals.h"
+#include "spritesheet.h"
+#include "animator_store.h"
 
 // Animation manager constants
 #define MAX_ANIMATIONS 100
@@ -25,22 +27,26 @@ typedef struct {
     float duration;
 } AnimationFrame;
 
-// Animation sequence structure
+// Animation sequence structure. Sequences live in the clip library
+// (animation_clip.h) and are shared, never copied into animators.
 typedef struct {
     const char* name;
     AnimationSequenceType sequenceType;
     int frameCount;
-    AnimationFrame* frames;
+    const AnimationFrame* frames;
 } AnimationSequence;
 
-// Animator structure
+// Animator structure: a clip ID plus playback state
 typedef struct {
-    AnimationSequence sequence;
-    AnimationFrame *currentFrame;
-    AnimationSequenceType currentType;
+    int clip;                           // g_animationClips ID
+    AnimationSequenceType currentType;  // Starts as the clip's type
     int currentFrameIndex;
     float frameTimer;
     float speedMultiplier;
+    int direction;                      // 1 forwards, -1 backwards (pingpong)
+    bool playing;
+    uint8_t lod;                        // AnimationLod
+    bool heldBack;                      // Skipped by animation LOD since its last resolve
 } Animator;
 
 // Animation manager state enum
@@ -58,10 +64,17 @@ typedef struct {
     float elapsedTime;
     const char* animations;
     Texture2D texture;
+    int spritesheet;        // Frame table used by GetAnimationFrameRect
+    AnimatorStore store;    // Bulk animators, updated with the animator list
+    AnimationEventBuffer events;    // Markers crossed by the last UpdateAnimators
+    uint32_t frame;                 // Updates so far, for reduced animators
+    uint32_t reducedInterval;       // Updates between reduced animator resolves
+    AnimationLodStats lodStats;     // Animator list counters for the last update
 } AnimationManager;
 
 // Animation manager functions
 void InitAnimationManager(AnimationManager* manager);
+void InitAnimator(Animator* animator, int clip);
 void AddAnimator(AnimationManager* manager, Animator* animator);
 void RemoveAnimator(AnimationManager* manager, const char* name);
 void UpdateAnimators(AnimationManager* manager, float deltaTime);
@@ -71,7 +84,12 @@ void SetAnimationSpeed(Animator* animator, float speedMultiplier);
 bool IsAnimationPlaying(const Animator* animator);
 void UnloadAllAnimators(AnimationManager* manager);
 void SetAnimationState(Animator* animator, AnimationSequenceType state);
+void SetAnimatorLod(Animator* animator, AnimationLod lod);
+void SetAnimationLodInterval(AnimationManager* manager, uint32_t interval);
+AnimationLodStats GetAnimationLodStats(const AnimationManager* manager);
 AnimationSequence* GetAnimationByName(const char* name);
-// Return the source rectangle for a given frame index in the current texture/spritesheet
+const AnimationFrame* GetAnimatorFrame(const Animator* animator);
+const AnimationEventBuffer* GetAnimationEvents(const AnimationManager* manager);
+// Return the source rectangle for a given frame index in the manager's spritesheet
 Rectangle GetAnimationFrameRect(const AnimationManager* manager, int frameIndex);
 #endif // ANIMATION_MANAGER_H
@@ -0,0 +1,346 @@
+// =============================================================
+// Animator store source
+// =============================================================
+// Column management and the bulk update kernel for AnimatorStore. The
+// kernel has no per-row branches: every row in a group of four runs
+// the same instructions whatever its clip type.
+#include "animator_store.h"
+#include "animation_clip.h"
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Rows past count, and stopped rows, run through the kernel unchanged
+static void WriteInertAnimatorRow(AnimatorStore* store, size_t row) {
+    store->timers[row] = 0.0f;
+    store->rates[row] = 0.0f;
+    store->speeds[row] = 1.0f;
+    store->frameTimes[row] = 1.0f;
+    store->phases[row] = 0.0f;
+    store->periods[row] = 1.0f;
+    store->lastFrames[row] = 0.0f;
+    store->limits[row] = 0.0f;
+    store->advanced[row] = 0.0f;
+    store->frames[row] = 0;
+    store->clips[row] = ANIMATION_CLIP_NONE;
+}
+
+static void SetAnimatorRowBit(uint64_t* bits, size_t row, bool set) {
+    uint64_t bit = (uint64_t)1 << (row % ANIMATOR_CHANGED_WORD_BITS);
+    if (set) bits[row / ANIMATOR_CHANGED_WORD_BITS] |= bit;
+    else bits[row / ANIMATOR_CHANGED_WORD_BITS] &= ~bit;
+}
+
+static bool GetAnimatorRowBit(const uint64_t* bits, size_t row) {
+    return (bits[row / ANIMATOR_CHANGED_WORD_BITS] >> (row % ANIMATOR_CHANGED_WORD_BITS)) & 1u;
+}
+
+static void MoveAnimatorRowBit(uint64_t* bits, size_t to, size_t from) {
+    SetAnimatorRowBit(bits, to, GetAnimatorRowBit(bits, from));
+    SetAnimatorRowBit(bits, from, false);
+}
+
+static bool GrowAnimatorColumn(void** column, size_t elementSize, size_t capacity) {
+    void* grown = realloc(*column, capacity * elementSize);
+    if (grown == NULL) return false;
+    *column = grown;
+    return true;
+}
+
+void InitAnimatorStore(AnimatorStore* store) {
+    if (store == NULL) return;
+    memset(store, 0, sizeof(AnimatorStore));
+    store->reducedInterval = ANIMATION_LOD_REDUCED_INTERVAL;
+}
+
+// Make room for count rows without reallocating
+bool ReserveAnimatorRows(AnimatorStore* store, size_t count) {
+    if (store == NULL) return false;
+    if (count <= store->capacity) return true;
+    size_t capacity = store->capacity ? store->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    capacity = (capacity + ANIMATOR_STORE_LANES - 1) & ~(size_t)(ANIMATOR_STORE_LANES - 1);
+
+    size_t words = ANIMATOR_CHANGED_WORDS(capacity);
+    if (!GrowAnimatorColumn((void**)&store->timers, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->rates, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->speeds, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->frameTimes, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->phases, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->periods, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->lastFrames, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->limits, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->advanced, sizeof(float), capacity) ||
+        !GrowAnimatorColumn((void**)&store->frames, sizeof(int32_t), capacity) ||
+        !GrowAnimatorColumn((void**)&store->clips, sizeof(int32_t), capacity) ||
+        !GrowAnimatorColumn((void**)&store->playing, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->changed, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->entered, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->hasEvents, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->reduced, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->deferred, sizeof(uint64_t), words) ||
+        !GrowAnimatorColumn((void**)&store->pending, sizeof(uint64_t), words)) {
+        printf("Error: Memory allocation for animator rows failed.\n");
+        return false;
+    }
+    for (size_t row = store->capacity; row < capacity; row++) {
+        WriteInertAnimatorRow(store, row);
+    }
+    size_t oldWords = ANIMATOR_CHANGED_WORDS(store->capacity);
+    size_t newBytes = (words - oldWords) * sizeof(uint64_t);
+    memset(store->playing + oldWords, 0, newBytes);
+    memset(store->changed + oldWords, 0, newBytes);
+    memset(store->entered + oldWords, 0, newBytes);
+    memset(store->hasEvents + oldWords, 0, newBytes);
+    memset(store->reduced + oldWords, 0, newBytes);
+    memset(store->deferred + oldWords, 0, newBytes);
+    memset(store->pending + oldWords, 0, newBytes);
+    store->capacity = capacity;
+    return true;
+}
+
+// Add a row playing a clip. Returns the row, or -1.
+int AddAnimatorRow(AnimatorStore* store, int clip) {
+    if (store == NULL || !ReserveAnimatorRows(store, store->count + 1)) return -1;
+    size_t row = store->count++;
+    if (!PlayAnimatorRow(store, row, clip)) {
+        store->count--;
+        return -1;
+    }
+    return (int)row;
+}
+
+// Swap-remove a row; the last row moves into its place
+void RemoveAnimatorRow(AnimatorStore* store, size_t row) {
+    if (store == NULL || row >= store->count) return;
+    size_t last = --store->count;
+    if (row != last) {
+        store->timers[row] = store->timers[last];
+        store->rates[row] = store->rates[last];
+        store->speeds[row] = store->speeds[last];
+        store->frameTimes[row] = store->frameTimes[last];
+        store->phases[row] = store->phases[last];
+        store->periods[row] = store->periods[last];
+        store->lastFrames[row] = store->lastFrames[last];
+        store->limits[row] = store->limits[last];
+        store->advanced[row] = store->advanced[last];
+        store->frames[row] = store->frames[last];
+        store->clips[row] = store->clips[last];
+    }
+    WriteInertAnimatorRow(store, last);
+    // Moving a row onto itself just clears it
+    MoveAnimatorRowBit(store->playing, row, last);
+    MoveAnimatorRowBit(store->changed, row, last);
+    MoveAnimatorRowBit(store->entered, row, last);
+    MoveAnimatorRowBit(store->hasEvents, row, last);
+    MoveAnimatorRowBit(store->reduced, row, last);
+    MoveAnimatorRowBit(store->deferred, row, last);
+    MoveAnimatorRowBit(store->pending, row, last);
+}
+
+// Start a row on a clip from its first frame. The row's frame reads -1
+// until the next update, so that update reports it as changed.
+bool PlayAnimatorRow(AnimatorStore* store, size_t row, int clip) {
+    if (store == NULL || row >= store->count) return false;
+    const AnimationClip* entry = GetAnimationClip(clip);
+    if (entry == NULL) return false;
+    float last = (float)(entry->sequence.frameCount - 1);
+    AnimationSequenceType type = entry->sequence.sequenceType;
+    store->timers[row] = 0.0f;
+    store->rates[row] = store->speeds[row];
+    store->frameTimes[row] = entry->frameTime;
+    store->phases[row] = 0.0f;
+    store->periods[row] = type == ANIMATION_SEQUENCE_PINGPONG ? (last > 0.0f ? 2.0f * last : 1.0f) : last + 1.0f;
+    store->lastFrames[row] = last;
+    store->limits[row] = type == ANIMATION_SEQUENCE_ONCE ? last : FLT_MAX;
+    store->frames[row] = -1;
+    store->advanced[row] = 0.0f;
+    store->clips[row] = clip;
+    SetAnimatorRowBit(store->playing, row, true);
+    SetAnimatorRowBit(store->hasEvents, row, entry->eventCount > 0);
+    return true;
+}
+
+// Stop a row and rewind it to its first frame
+void StopAnimatorRow(AnimatorStore* store, size_t row) {
+    if (store == NULL || row >= store->count) return;
+    store->timers[row] = 0.0f;
+    store->rates[row] = 0.0f;
+    store->phases[row] = 0.0f;
+    if (store->frames[row] != 0) store->frames[row] = -1;
+    SetAnimatorRowBit(store->playing, row, false);
+}
+
+// Negative speeds are treated as 0; the kernel only runs time forwards
+void SetAnimatorRowSpeed(AnimatorStore* store, size_t row, float speedMultiplier) {
+    if (store == NULL || row >= store->count) return;
+    store->speeds[row] = speedMultiplier > 0.0f ? speedMultiplier : 0.0f;
+    if (GetAnimatorRowBit(store->playing, row)) store->rates[row] = store->speeds[row];
+}
+
+// Change how often a row is reported. A deferred row made eager reports
+// its current frame on the next update if it moved while deferred.
+void SetAnimatorRowLod(AnimatorStore* store, size_t row, AnimationLod lod) {
+    if (store == NULL || row >= store->count) return;
+    SetAnimatorRowBit(store->reduced, row, lod == ANIMATION_LOD_REDUCED);
+    SetAnimatorRowBit(store->deferred, row, lod == ANIMATION_LOD_DEFERRED);
+}
+
+// Playing and not finished (once clips finish on their last frame)
+bool IsAnimatorRowPlaying(const AnimatorStore* store, size_t row) {
+    if (store == NULL || row >= store->count) return false;
+    return GetAnimatorRowBit(store->playing, row) && store->phases[row] < store->limits[row];
+}
+
+// Spritesheet frame the row is showing, or -1 without a clip
+int GetAnimatorRowSheetFrame(const AnimatorStore* store, size_t row) {
+    if (store == NULL || row >= store->count) return -1;
+    const AnimationClip* clip = GetAnimationClip(store->clips[row]);
+    if (clip == NULL) return -1;
+    int frame = store->frames[row] > 0 ? store->frames[row] : 0;
+    return clip->sequence.frames[frame].frameIndex;
+}
+
+#if defined(__SSE2__)
+// Advance rows [0, rows) four at a time and set their changed bits
+static void AdvanceAnimatorRowsSse2(AnimatorStore* store, float deltaTime, size_t rows) {
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t row = 0; row < rows; row += ANIMATOR_STORE_LANES) {
+        __m128 frameTime = _mm_loadu_ps(store->frameTimes + row);
+        __m128 period = _mm_loadu_ps(store->periods + row);
+        __m128 last = _mm_loadu_ps(store->lastFrames + row);
+        // Whole frames crossed this step; truncation is floor as time only grows
+        __m128 timer = _mm_add_ps(_mm_loadu_ps(store->timers + row), _mm_mul_ps(dt, _mm_loadu_ps(store->rates + row)));
+        __m128 steps = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(timer, frameTime)));
+        timer = _mm_sub_ps(timer, _mm_mul_ps(steps, frameTime));
+        // Clamp once clips, then wrap the phase into its period
+        __m128 previousPhase = _mm_loadu_ps(store->phases + row);
+        __m128 phase = _mm_min_ps(_mm_add_ps(previousPhase, steps), _mm_loadu_ps(store->limits + row));
+        __m128 advanced = _mm_sub_ps(phase, previousPhase);
+        _mm_storeu_ps(store->advanced + row, advanced);
+        int entered = _mm_movemask_ps(_mm_cmpgt_ps(advanced, zero));
+        phase = _mm_sub_ps(phase, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(phase, period))), period));
+        // frame = last - |phase - last|
+        __m128 frame = _mm_sub_ps(last, _mm_andnot_ps(signMask, _mm_sub_ps(phase, last)));
+        __m128i frameIndex = _mm_cvttps_epi32(frame);
+        __m128i previous = _mm_loadu_si128((const __m128i*)(store->frames + row));
+        int unchanged = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(frameIndex, previous)));
+
+        _mm_storeu_ps(store->timers + row, timer);
+        _mm_storeu_ps(store->phases + row, phase);
+        _mm_storeu_si128((__m128i*)(store->frames + row), frameIndex);
+        store->changed[row / ANIMATOR_CHANGED_WORD_BITS] |= (uint64_t)(~unchanged & 0xF) << (row % ANIMATOR_CHANGED_WORD_BITS);
+        store->entered[row / ANIMATOR_CHANGED_WORD_BITS] |= (uint64_t)entered << (row % ANIMATOR_CHANGED_WORD_BITS);
+    }
+}
+#endif
+
+// Same math one row at a time, for builds without SSE2 and to check the
+// SSE2 kernel against
+static void AdvanceAnimatorRowsScalar(AnimatorStore* store, float deltaTime, size_t rows) {
+    for (size_t row = 0; row < rows; row++) {
+        float timer = store->timers[row] + deltaTime * store->rates[row];
+        float steps = (float)(int32_t)(timer / store->frameTimes[row]);
+        timer -= steps * store->frameTimes[row];
+        float phase = store->phases[row] + steps;
+        if (phase > store->limits[row]) phase = store->limits[row];
+        store->advanced[row] = phase - store->phases[row];
+        phase -= (float)(int32_t)(phase / store->periods[row]) * store->periods[row];
+        float offset = phase - store->lastFrames[row];
+        int32_t frame = (int32_t)(store->lastFrames[row] - (offset < 0.0f ? -offset : offset));
+
+        store->timers[row] = timer;
+        store->phases[row] = phase;
+        store->changed[row / ANIMATOR_CHANGED_WORD_BITS] |= (uint64_t)(frame != store->frames[row]) << (row % ANIMATOR_CHANGED_WORD_BITS);
+        store->entered[row / ANIMATOR_CHANGED_WORD_BITS] |= (uint64_t)(store->advanced[row] > 0.0f) << (row % ANIMATOR_CHANGED_WORD_BITS);
+        store->frames[row] = frame;
+    }
+}
+
+// Advance every row by deltaTime and rebuild the changed bitset
+void UpdateAnimatorStore(AnimatorStore* store, float deltaTime) {
+    if (store == NULL) return;
+    store->stats = (AnimationLodStats){0};
+    if (store->count == 0) return;
+    size_t rows = (store->count + ANIMATOR_STORE_LANES - 1) & ~(size_t)(ANIMATOR_STORE_LANES - 1);
+    memset(store->changed, 0, ANIMATOR_CHANGED_WORDS(rows) * sizeof(uint64_t));
+    memset(store->entered, 0, ANIMATOR_CHANGED_WORDS(rows) * sizeof(uint64_t));
+#if defined(__SSE2__)
+    if (store->scalarKernel) AdvanceAnimatorRowsScalar(store, deltaTime, rows);
+    else AdvanceAnimatorRowsSse2(store, deltaTime, rows);
+#else
+    AdvanceAnimatorRowsScalar(store, deltaTime, rows);
+#endif
+
+    // Report changes for eager rows, and for reduced rows on their frames.
+    // Rows held back keep their changes pending until they are reported.
+    bool reducedDue = store->frame++ % (store->reducedInterval ? store->reducedInterval : 1) == 0;
+    for (size_t word = 0; word < ANIMATOR_CHANGED_WORDS(store->count); word++) {
+        size_t liveRows = store->count - word * ANIMATOR_CHANGED_WORD_BITS;
+        uint64_t live = liveRows >= ANIMATOR_CHANGED_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << liveRows) - 1;
+        uint64_t held = (store->deferred[word] | (reducedDue ? 0 : store->reduced[word])) & live;
+        store->pending[word] |= store->changed[word];
+        store->changed[word] = store->pending[word] & ~held;
+        store->pending[word] &= held;
+        store->stats.deferred += (size_t)__builtin_popcountll(held);
+    }
+    store->stats.eager = store->count - store->stats.deferred;
+}
+
+// Emit the markers each row crossed in the last update. Only rows that
+// entered a frame of a clip with markers are visited; their crossed
+// frames are replayed from the phase and the number of frames entered,
+// so a long step reports every crossing. Deferred rows emit nothing.
+void EmitAnimatorStoreEvents(const AnimatorStore* store, AnimationEventBuffer* events) {
+    if (store == NULL || events == NULL) return;
+    for (size_t word = 0; word < ANIMATOR_CHANGED_WORDS(store->count); word++) {
+        for (uint64_t bits = store->hasEvents[word] & store->entered[word] & ~store->deferred[word]; bits != 0; bits &= bits - 1) {
+            size_t row = word * ANIMATOR_CHANGED_WORD_BITS + (size_t)__builtin_ctzll(bits);
+            int advanced = (int)store->advanced[row];
+            if (row >= store->count || advanced <= 0) continue;
+            const AnimationClip* clip = GetAnimationClip(store->clips[row]);
+            int period = (int)store->periods[row];
+            int last = (int)store->lastFrames[row];
+            for (int k = advanced - 1; k >= 0; k--) {
+                int phase = ((int)store->phases[row] - k) % period;
+                if (phase < 0) phase += period;
+                int frame = last - (phase > last ? phase - last : last - phase);
+                EmitAnimationFrameEvents(events, clip->events, clip->eventCount, store->clips[row], frame, -1, (int)row);
+            }
+        }
+    }
+}
+
+AnimationLodStats GetAnimatorStoreStats(const AnimatorStore* store) {
+    if (store == NULL) return (AnimationLodStats){0};
+    return store->stats;
+}
+
+void FreeAnimatorStore(AnimatorStore* store) {
+    if (store == NULL) return;
+    free(store->timers);
+    free(store->rates);
+    free(store->speeds);
+    free(store->frameTimes);
+    free(store->phases);
+    free(store->periods);
+    free(store->lastFrames);
+    free(store->limits);
+    free(store->advanced);
+    free(store->frames);
+    free(store->clips);
+    free(store->playing);
+    free(store->changed);
+    free(store->entered);
+    free(store->hasEvents);
+    free(store->reduced);
+    free(store->deferred);
+    free(store->pending);
+    InitAnimatorStore(store);
+}
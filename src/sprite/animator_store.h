@@ -0,0 +1,114 @@
+// =============================================================
+// Animator store header
+// =============================================================
+// Struct-of-arrays playback state for large numbers of animators. One
+// row per animator; the clip's timing is copied into the row when it
+// starts playing, so the update kernel reads only contiguous columns
+// and advances four rows per step with SSE2.
+//
+// Loop, once and pingpong all run through the same math: a row keeps a
+// phase that wraps at its period, and the frame is
+// last - |phase - last|. Loop and once use period = frameCount (once
+// also clamps the phase at the last frame); pingpong uses period =
+// 2 * last, which walks back down after the last frame.
+//
+// The kernel resolves any step in O(1), so every row is advanced every
+// update. Animation LOD instead holds back what consumers see: reduced
+// and deferred rows keep their frame changes pending, and deferred rows
+// emit no events, until they are reported.
+#ifndef ANIMATOR_STORE_H
+#define ANIMATOR_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "animation_events.h"
+
+// Rows per frame-changed bitset word, and rows per kernel step
+#define ANIMATOR_CHANGED_WORD_BITS 64
+#define ANIMATOR_CHANGED_WORDS(rows) (((rows) + ANIMATOR_CHANGED_WORD_BITS - 1) / ANIMATOR_CHANGED_WORD_BITS)
+#define ANIMATOR_STORE_LANES 4
+
+// Animation level of detail. Eager animators are resolved every frame,
+// reduced ones every Nth frame and deferred ones (invisible or distant)
+// only once they are eager again. Time keeps accumulating in between, so
+// the frame they resolve to is the one they would have shown.
+typedef enum {
+    ANIMATION_LOD_EAGER,    // Zero, so new animators start eager
+    ANIMATION_LOD_REDUCED,
+    ANIMATION_LOD_DEFERRED
+} AnimationLod;
+#define ANIMATION_LOD_REDUCED_INTERVAL 4
+
+// Animation LOD counters for the last update
+typedef struct {
+    size_t eager;       // Animators resolved
+    size_t deferred;    // Animators that only accumulated time
+} AnimationLodStats;
+
+// Playback columns. Capacity is a multiple of the lane count; rows past
+// count are kept inert so the kernel never needs a tail loop.
+typedef struct {
+    float* timers;      // Time into the current frame
+    float* rates;       // Speed while playing, 0 when stopped
+    float* speeds;      // Speed multiplier, kept while stopped
+    float* frameTimes;  // Clip seconds per frame
+    float* phases;      // Position in the clip's cycle
+    float* periods;     // Cycle length in frames
+    float* lastFrames;  // Clip frame count - 1
+    float* limits;      // Phase clamp; lastFrames for once clips
+    float* advanced;    // Frames entered by the last update
+    int32_t* frames;    // Current frame within the clip
+    int32_t* clips;     // g_animationClips ID
+    uint64_t* playing;  // Rows started and not stopped
+    uint64_t* changed;  // Rows whose frame changed in the last update
+    uint64_t* entered;  // Rows that moved on at least one frame in the last update, LOD aside
+    uint64_t* hasEvents;    // Rows playing a clip with event markers
+    uint64_t* reduced;      // ANIMATION_LOD_REDUCED rows
+    uint64_t* deferred;     // ANIMATION_LOD_DEFERRED rows
+    uint64_t* pending;      // Frame changes not yet reported for held-back rows
+    size_t count;
+    size_t capacity;
+    uint32_t frame;             // Updates so far, for reduced rows
+    uint32_t reducedInterval;   // Updates between reduced-row reports
+    bool scalarKernel;          // Skip the SSE2 kernel, e.g. to check it against the scalar one
+    AnimationLodStats stats;
+} AnimatorStore;
+
+// Changed bit helpers
+static inline bool HasAnimatorRowChanged(const AnimatorStore* store, size_t row) {
+    return (store->changed[row / ANIMATOR_CHANGED_WORD_BITS] >> (row % ANIMATOR_CHANGED_WORD_BITS)) & 1u;
+}
+
+// Return the first changed row at or after row, or store->count if none.
+// for (size_t r = NextChangedAnimatorRow(&store, 0); r < store.count; r = NextChangedAnimatorRow(&store, r + 1))
+static inline size_t NextChangedAnimatorRow(const AnimatorStore* store, size_t row) {
+    while (row < store->count) {
+        uint64_t bits = store->changed[row / ANIMATOR_CHANGED_WORD_BITS] >> (row % ANIMATOR_CHANGED_WORD_BITS);
+        if (bits != 0) {
+            row += (size_t)__builtin_ctzll(bits);
+            return row < store->count ? row : store->count;
+        }
+        row = (row | (ANIMATOR_CHANGED_WORD_BITS - 1)) + 1;
+    }
+    return store->count;
+}
+
+// Animator store functions. Rows are moved by RemoveAnimatorRow: the last
+// row takes the removed row's place.
+void InitAnimatorStore(AnimatorStore* store);
+bool ReserveAnimatorRows(AnimatorStore* store, size_t count);
+int AddAnimatorRow(AnimatorStore* store, int clip);
+void RemoveAnimatorRow(AnimatorStore* store, size_t row);
+bool PlayAnimatorRow(AnimatorStore* store, size_t row, int clip);
+void StopAnimatorRow(AnimatorStore* store, size_t row);
+void SetAnimatorRowSpeed(AnimatorStore* store, size_t row, float speedMultiplier);
+void SetAnimatorRowLod(AnimatorStore* store, size_t row, AnimationLod lod);
+bool IsAnimatorRowPlaying(const AnimatorStore* store, size_t row);
+int GetAnimatorRowSheetFrame(const AnimatorStore* store, size_t row);
+void UpdateAnimatorStore(AnimatorStore* store, float deltaTime);
+void EmitAnimatorStoreEvents(const AnimatorStore* store, AnimationEventBuffer* events);
+AnimationLodStats GetAnimatorStoreStats(const AnimatorStore* store);
+void FreeAnimatorStore(AnimatorStore* store);
+
+#endif // ANIMATOR_STORE_H
@@ -0,0 +1,156 @@
+// =============================================================
+// Baked animation source
+// =============================================================
+// Maps a baked animation blob and registers its sheets and clips
+#include "baked_animation.h"
+#include "animation_clip.h"
+#include "spritesheet.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(sizeof(BakedAnimationHeader) == 52, "BakedAnimationHeader layout changed");
+_Static_assert(sizeof(BakedSpritesheet) == 24, "BakedSpritesheet layout changed");
+_Static_assert(sizeof(BakedAnimationClip) == 28, "BakedAnimationClip layout changed");
+_Static_assert(sizeof(BakedAnimationFrame) == 8 && offsetof(AnimationFrame, duration) == 4, "AnimationFrame no longer matches the baked frame table");
+_Static_assert(sizeof(BakedAnimationEvent) == 8 && offsetof(AnimationEventMarker, eventId) == 4, "AnimationEventMarker no longer matches the baked event table");
+
+BakedAnimationSet g_bakedAnimations = {0};
+
+// The blob is read as-is, so the host must be little-endian
+static bool IsHostLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static const char* BakedString(const BakedAnimationSet* set, uint32_t offset) {
+    if (offset >= set->header->stringsSize) return NULL;
+    return set->strings + offset;
+}
+
+static bool IsTableInFile(const MappedFile* file, uint32_t offset, uint32_t count, size_t recordSize) {
+    return offset % 4 == 0 && (uint64_t)offset + (uint64_t)count * recordSize <= file->size;
+}
+
+// Check that the header describes a blob we can read in place
+static bool ValidateBakedAnimations(const MappedFile* file, const BakedAnimationHeader* header) {
+    if (file->size < sizeof(BakedAnimationHeader) || memcmp(header->magic, BAKED_ANIMATION_MAGIC, 4) != 0) {
+        printf("Error: Not a baked animation file.\n");
+        return false;
+    }
+    if (header->version == 0 || header->version > BAKED_ANIMATION_VERSION) {
+        printf("Error: Unsupported baked animation version %u.\n", header->version);
+        return false;
+    }
+    if (!IsTableInFile(file, header->sheetsOffset, header->sheetCount, sizeof(BakedSpritesheet)) ||
+        !IsTableInFile(file, header->clipsOffset, header->clipCount, sizeof(BakedAnimationClip)) ||
+        !IsTableInFile(file, header->framesOffset, header->frameCount, sizeof(BakedAnimationFrame)) ||
+        !IsTableInFile(file, header->eventsOffset, header->eventCount, sizeof(BakedAnimationEvent)) ||
+        (uint64_t)header->stringsOffset + header->stringsSize > file->size ||
+        header->stringsSize == 0 || file->data[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        printf("Error: Baked animation file is truncated or corrupt.\n");
+        return false;
+    }
+    return true;
+}
+
+// Check every record points at real strings, sheets and table ranges
+static bool ValidateBakedRecords(const BakedAnimationSet* set) {
+    const BakedAnimationHeader* header = set->header;
+    for (uint32_t i = 0; i < header->sheetCount; i++) {
+        const BakedSpritesheet* sheet = &set->sheets[i];
+        if (BakedString(set, sheet->name) == NULL || BakedString(set, sheet->texture) == NULL ||
+            sheet->frameWidth == 0 || sheet->frameHeight == 0) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->clipCount; i++) {
+        const BakedAnimationClip* clip = &set->clips[i];
+        if (BakedString(set, clip->name) == NULL || clip->sheet >= header->sheetCount ||
+            clip->type > ANIMATION_SEQUENCE_PINGPONG || clip->frameCount == 0 ||
+            (uint64_t)clip->frames + clip->frameCount > header->frameCount ||
+            (uint64_t)clip->events + clip->eventCount > header->eventCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Map a blob written by the animation baker and register its sheets and
+// clips. Frame and event tables stay in the mapping.
+bool LoadBakedAnimations(BakedAnimationSet* set, const char* path) {
+    if (set == NULL || path == NULL) return false;
+    if (set->loaded) {
+        printf("Warning: Baked animations are already loaded.\n");
+        return false;
+    }
+    if (!IsHostLittleEndian()) {
+        printf("Error: Baked animations are only supported on little-endian hosts.\n");
+        return false;
+    }
+
+    MappedFile file;
+    if (!MapFile(path, &file)) return false;
+    const BakedAnimationHeader* header = (const BakedAnimationHeader*)file.data;
+    if (!ValidateBakedAnimations(&file, header)) {
+        UnmapFile(&file);
+        return false;
+    }
+    BakedAnimationSet view = {
+        .file = file,
+        .header = header,
+        .sheets = (const BakedSpritesheet*)(file.data + header->sheetsOffset),
+        .clips = (const BakedAnimationClip*)(file.data + header->clipsOffset),
+        .frames = (const BakedAnimationFrame*)(file.data + header->framesOffset),
+        .events = (const BakedAnimationEvent*)(file.data + header->eventsOffset),
+        .strings = (const char*)file.data + header->stringsOffset,
+        .loaded = true
+    };
+    if (!ValidateBakedRecords(&view)) {
+        printf("Error: Baked animation file is truncated or corrupt.\n");
+        UnmapFile(&file);
+        return false;
+    }
+    if (header->sheetCount > MAX_SPRITESHEETS || g_animationClips.count + header->clipCount > MAX_ANIMATION_CLIPS) {
+        printf("Error: %s has more sheets or clips than the registries hold.\n", path);
+        UnmapFile(&file);
+        return false;
+    }
+
+    // Sheets already loaded under the same name are shared
+    int sheetIds[MAX_SPRITESHEETS];
+    for (uint32_t i = 0; i < header->sheetCount; i++) {
+        const BakedSpritesheet* sheet = &view.sheets[i];
+        const char* name = view.strings + sheet->name;
+        sheetIds[i] = FindSpritesheet(name);
+        if (sheetIds[i] == SPRITESHEET_NONE) {
+            sheetIds[i] = CreateGridSpritesheet(name, view.strings + sheet->texture, sheet->frameWidth, sheet->frameHeight,
+                                                (int)sheet->frameCount, (Vector2){ sheet->pivotX, sheet->pivotY });
+        }
+    }
+
+    // Clips reference the mapping from here on, so it stays loaded even
+    // if some of them are rejected
+    int failed = 0;
+    for (uint32_t i = 0; i < header->clipCount; i++) {
+        const BakedAnimationClip* clip = &view.clips[i];
+        int clipId = RegisterAnimationClipFrames(view.strings + clip->name, sheetIds[clip->sheet],
+                                                 view.frames + clip->frames, (int)clip->frameCount, (AnimationSequenceType)clip->type,
+                                                 view.events + clip->events, (int)clip->eventCount);
+        if (clipId == ANIMATION_CLIP_NONE) failed++;
+    }
+
+    *set = view;
+    if (failed > 0) {
+        printf("Warning: %d of %u baked animation clips could not be registered.\n", failed, header->clipCount);
+    }
+    printf("✓ Baked animations loaded: %u clips on %u sheets\n", header->clipCount - (uint32_t)failed, header->sheetCount);
+    return true;
+}
+
+// Unmap the blob. Call after UnloadAnimationClips, since clips point into it.
+void UnloadBakedAnimations(BakedAnimationSet* set) {
+    if (set == NULL || !set->loaded) return;
+    UnmapFile(&set->file);
+    memset(set, 0, sizeof(BakedAnimationSet));
+}
@@ -0,0 +1,92 @@
+// =============================================================
+// Baked animation header
+// =============================================================
+// Runtime side of the animation data built by tools/anim_baker.c
+// (`make anim`). The baker compiles a text description of spritesheets,
+// clips and event markers into one blob. The blob is mapped and its
+// frame and event tables are used in place by the clips registered from
+// it, so loading does no parsing and no per-clip allocation.
+//
+// Blob layout, little-endian: a header, the sheet records, the clip
+// records, the frame table, the event table, then a string table of
+// NUL-terminated names and texture paths.
+#ifndef BAKED_ANIMATION_H
+#define BAKED_ANIMATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "animation_manager.h"
+#include "animation_events.h"
+#include "../util/file_utils.h"
+
+// Format constants
+#define BAKED_ANIMATION_MAGIC "RSAN"
+#define BAKED_ANIMATION_VERSION 1
+#define BAKED_ANIMATION_PATH "res/anim/animations.bin"
+
+// File header. Offsets are from the start of the file.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t sheetCount;
+    uint32_t clipCount;
+    uint32_t frameCount;
+    uint32_t eventCount;
+    uint32_t sheetsOffset;
+    uint32_t clipsOffset;
+    uint32_t framesOffset;
+    uint32_t eventsOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+} BakedAnimationHeader;
+
+// One grid spritesheet. A zero frame count fills the texture.
+typedef struct {
+    uint32_t name;      // Offset into the string table
+    uint32_t texture;   // Offset into the string table
+    uint16_t frameWidth;
+    uint16_t frameHeight;
+    uint32_t frameCount;
+    float pivotX;
+    float pivotY;
+} BakedSpritesheet;
+
+// One clip. frames and events index the blob's frame and event tables.
+typedef struct {
+    uint32_t name;      // Offset into the string table
+    uint16_t sheet;     // Index into the sheet records
+    uint8_t type;       // AnimationSequenceType
+    uint8_t reserved;
+    uint32_t frames;
+    uint32_t frameCount;
+    uint32_t events;
+    uint32_t eventCount;
+    float frameTime;
+} BakedAnimationClip;
+
+// Frame and event records are AnimationFrame and AnimationEventMarker,
+// so clips can point straight into the mapped tables
+typedef AnimationFrame BakedAnimationFrame;
+typedef AnimationEventMarker BakedAnimationEvent;
+
+// Loaded blob. Clips registered from it reference the mapping, so it
+// must stay loaded until UnloadAnimationClips.
+typedef struct {
+    MappedFile file;
+    const BakedAnimationHeader* header;
+    const BakedSpritesheet* sheets;
+    const BakedAnimationClip* clips;
+    const BakedAnimationFrame* frames;
+    const BakedAnimationEvent* events;
+    const char* strings;
+    bool loaded;
+} BakedAnimationSet;
+
+extern BakedAnimationSet g_bakedAnimations;
+
+// Baked animation functions
+bool LoadBakedAnimations(BakedAnimationSet* set, const char* path);
+void UnloadBakedAnimations(BakedAnimationSet* set);
+
+#endif // BAKED_ANIMATION_H
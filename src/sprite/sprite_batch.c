@@ -0,0 +1,243 @@
+// =============================================================
+// Sprite batch implementation
+// =============================================================
+// Texture-sorted sprite drawing.
+#include "sprite_batch.h"
+#include <math.h>
+#include <string.h>
+
+SpriteBatch g_spriteBatch = {0};
+
+// Sort key layout, most significant first: layer, texture id, blend mode
+#define SPRITE_KEY_LAYER_SHIFT 48
+#define SPRITE_KEY_TEXTURE_SHIFT 8
+
+static uint64_t MakeSpriteKey(int layer, unsigned int textureId, int blendMode) {
+    if (layer < SPRITE_LAYER_MIN) layer = SPRITE_LAYER_MIN;
+    if (layer > SPRITE_LAYER_MAX) layer = SPRITE_LAYER_MAX;
+    uint64_t biasedLayer = (uint64_t)(layer - SPRITE_LAYER_MIN);
+    return (biasedLayer << SPRITE_KEY_LAYER_SHIFT) |
+           ((uint64_t)textureId << SPRITE_KEY_TEXTURE_SHIFT) |
+           (uint64_t)(uint8_t)blendMode;
+}
+
+// Grow the per-item arrays to hold at least count items
+static bool ReserveSpriteBatch(SpriteBatch* batch, size_t count) {
+    if (count <= batch->capacity) return true;
+    size_t capacity = batch->capacity ? batch->capacity : 256;
+    while (capacity < count) capacity *= 2;
+    SpriteBatchItem* items = (SpriteBatchItem*)realloc(batch->items, capacity * sizeof(SpriteBatchItem));
+    if (items != NULL) batch->items = items;
+    uint64_t* keys = (uint64_t*)realloc(batch->keys, capacity * sizeof(uint64_t));
+    if (keys != NULL) batch->keys = keys;
+    uint64_t* keyScratch = (uint64_t*)realloc(batch->keyScratch, capacity * sizeof(uint64_t));
+    if (keyScratch != NULL) batch->keyScratch = keyScratch;
+    uint32_t* order = (uint32_t*)realloc(batch->order, capacity * sizeof(uint32_t));
+    if (order != NULL) batch->order = order;
+    uint32_t* orderScratch = (uint32_t*)realloc(batch->orderScratch, capacity * sizeof(uint32_t));
+    if (orderScratch != NULL) batch->orderScratch = orderScratch;
+    if (items == NULL || keys == NULL || keyScratch == NULL || order == NULL || orderScratch == NULL) {
+        printf("Error: Memory allocation for sprite batch failed.\n");
+        return false;
+    }
+    batch->capacity = capacity;
+    return true;
+}
+
+// Append a command, growing the command list if needed
+static bool PushSpriteBatchCommand(SpriteBatch* batch, SpriteBatchCommand command) {
+    if (batch->commandCount == batch->commandCapacity) {
+        size_t capacity = batch->commandCapacity ? batch->commandCapacity * 2 : 64;
+        SpriteBatchCommand* commands = (SpriteBatchCommand*)realloc(batch->commands, capacity * sizeof(SpriteBatchCommand));
+        if (commands == NULL) {
+            printf("Error: Memory allocation for sprite batch commands failed.\n");
+            return false;
+        }
+        batch->commands = commands;
+        batch->commandCapacity = capacity;
+    }
+    batch->commands[batch->commandCount++] = command;
+    return true;
+}
+
+// Stable LSD radix sort of the keys and item indices, one byte per pass.
+// Bytes that are the same in every key are skipped, so a typical frame
+// (one layer, a handful of small texture ids) sorts in one or two passes.
+static void RadixSortSpriteKeys(SpriteBatch* batch) {
+    size_t count = batch->count;
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < count; i++) {
+            offsets[(batch->keys[i] >> shift) & 0xFF]++;
+        }
+        if (offsets[(batch->keys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t total = 0;
+        for (size_t digit = 0; digit < 256; digit++) {
+            size_t digitCount = offsets[digit];
+            offsets[digit] = total;
+            total += digitCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = offsets[(batch->keys[i] >> shift) & 0xFF]++;
+            batch->keyScratch[slot] = batch->keys[i];
+            batch->orderScratch[slot] = batch->order[i];
+        }
+
+        // The scratch arrays hold the result now; swap them in
+        uint64_t* keys = batch->keys;
+        batch->keys = batch->keyScratch;
+        batch->keyScratch = keys;
+        uint32_t* order = batch->order;
+        batch->order = batch->orderScratch;
+        batch->orderScratch = order;
+    }
+}
+
+// Initialize an empty batch
+void InitSpriteBatch(SpriteBatch* batch) {
+    if (batch == NULL) return;
+    memset(batch, 0, sizeof(SpriteBatch));
+}
+
+// Start collecting a new frame's sprites. Culling is off until a view is set.
+void BeginSpriteBatch(SpriteBatch* batch) {
+    if (batch == NULL) return;
+    batch->count = 0;
+    batch->commandCount = 0;
+    batch->culling = false;
+    batch->culledCount = 0;
+}
+
+// Drop items outside a world-space view from here until the next Begin
+void SetSpriteBatchView(SpriteBatch* batch, Rectangle view) {
+    if (batch == NULL) return;
+    batch->view = view;
+    batch->culling = true;
+}
+
+// Axis-aligned bounds of a quad as DrawTexturePro places it: origin is
+// the pivot inside dest, and the quad rotates about (dest.x, dest.y)
+Rectangle GetSpriteDrawBounds(Rectangle dest, Vector2 origin, float rotation) {
+    if (rotation == 0.0f) {
+        return (Rectangle){ dest.x - origin.x, dest.y - origin.y, dest.width, dest.height };
+    }
+    // Rotate the quad's center about the pivot; the half extents of a
+    // rotated box are |cos| and |sin| mixes of its own
+    float angle = rotation * DEG2RAD;
+    float c = cosf(angle);
+    float s = sinf(angle);
+    float centerX = dest.width * 0.5f - origin.x;
+    float centerY = dest.height * 0.5f - origin.y;
+    float worldX = dest.x + centerX * c - centerY * s;
+    float worldY = dest.y + centerX * s + centerY * c;
+    float halfWidth = 0.5f * (fabsf(dest.width * c) + fabsf(dest.height * s));
+    float halfHeight = 0.5f * (fabsf(dest.width * s) + fabsf(dest.height * c));
+    return (Rectangle){ worldX - halfWidth, worldY - halfHeight, halfWidth * 2.0f, halfHeight * 2.0f };
+}
+
+bool IsRectangleInView(Rectangle bounds, Rectangle view) {
+    return bounds.x <= view.x + view.width && view.x <= bounds.x + bounds.width &&
+           bounds.y <= view.y + view.height && view.y <= bounds.y + bounds.height;
+}
+
+// Queue one textured quad. Draws without a texture, or outside the view, are dropped.
+void AddSpriteBatchItem(SpriteBatch* batch, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, int layer, int blendMode) {
+    if (batch == NULL || texture.id == 0) return;
+    if (batch->culling && !IsRectangleInView(GetSpriteDrawBounds(dest, origin, rotation), batch->view)) {
+        batch->culledCount++;
+        return;
+    }
+    if (batch->count >= UINT32_MAX || !ReserveSpriteBatch(batch, batch->count + 1)) return;
+    size_t index = batch->count++;
+    batch->items[index] = (SpriteBatchItem){ texture, source, dest, origin, rotation, tint, blendMode };
+    batch->keys[index] = MakeSpriteKey(layer, texture.id, blendMode);
+}
+
+// Queue a sprite object the way DrawSpriteObject would draw it
+void AddSpriteObjectToBatch(SpriteBatch* batch, const SpriteObject* sprite) {
+    if (sprite == NULL || !sprite->visible) return;
+    Rectangle source = GetSpriteObjectSourceRec(sprite);
+    Rectangle dest = { sprite->position.x, sprite->position.y, source.width * sprite->scale.x, source.height * sprite->scale.y };
+    AddSpriteBatchItem(batch, sprite->texture, source, dest, GetSpriteObjectOrigin(sprite), sprite->rotation, sprite->tint,
+                       sprite->layer, sprite->blendMode);
+}
+
+// Sort the queued items and build the command stream. Items with equal
+// keys keep the order they were added in.
+void SortSpriteBatch(SpriteBatch* batch) {
+    if (batch == NULL) return;
+    batch->commandCount = 0;
+    batch->stats = (SpriteBatchStats){0};
+    batch->stats.culled = batch->culledCount;
+    if (batch->count == 0) return;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        batch->order[i] = (uint32_t)i;
+    }
+    RadixSortSpriteKeys(batch);
+
+    // A new command starts whenever the texture or blend mode changes;
+    // a layer change alone does not need one
+    unsigned int textureId = 0;
+    int blendMode = BLEND_ALPHA;
+    for (size_t i = 0; i < batch->count; i++) {
+        const SpriteBatchItem* item = &batch->items[batch->order[i]];
+        SpriteBatchCommand* last = batch->commandCount > 0 ? &batch->commands[batch->commandCount - 1] : NULL;
+        if (last != NULL && last->texture.id == item->texture.id && last->blendMode == item->blendMode) {
+            last->count++;
+            continue;
+        }
+        if (!PushSpriteBatchCommand(batch, (SpriteBatchCommand){ item->texture, item->blendMode, (uint32_t)i, 1 })) {
+            break;
+        }
+        if (item->texture.id != textureId) batch->stats.textureBinds++;
+        if (item->blendMode != blendMode) batch->stats.blendChanges++;
+        textureId = item->texture.id;
+        blendMode = item->blendMode;
+    }
+    batch->stats.sprites = batch->count;
+    batch->stats.drawCalls = batch->commandCount;
+}
+
+// Draw the command stream built by SortSpriteBatch
+void SubmitSpriteBatch(const SpriteBatch* batch) {
+    if (batch == NULL) return;
+    int blendMode = BLEND_ALPHA;
+    for (size_t c = 0; c < batch->commandCount; c++) {
+        const SpriteBatchCommand* command = &batch->commands[c];
+        if (command->blendMode != blendMode) {
+            if (blendMode != BLEND_ALPHA) EndBlendMode();
+            if (command->blendMode != BLEND_ALPHA) BeginBlendMode(command->blendMode);
+            blendMode = command->blendMode;
+        }
+        for (uint32_t i = command->first; i < command->first + command->count; i++) {
+            const SpriteBatchItem* item = &batch->items[batch->order[i]];
+            DrawTexturePro(item->texture, item->source, item->dest, item->origin, item->rotation, item->tint);
+        }
+    }
+    if (blendMode != BLEND_ALPHA) EndBlendMode();
+}
+
+// Sort and draw everything queued since BeginSpriteBatch
+void EndSpriteBatch(SpriteBatch* batch) {
+    SortSpriteBatch(batch);
+    SubmitSpriteBatch(batch);
+}
+
+SpriteBatchStats GetSpriteBatchStats(const SpriteBatch* batch) {
+    if (batch == NULL) return (SpriteBatchStats){0};
+    return batch->stats;
+}
+
+// Release the batch's storage
+void FreeSpriteBatch(SpriteBatch* batch) {
+    if (batch == NULL) return;
+    free(batch->items);
+    free(batch->keys);
+    free(batch->order);
+    free(batch->keyScratch);
+    free(batch->orderScratch);
+    free(batch->commands);
+    InitSpriteBatch(batch);
+}
@@ -0,0 +1,86 @@
+// =============================================================
+// Sprite batch header
+// =============================================================
+// Collects a frame's sprite draws, sorts them by (layer, texture, blend
+// mode) and draws them one texture run at a time, so rlgl only flushes
+// when the texture or blend mode really changes. Sorting and drawing are
+// separate steps, so the command stream can be inspected without a window.
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "raylib.h"
+#include "sprite_object.h"
+#include "../util/globals.h"
+
+// Layers are clamped to this range; higher layers draw on top
+#define SPRITE_LAYER_MIN INT16_MIN
+#define SPRITE_LAYER_MAX INT16_MAX
+
+// One queued sprite draw
+typedef struct {
+    Texture2D texture;
+    Rectangle source;
+    Rectangle dest;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+    int blendMode;
+} SpriteBatchItem;
+
+// Run of sorted items sharing a texture and blend mode. Items are
+// order[first .. first + count) in the batch.
+typedef struct {
+    Texture2D texture;
+    int blendMode;
+    uint32_t first;
+    uint32_t count;
+} SpriteBatchCommand;
+
+// Counters for the last sorted batch
+typedef struct {
+    size_t sprites;       // Drawn
+    size_t culled;        // Rejected by the view rectangle, plus invisible static sprites
+    size_t drawCalls;     // Commands, each one rlgl batch
+    size_t textureBinds;
+    size_t blendChanges;
+} SpriteBatchStats;
+
+// Sprite batch. Storage is kept between frames.
+typedef struct {
+    SpriteBatchItem* items;
+    uint64_t* keys;           // Sort key per item: layer, texture id, blend mode
+    uint32_t* order;          // Item indices, sorted by SortSpriteBatch
+    uint64_t* keyScratch;
+    uint32_t* orderScratch;
+    size_t count;
+    size_t capacity;
+
+    SpriteBatchCommand* commands;
+    size_t commandCount;
+    size_t commandCapacity;
+    SpriteBatchStats stats;
+
+    // World-space view; items entirely outside it are dropped when added
+    Rectangle view;
+    bool culling;
+    size_t culledCount;
+} SpriteBatch;
+
+// Shared batch used by DrawSprites and DrawEntities
+extern SpriteBatch g_spriteBatch;
+
+// Sprite batch functions
+void InitSpriteBatch(SpriteBatch* batch);
+void BeginSpriteBatch(SpriteBatch* batch);
+void SetSpriteBatchView(SpriteBatch* batch, Rectangle view);
+Rectangle GetSpriteDrawBounds(Rectangle dest, Vector2 origin, float rotation);
+bool IsRectangleInView(Rectangle bounds, Rectangle view);
+void AddSpriteBatchItem(SpriteBatch* batch, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, int layer, int blendMode);
+void AddSpriteObjectToBatch(SpriteBatch* batch, const SpriteObject* sprite);
+void SortSpriteBatch(SpriteBatch* batch);
+void SubmitSpriteBatch(const SpriteBatch* batch);
+void EndSpriteBatch(SpriteBatch* batch);
+SpriteBatchStats GetSpriteBatchStats(const SpriteBatch* batch);
+void FreeSpriteBatch(SpriteBatch* batch);
+
+#endif // SPRITE_BATCH_H
@@ -3,6 +3,7 @@
 // =============================================================
 // This file is part of the manager instances in globals.h
 #include "sprite_manager.h"
+#include "animation_clip.h"
 #include <string.h>
 
 SpriteManager* g_spriteManager = NULL;
@@ -14,6 +15,13 @@ void InitSpriteManager(SpriteManager* manager) {
     for (int i = 0; i < MAX_SPRITES; i++) {
         manager->sprites[i] = NULL;
     }
+    InitEntitySpatialGrid(&manager->staticGrid, SPRITE_GRID_CELL_SIZE);
+    manager->staticCount = 0;
+    manager->staticGridDirty = true;
+    manager->animationLod = false;
+    manager->animationFrame = 0;
+    manager->reducedInterval = ANIMATION_LOD_REDUCED_INTERVAL;
+    manager->animationStats = (AnimationLodStats){0};
 }
 
 void AddSprite(SpriteManager* manager, SpriteObject* sprite) {
@@ -23,14 +31,15 @@ void AddSprite(SpriteManager* manager, SpriteObject* sprite) {
         return;
     }
     manager->sprites[manager->spriteCount++] = sprite;
+    if (sprite->isStatic) manager->staticGridDirty = true;
 }
 
 void RemoveSprite(SpriteManager* manager, int spriteId) {
     if (manager == NULL) return;
     for (int i = 0; i < manager->spriteCount; i++) {
         if (manager->sprites[i] != NULL && manager->sprites[i]->id == spriteId) {
-            UnloadTexture(manager->sprites[i]->texture);
-            free(manager->sprites[i]);
+            if (manager->sprites[i]->isStatic) manager->staticGridDirty = true;
+            UnloadSpriteObject(manager->sprites[i]);
             manager->sprites[i] = NULL;
             // Shift remaining sprites
             for (int j = i; j < manager->spriteCount - 1; j++) {
@@ -43,62 +52,198 @@ void RemoveSprite(SpriteManager* manager, int spriteId) {
     printf("Warning: Sprite with ID %d not found.\n", spriteId);
 }
 
+// Quad a managed sprite is drawn with, the same one DrawSpriteObject and
+// the sprite batch use
+static void GetManagedSpriteQuad(const SpriteObject* sprite, Rectangle* source, Rectangle* dest, Vector2* origin) {
+    *source = GetSpriteObjectSourceRec(sprite);
+    *origin = GetSpriteObjectOrigin(sprite);
+    *dest = (Rectangle){ sprite->position.x, sprite->position.y, source->width * sprite->scale.x, source->height * sprite->scale.y };
+}
+
+// How often a sprite's animation is resolved: every frame inside the
+// animation view, every Nth frame within the margin around it, and only
+// once back in range beyond that or while invisible
+static AnimationLod GetSpriteAnimationLod(const SpriteManager* manager, const SpriteObject* sprite) {
+    if (!sprite->visible) return ANIMATION_LOD_DEFERRED;
+    if (!manager->animationLod) return ANIMATION_LOD_EAGER;
+    Rectangle source, dest;
+    Vector2 origin;
+    GetManagedSpriteQuad(sprite, &source, &dest, &origin);
+    Rectangle bounds = GetSpriteDrawBounds(dest, origin, sprite->rotation);
+    if (IsRectangleInView(bounds, manager->animationView)) return ANIMATION_LOD_EAGER;
+    Rectangle margin = {
+        manager->animationView.x - manager->animationMargin, manager->animationView.y - manager->animationMargin,
+        manager->animationView.width + 2.0f * manager->animationMargin, manager->animationView.height + 2.0f * manager->animationMargin
+    };
+    return IsRectangleInView(bounds, margin) ? ANIMATION_LOD_REDUCED : ANIMATION_LOD_DEFERRED;
+}
+
+// Advance sprite animations. Sprites held back by animation LOD only
+// accumulate time and catch up in O(1) when they are next resolved.
 void UpdateSprites(SpriteManager* manager, float deltaTime) {
     if (manager == NULL) return;
+    bool reducedDue = manager->animationFrame++ % (manager->reducedInterval ? manager->reducedInterval : 1) == 0;
+    manager->animationStats = (AnimationLodStats){0};
     for (int i = 0; i < manager->spriteCount; i++) {
         SpriteObject* sprite = manager->sprites[i];
-        if (sprite != NULL && sprite->animating) {
-            sprite->frameTimer += deltaTime;
-            if (sprite->frameTimer >= sprite->frameTime) {
-                sprite->currentFrame = (sprite->currentFrame + 1) % sprite->totalFrames;
-                sprite->frameTimer = 0.0f;
-            }
+        if (sprite == NULL || !sprite->animating) continue;
+        sprite->frameTimer += deltaTime;
+        AnimationLod lod = GetSpriteAnimationLod(manager, sprite);
+        if (lod == ANIMATION_LOD_EAGER || (lod == ANIMATION_LOD_REDUCED && reducedDue)) {
+            ResolveSpriteAnimation(sprite);
+            manager->animationStats.eager++;
+        } else {
+            manager->animationStats.deferred++;
         }
     }
 }
 
+// Resolve sprite animations every frame only inside a world-space view,
+// e.g. from GetGameCameraViewRect; see GetSpriteAnimationLod
+void SetSpriteAnimationView(SpriteManager* manager, Rectangle view, float reducedMargin) {
+    if (manager == NULL) return;
+    manager->animationLod = true;
+    manager->animationView = view;
+    manager->animationMargin = reducedMargin > 0.0f ? reducedMargin : 0.0f;
+}
+
+void ClearSpriteAnimationView(SpriteManager* manager) {
+    if (manager != NULL) manager->animationLod = false;
+}
+
+AnimationLodStats GetSpriteAnimationStats(const SpriteManager* manager) {
+    if (manager == NULL) return (AnimationLodStats){0};
+    return manager->animationStats;
+}
+
+static void AddManagedSprite(SpriteBatch* batch, const SpriteObject* sprite) {
+    Rectangle source, dest;
+    Vector2 origin;
+    GetManagedSpriteQuad(sprite, &source, &dest, &origin);
+    AddSpriteBatchItem(batch, sprite->texture, source, dest, origin, sprite->rotation, sprite->tint, sprite->layer, sprite->blendMode);
+}
+
+// Draw all visible sprites through the shared batch, grouped by texture
 void DrawSprites(const SpriteManager* manager) {
     if (manager == NULL) return;
+    BeginSpriteBatch(&g_spriteBatch);
+    BatchSprites(manager, &g_spriteBatch);
+    EndSpriteBatch(&g_spriteBatch);
+}
+
+// Queue all visible sprites into a batch
+void BatchSprites(const SpriteManager* manager, SpriteBatch* batch) {
+    if (manager == NULL || batch == NULL) return;
     for (int i = 0; i < manager->spriteCount; i++) {
         SpriteObject* sprite = manager->sprites[i];
         if (sprite != NULL && sprite->visible) {
-            Rectangle sourceRec = GetRectangleByFrameIndex(sprite->currentFrame);
-            Vector2 origin = sprite->origin;
-            DrawTexturePro(sprite->texture, sourceRec, (Rectangle){ sprite->position.x, sprite->position.y, sourceRec.width * sprite->scale.x, sourceRec.height * sprite->scale.y }, origin, sprite->rotation, sprite->tint);
+            AddManagedSprite(batch, sprite);
+        }
+    }
+}
+
+// Draw only the sprites overlapping a world-space view, e.g. from GetGameCameraViewRect
+void DrawSpritesInView(SpriteManager* manager, Rectangle view) {
+    if (manager == NULL) return;
+    BeginSpriteBatch(&g_spriteBatch);
+    BatchSpritesInView(manager, &g_spriteBatch, view);
+    EndSpriteBatch(&g_spriteBatch);
+}
+
+// Rebuild the static sprite grid from the sprites' current bounds
+static void RebuildStaticSpriteGrid(SpriteManager* manager) {
+    manager->staticCount = 0;
+    for (int i = 0; i < manager->spriteCount; i++) {
+        if (manager->sprites[i] != NULL && manager->sprites[i]->isStatic) {
+            manager->staticSprites[manager->staticCount++] = manager->sprites[i];
         }
     }
+    if (!ReserveEntitySpatialGrid(&manager->staticGrid, (size_t)manager->staticCount)) return;
+    for (int i = 0; i < manager->staticCount; i++) {
+        Rectangle source, dest;
+        Vector2 origin;
+        GetManagedSpriteQuad(manager->staticSprites[i], &source, &dest, &origin);
+        manager->staticGrid.bounds[i] = GetSpriteDrawBounds(dest, origin, manager->staticSprites[i]->rotation);
+    }
+    BuildEntitySpatialGrid(&manager->staticGrid, (size_t)manager->staticCount);
+    manager->staticGridDirty = false;
 }
 
+// Queue the visible sprites overlapping a view. Moving sprites are tested
+// one by one; static ones come from a grid query.
+void BatchSpritesInView(SpriteManager* manager, SpriteBatch* batch, Rectangle view) {
+    if (manager == NULL || batch == NULL) return;
+    SetSpriteBatchView(batch, view);
+    for (int i = 0; i < manager->spriteCount; i++) {
+        SpriteObject* sprite = manager->sprites[i];
+        if (sprite != NULL && sprite->visible && !sprite->isStatic) {
+            AddManagedSprite(batch, sprite);
+        }
+    }
+
+    if (manager->staticGridDirty) RebuildStaticSpriteGrid(manager);
+    if (manager->staticGridDirty) {
+        // The grid could not be built; test static sprites one by one
+        for (int i = 0; i < manager->spriteCount; i++) {
+            SpriteObject* sprite = manager->sprites[i];
+            if (sprite != NULL && sprite->visible && sprite->isStatic) AddManagedSprite(batch, sprite);
+        }
+        return;
+    }
+    // Every static sprite is either drawn or culled. Grid misses are not
+    // checked for visibility, so invisible hits count as culled as well.
+    size_t found = QueryEntitySpatialGrid(&manager->staticGrid, view, manager->staticRows, MAX_SPRITES);
+    batch->culledCount += (size_t)manager->staticCount - found;
+    for (size_t i = 0; i < found; i++) {
+        const SpriteObject* sprite = manager->staticSprites[manager->staticRows[i]];
+        if (sprite->visible) {
+            AddManagedSprite(batch, sprite);
+        } else {
+            batch->culledCount++;
+        }
+    }
+}
+
+// Static sprites are found through a grid, so only the ones in cells the
+// view touches are view-tested. They must not move, rotate or resize
+// without MarkStaticSpritesDirty.
+void SetSpriteStatic(SpriteManager* manager, SpriteObject* sprite, bool isStatic) {
+    if (sprite == NULL || sprite->isStatic == isStatic) return;
+    sprite->isStatic = isStatic;
+    if (manager != NULL) manager->staticGridDirty = true;
+}
+
+void MarkStaticSpritesDirty(SpriteManager* manager) {
+    if (manager != NULL) manager->staticGridDirty = true;
+}
+
+// Fallback for sprites without a spritesheet: 64x64 frames in one row
 Rectangle GetRectangleByFrameIndex(int frameIndex) {
-    // Assuming each frame is 64x64 pixels for simplicity
     int frameWidth = 64;
     int frameHeight = 64;
     return (Rectangle){ frameIndex * frameWidth, 0, frameWidth, frameHeight };
 }
 
+// Shared texture of a registered animation clip. Never loads; unknown
+// clips give an empty texture.
 Texture2D GetTextureByAnimation(char* animationName) {
-    (void)animationName; // Suppress unused parameter warning
-    // Placeholder function: In a real implementation, this would look up the texture based on the animation name
-    // For now, return a dummy texture
-    Texture2D dummyTexture = LoadTexture("path/to/dummy.png");
-    return dummyTexture;
+    return GetAnimationClipTexture(FindAnimationClip(animationName));
 }
 
 void LoadSprite(SpriteManager* manager, const char* filePath, int id, const char* name, Vector2 position, Vector2 scale, Color tint, float rotation, SpriteType type) {
     if (manager == NULL || filePath == NULL || name == NULL) return;
-    SpriteObject* sprite = (SpriteObject*)malloc(sizeof(SpriteObject));
+    SpriteObject* sprite = CreateSpriteObject();
     if (sprite == NULL) {
         printf("Error: Memory allocation for sprite failed.\n");
         return;
     }
-    memset(sprite, 0, sizeof(SpriteObject));
     sprite->id = id;
     strncpy(sprite->name, name, MAX_SPRITE_NAME_LENGTH - 1);
     sprite->name[MAX_SPRITE_NAME_LENGTH - 1] = '\0';
-    sprite->texture = LoadTexture(filePath);
-    if (sprite->texture.id == 0) {
+    // Sprites loaded from the same file share one texture
+    if (!LoadSpriteObjectTexture(sprite, filePath)) {
         printf("Error: Failed to load texture from %s\n", filePath);
-        free(sprite);
+        DestroySpriteObject(sprite);
         return;
     }
     sprite->position = position;
@@ -113,6 +258,9 @@ void LoadSprite(SpriteManager* manager, const char* filePath, int id, const char
     sprite->frameTimer = 0.0f;
     sprite->animating = false;
     sprite->origin = (Vector2){ 0.0f, 0.0f }; // Top-left by default
+    sprite->isStatic = false;
+    sprite->layer = 0;
+    sprite->blendMode = BLEND_ALPHA;
 
     AddSprite(manager, sprite);
 }
@@ -121,12 +269,18 @@ void UnloadAllSprites(SpriteManager* manager) {
     if (manager == NULL) return;
     for (int i = 0; i < manager->spriteCount; i++) {
         if (manager->sprites[i] != NULL) {
-            UnloadTexture(manager->sprites[i]->texture);
-            free(manager->sprites[i]);
+            UnloadSpriteObject(manager->sprites[i]);
             manager->sprites[i] = NULL;
         }
     }
+    // With every sprite gone the pool can restart from its first slab
+    if (g_spriteObjectPool.liveCount == 0) {
+        ResetMemoryPool(&g_spriteObjectPool);
+    }
     manager->spriteCount = 0;
+    FreeEntitySpatialGrid(&manager->staticGrid);
+    manager->staticCount = 0;
+    manager->staticGridDirty = true;
     manager->state = SPRITE_MANAGER_UNINITIALIZED;
 }
 
@@ -7,12 +7,16 @@
 
 #include "raylib.h"
 #include "sprite_object.h"
+#include "sprite_batch.h"
+#include "animator_store.h"
+#include "../entity/entity_spatial.h"
 #include "../util/globals.h"
 
 // Sprite manager constants
 #define MAX_SPRITES 256
 #define MAX_SPRITES_PER_TYPE 64
 #define MAX_SPRITE_NAME_LENGTH 64
+#define SPRITE_GRID_CELL_SIZE 256.0f
 
 // Sprite manager state enum
 typedef enum {
@@ -25,6 +29,21 @@ typedef struct {
     SpriteObject* sprites[MAX_SPRITES];
     int spriteCount;
     SpriteManagerState state;
+
+    // Static sprites are culled through a grid, rebuilt when they change
+    EntitySpatialGrid staticGrid;
+    SpriteObject* staticSprites[MAX_SPRITES];   // Grid rows
+    uint32_t staticRows[MAX_SPRITES];           // Query results
+    int staticCount;
+    bool staticGridDirty;
+
+    // Optional animation LOD around a view, see SetSpriteAnimationView
+    bool animationLod;
+    Rectangle animationView;
+    float animationMargin;      // Sprites this far outside the view animate at the reduced rate
+    uint32_t animationFrame;
+    uint32_t reducedInterval;
+    AnimationLodStats animationStats;
 } SpriteManager;
 
 // Sprite manager functions
@@ -33,6 +52,14 @@ void AddSprite(SpriteManager* manager, SpriteObject* sprite);
 void RemoveSprite(SpriteManager* manager, int spriteId);
 void UpdateSprites(SpriteManager* manager, float deltaTime);
 void DrawSprites(const SpriteManager* manager);
+void BatchSprites(const SpriteManager* manager, SpriteBatch* batch);
+void DrawSpritesInView(SpriteManager* manager, Rectangle view);
+void BatchSpritesInView(SpriteManager* manager, SpriteBatch* batch, Rectangle view);
+void SetSpriteStatic(SpriteManager* manager, SpriteObject* sprite, bool isStatic);
+void MarkStaticSpritesDirty(SpriteManager* manager);
+void SetSpriteAnimationView(SpriteManager* manager, Rectangle view, float reducedMargin);
+void ClearSpriteAnimationView(SpriteManager* manager);
+AnimationLodStats GetSpriteAnimationStats(const SpriteManager* manager);
 Rectangle GetRectangleByFrameIndex(int frameIndex);
 Texture2D GetTextureByAnimation(char* animationName);
 void LoadSprite(SpriteManager* manager, const char* filePath, int id, const char* name, Vector2 position, Vector2 scale, Color tint, float rotation, SpriteType type);
@@ -3,18 +3,62 @@
 // =============================================================
 // Used for rendering sprites in 2D space with position, scale, rotation, and texture
 #include "sprite_object.h"
+#include "animation_manager.h"
+#include "../util/asset_manager.h"
+#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+MemoryPool g_spriteObjectPool = {0};
+
+// Set up the sprite pool on first use
+static bool EnsureSpriteObjectPool(void) {
+    return g_spriteObjectPool.initialized ||
+           InitMemoryPool(&g_spriteObjectPool, "SpriteObject", sizeof(SpriteObject), SPRITE_POOL_SLAB_SIZE);
+}
+
+// Allocate a zeroed sprite object from the sprite pool
+SpriteObject* CreateSpriteObject(void) {
+    if (!EnsureSpriteObjectPool()) return NULL;
+    SpriteObject* sprite = (SpriteObject*)PoolAlloc(&g_spriteObjectPool);
+    if (sprite) {
+        memset(sprite, 0, sizeof(SpriteObject));
+        sprite->textureHandle = ASSET_TEXTURE_NONE;
+        sprite->atlasEntry = TEXTURE_ATLAS_ENTRY_NONE;
+    }
+    return sprite;
+}
+
+// Release a sprite object's memory. Sprites not created by
+// CreateSpriteObject are assumed to come from malloc.
+void DestroySpriteObject(SpriteObject* sprite) {
+    if (!sprite) return;
+    if (PoolOwns(&g_spriteObjectPool, sprite)) {
+        PoolFree(&g_spriteObjectPool, sprite);
+    } else {
+        free(sprite);
+    }
+}
+
+// Make sure count more sprites can be created without growing the pool
+bool ReserveSpriteObjects(size_t count) {
+    if (!EnsureSpriteObjectPool()) return false;
+    return ReserveMemoryPool(&g_spriteObjectPool, g_spriteObjectPool.liveCount + count);
+}
+
 // Initialize a sprite object with given parameters
 void InitSpriteObject(SpriteObject* sprite, int id, const char* name, Texture2D texture, Vector2 position, Vector2 scale, Color tint, float rotation, SpriteType type) {
     if (!sprite) return;
 
     sprite->id = id;
-    sprite->name = (char*)malloc(MAX_SPRITE_NAME_LENGTH);
     strncpy(sprite->name, name, MAX_SPRITE_NAME_LENGTH - 1);
     sprite->name[MAX_SPRITE_NAME_LENGTH - 1] = '\0'; // Ensure null-termination
     sprite->texture = texture;
+    sprite->textureHandle = ASSET_TEXTURE_NONE;
+    sprite->sharedTexture = false;
+    sprite->region = (Rectangle){0};
+    sprite->atlasEntry = TEXTURE_ATLAS_ENTRY_NONE;
     sprite->position = position;
     sprite->scale = scale;
     sprite->tint = tint;
@@ -27,38 +71,92 @@ void InitSpriteObject(SpriteObject* sprite, int id, const char* name, Texture2D
     sprite->frameTime = 0.1f; // Default to 0.1s per frame
     sprite->frameTimer = 0.0f;
     sprite->animating = false;
+    sprite->sequenceType = ANIMATION_SEQUENCE_LOOP;
+    sprite->reversing = false;
     sprite->origin = (Vector2){ texture.width / 2.0f, texture.height / 2.0f }; // Center origin
+    sprite->frames = NULL;
+    sprite->frameTableSize = 0;
+
+    sprite->isStatic = false;
+    sprite->layer = 0;
+    sprite->blendMode = BLEND_ALPHA;
 }
 
-// Update the sprite object (handle animation)
+// Update the sprite object (handle animation). Invisible sprites only
+// accumulate time; their frame is resolved once they are visible again.
 void UpdateSpriteObject(SpriteObject* sprite, float deltaTime) {
-    if (!sprite || !sprite->visible) return;
+    if (!sprite) return;
 
     if (sprite->animating && sprite->totalFrames > 1) {
         sprite->frameTimer += deltaTime;
-        if (sprite->frameTimer >= sprite->frameTime) {
-            sprite->frameTimer -= sprite->frameTime;
-            sprite->currentFrame = (sprite->currentFrame + 1) % sprite->totalFrames;
-        }
+        if (sprite->visible) ResolveSpriteAnimation(sprite);
     }
 }
 
-// Draw the sprite object
-void DrawSpriteObject(const SpriteObject* sprite) {
-    if (!sprite || !sprite->visible) return;
+// Apply the accumulated frame time in O(1), however much of it there is
+void ResolveSpriteAnimation(SpriteObject* sprite) {
+    if (!sprite || sprite->totalFrames <= 0 || sprite->frameTime <= 0.0f) return;
+    if (sprite->frameTimer < sprite->frameTime) return;
+    float steps = floorf(sprite->frameTimer / sprite->frameTime);
+    sprite->frameTimer -= steps * sprite->frameTime;
+    if (sprite->frameTimer < 0.0f) sprite->frameTimer = 0.0f;
+    int last = sprite->totalFrames - 1;
+    if (sprite->sequenceType == ANIMATION_SEQUENCE_ONCE) {
+        // Hold the last frame once it is reached
+        if (steps >= (float)(last - sprite->currentFrame)) {
+            sprite->currentFrame = last;
+            sprite->frameTimer = 0.0f;
+            sprite->animating = false;
+        } else {
+            sprite->currentFrame += (int)steps;
+        }
+    } else if (sprite->sequenceType == ANIMATION_SEQUENCE_PINGPONG && last > 0) {
+        // Positions are a phase in [0, period): up the frames, then down
+        int period = 2 * last;
+        int phase = sprite->reversing ? (period - sprite->currentFrame) % period : sprite->currentFrame;
+        phase = (phase + (int)fmodf(steps, (float)period)) % period;
+        sprite->currentFrame = last - abs(phase - last);
+        sprite->reversing = phase > last;
+    } else {
+        sprite->currentFrame = (sprite->currentFrame + (int)fmodf(steps, (float)sprite->totalFrames)) % sprite->totalFrames;
+    }
+}
 
-    Rectangle sourceRec = { 0.0f, 0.0f, (float)sprite->texture.width, (float)sprite->texture.height };
+// Source rectangle of the current frame; frames are laid out horizontally
+// across the sprite's region of the texture
+Rectangle GetSpriteObjectSourceRec(const SpriteObject* sprite) {
+    if (!sprite) return (Rectangle){0};
+    if (sprite->frames != NULL) return sprite->frames[sprite->currentFrame].source;
+    Rectangle sourceRec = sprite->region;
+    if (sourceRec.width <= 0.0f || sourceRec.height <= 0.0f) {
+        sourceRec = (Rectangle){ 0.0f, 0.0f, (float)sprite->texture.width, (float)sprite->texture.height };
+    }
     if (sprite->totalFrames > 1) {
-        float frameWidth = (float)sprite->texture.width / (float)sprite->totalFrames;
-        sourceRec.x = frameWidth * sprite->currentFrame;
+        float frameWidth = sourceRec.width / (float)sprite->totalFrames;
+        sourceRec.x += frameWidth * sprite->currentFrame;
         sourceRec.width = frameWidth;
     }
+    return sourceRec;
+}
+
+// Draw origin of the current frame. Spritesheet pivots scale with the sprite.
+Vector2 GetSpriteObjectOrigin(const SpriteObject* sprite) {
+    if (!sprite) return (Vector2){0};
+    if (sprite->frames == NULL) return sprite->origin;
+    Vector2 origin = sprite->frames[sprite->currentFrame].origin;
+    return (Vector2){ origin.x * sprite->scale.x, origin.y * sprite->scale.y };
+}
+
+// Draw the sprite object
+void DrawSpriteObject(const SpriteObject* sprite) {
+    if (!sprite || !sprite->visible) return;
 
+    Rectangle sourceRec = GetSpriteObjectSourceRec(sprite);
     DrawTexturePro(
         sprite->texture,
         sourceRec,
         (Rectangle){ sprite->position.x, sprite->position.y, sourceRec.width * sprite->scale.x, sourceRec.height * sprite->scale.y },
-        sprite->origin,
+        GetSpriteObjectOrigin(sprite),
         sprite->rotation,
         sprite->tint
     );
@@ -90,10 +188,22 @@ void SetRotation(SpriteObject* sprite, float rotation) {
     sprite->rotation = rotation;
 }
 
+void SetSpriteLayer(SpriteObject* sprite, int layer) {
+    if (!sprite) return;
+    sprite->layer = layer;
+}
+
+void SetSpriteBlendMode(SpriteObject* sprite, int blendMode) {
+    if (!sprite) return;
+    sprite->blendMode = blendMode;
+}
+
 // Animation control functions
 void StartAnimation(SpriteObject* sprite, int totalFrames, float frameTime) {
     if (!sprite || totalFrames <= 1 || frameTime <= 0.0f) return;
-    sprite->totalFrames = (totalFrames > MAX_SPRITE_FRAMES) ? MAX_SPRITE_FRAMES : totalFrames;
+    // Spritesheet sprites can play any frame of their sheet
+    int maxFrames = sprite->frames != NULL ? sprite->frameTableSize : MAX_SPRITE_FRAMES;
+    sprite->totalFrames = (totalFrames > maxFrames) ? maxFrames : totalFrames;
     sprite->frameTime = frameTime;
     sprite->currentFrame = 0;
     sprite->frameTimer = 0.0f;
@@ -113,3 +223,91 @@ void SetSpriteAnimationFrame(SpriteObject* sprite, int frame) {
     sprite->frameTimer = 0.0f;
 }
 
+// Drop the sprite's current texture: release a shared one, unload an owned one
+static void DropSpriteTexture(SpriteObject* sprite) {
+    if (sprite->sharedTexture) {
+        ReleaseAssetTexture(sprite->textureHandle);
+    } else if (sprite->texture.id != 0) {
+        UnloadTexture(sprite->texture);
+    }
+    sprite->texture = (Texture2D){0};
+    sprite->textureHandle = ASSET_TEXTURE_NONE;
+    sprite->sharedTexture = false;
+    sprite->region = (Rectangle){0};
+    sprite->atlasEntry = TEXTURE_ATLAS_ENTRY_NONE;
+    sprite->frames = NULL;
+    sprite->frameTableSize = 0;
+}
+
+// Point the sprite at a texture by path. Goes through the AssetManager
+// when it is initialized, so every sprite using the same file shares one
+// upload; otherwise the sprite loads and owns its own copy. Paths packed
+// into g_textureAtlas resolve to their region of the atlas page.
+bool LoadSpriteObjectTexture(SpriteObject* sprite, const char* filePath) {
+    if (!sprite || !filePath) return false;
+    DropSpriteTexture(sprite);
+    if (g_assetManager.initialized) {
+        int entry = FindTextureAtlasEntry(&g_textureAtlas, filePath);
+        if (entry != TEXTURE_ATLAS_ENTRY_NONE) {
+            int handle = AcquireAssetTexture(GetTextureAtlasPagePath(&g_textureAtlas, entry));
+            if (handle != ASSET_TEXTURE_NONE) {
+                sprite->texture = GetAssetTextureByHandle(handle);
+                sprite->textureHandle = handle;
+                sprite->sharedTexture = true;
+                sprite->region = GetTextureAtlasRegion(&g_textureAtlas, entry);
+                sprite->atlasEntry = entry;
+                return true;
+            }
+            printf("Warning: Atlas page for %s failed to load, loading the image instead.\n", filePath);
+        }
+        int handle = AcquireAssetTexture(filePath);
+        if (handle == ASSET_TEXTURE_NONE) return false;
+        sprite->texture = GetAssetTextureByHandle(handle);
+        sprite->textureHandle = handle;
+        sprite->sharedTexture = true;
+        return true;
+    }
+    sprite->texture = LoadTexture(filePath);
+    return sprite->texture.id != 0;
+}
+
+// Share a texture the caller already holds a handle to
+void SetSpriteSharedTexture(SpriteObject* sprite, int textureHandle) {
+    if (!sprite) return;
+    RetainAssetTexture(textureHandle);
+    DropSpriteTexture(sprite);
+    sprite->texture = GetAssetTextureByHandle(textureHandle);
+    if (sprite->texture.id != 0) {
+        sprite->textureHandle = textureHandle;
+        sprite->sharedTexture = true;
+    }
+}
+
+// Draw only part of the texture, e.g. one image on a sheet
+void SetSpriteTextureRegion(SpriteObject* sprite, Rectangle region) {
+    if (!sprite) return;
+    sprite->region = region;
+}
+
+// Draw the sprite from a spritesheet's frame table, starting at frame 0
+bool SetSpriteSpritesheet(SpriteObject* sprite, int sheetId) {
+    const Spritesheet* sheet = GetSpritesheet(sheetId);
+    if (!sprite || sheet == NULL) return false;
+    SetSpriteSharedTexture(sprite, sheet->textureHandle);
+    if (!sprite->sharedTexture) return false;
+    sprite->frames = sheet->frames;
+    sprite->frameTableSize = sheet->frameCount;
+    sprite->totalFrames = sheet->frameCount;
+    sprite->currentFrame = 0;
+    sprite->frameTimer = 0.0f;
+    sprite->sequenceType = ANIMATION_SEQUENCE_LOOP;
+    sprite->reversing = false;
+    return true;
+}
+
+// Unload (or release) the sprite's texture and release the sprite
+void UnloadSpriteObject(SpriteObject* sprite) {
+    if (!sprite) return;
+    DropSpriteTexture(sprite);
+    DestroySpriteObject(sprite);
+}
@@ -7,10 +7,14 @@
 
 #include <raylib.h>
 #include <stdbool.h>
+#include "../world/memory_manager.h"
+#include "texture_atlas.h"
+#include "spritesheet.h"
 
 // Sprite object constants
 #define MAX_SPRITE_NAME_LENGTH 64
 #define MAX_SPRITE_FRAMES 64
+#define SPRITE_POOL_SLAB_SIZE 256
 
 // Sprite types
 typedef enum {
@@ -29,8 +33,12 @@ typedef enum {
 // Sprite object structure
 typedef struct {
     int id;
-    char* name;
+    char name[MAX_SPRITE_NAME_LENGTH];
     Texture2D texture;
+    int textureHandle;    // AssetManager handle when sharedTexture is set
+    bool sharedTexture;   // Otherwise the sprite owns its texture
+    Rectangle region;     // Part of the texture the sprite uses; all of it when empty
+    int atlasEntry;       // g_textureAtlas entry the texture came from, if any
     Vector2 position;
     Vector2 scale;
     Color tint;
@@ -43,22 +51,45 @@ typedef struct {
     float frameTime; // Time per frame in seconds
     float frameTimer; // Accumulated time for frame switching
     bool animating;
+    int sequenceType; // AnimationSequenceType; zero loops
+    bool reversing;   // Pingpong sprite playing back down its frames
     Vector2 origin; // Origin point for rotation and scaling
+    const SpriteFrame* frames; // Spritesheet frame table; replaces region and origin when set
+    int frameTableSize;
+
+    bool isStatic;  // Never moves; DrawSpritesInView finds it through a grid
+    int layer;      // Draw order in a SpriteBatch; higher layers draw on top
+    int blendMode;  // raylib BlendMode, BLEND_ALPHA by default
 } SpriteObject;
 
+// Pool backing CreateSpriteObject
+extern MemoryPool g_spriteObjectPool;
+
 // Sprite object functions
+SpriteObject* CreateSpriteObject(void);
+void DestroySpriteObject(SpriteObject* sprite);
+bool ReserveSpriteObjects(size_t count);
 void InitSpriteObject(SpriteObject* sprite, int id, const char* name, Texture2D texture, Vector2 position, Vector2 scale, Color tint, float rotation, SpriteType type);
 void UpdateSpriteObject(SpriteObject* sprite, float deltaTime);
+void ResolveSpriteAnimation(SpriteObject* sprite);
 void DrawSpriteObject(const SpriteObject* sprite);
+Rectangle GetSpriteObjectSourceRec(const SpriteObject* sprite);
+Vector2 GetSpriteObjectOrigin(const SpriteObject* sprite);
 void SetPosition(SpriteObject* sprite, Vector2 position);
 void SetScale(SpriteObject* sprite, Vector2 scale);
 void SetTint(SpriteObject* sprite, Color tint);
 void SetPaletteColor(SpriteObject* sprite, Color color); // Example of additional function
 void SetSpriteVisible(SpriteObject* sprite, bool visible);
 void SetRotation(SpriteObject* sprite, float rotation);
+void SetSpriteLayer(SpriteObject* sprite, int layer);
+void SetSpriteBlendMode(SpriteObject* sprite, int blendMode);
 void StartAnimation(SpriteObject* sprite, int totalFrames, float frameTime);
 void StopSpriteAnimation(SpriteObject* sprite);
 void SetSpriteAnimationFrame(SpriteObject* sprite, int frame);
 void UnloadSpriteObject(SpriteObject* sprite);
+bool LoadSpriteObjectTexture(SpriteObject* sprite, const char* filePath);
+void SetSpriteSharedTexture(SpriteObject* sprite, int textureHandle);
+void SetSpriteTextureRegion(SpriteObject* sprite, Rectangle region);
+bool SetSpriteSpritesheet(SpriteObject* sprite, int sheet);
 
 #endif // SPRITE_OBJECT_H
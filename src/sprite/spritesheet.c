@@ -0,0 +1,240 @@
+// =============================================================
+// Spritesheet source
+// =============================================================
+// Builds frame tables for spritesheets. All of the per-frame math
+// (grid layout, trimming, pivots, atlas placement) happens here, once.
+#include "spritesheet.h"
+#include "texture_atlas.h"
+#include "../util/asset_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SpritesheetRegistry g_spritesheets = {0};
+
+// Acquire a sheet's texture. Sheets packed into the atlas resolve to
+// their page, and region is where the sheet sits on it.
+static int AcquireSpritesheetTexture(const char* texturePath, Rectangle* outRegion) {
+    if (!g_assetManager.initialized) {
+        printf("Error: Spritesheets need the Asset Manager to be initialized.\n");
+        return ASSET_TEXTURE_NONE;
+    }
+    int entry = FindTextureAtlasEntry(&g_textureAtlas, texturePath);
+    int handle = entry != TEXTURE_ATLAS_ENTRY_NONE
+        ? AcquireAssetTexture(GetTextureAtlasPagePath(&g_textureAtlas, entry))
+        : AcquireAssetTexture(texturePath);
+    if (handle == ASSET_TEXTURE_NONE) {
+        printf("Error: Failed to load spritesheet texture %s\n", texturePath);
+        return ASSET_TEXTURE_NONE;
+    }
+    if (entry != TEXTURE_ATLAS_ENTRY_NONE) {
+        *outRegion = GetTextureAtlasRegion(&g_textureAtlas, entry);
+    } else {
+        Texture2D texture = GetAssetTextureByHandle(handle);
+        *outRegion = (Rectangle){ 0.0f, 0.0f, (float)texture.width, (float)texture.height };
+    }
+    return handle;
+}
+
+// Sheets are found by name, so a name that would be cut off is refused
+static bool IsSpritesheetNameStorable(const char* name) {
+    if (strlen(name) < MAX_SPRITESHEET_NAME_LENGTH) return true;
+    printf("Error: Spritesheet name %s is too long.\n", name);
+    return false;
+}
+
+// Turn authored frames into the frame table and register the sheet.
+// Takes over the texture reference, releasing it on failure.
+static int AddSpritesheet(const char* name, int textureHandle, Rectangle region, const SpriteFrameDesc* descs, int frameCount) {
+    if (g_spritesheets.count >= MAX_SPRITESHEETS) {
+        printf("Error: Maximum spritesheet limit reached.\n");
+        ReleaseAssetTexture(textureHandle);
+        return SPRITESHEET_NONE;
+    }
+    if (frameCount <= 0 || frameCount > MAX_SPRITESHEET_FRAMES) {
+        printf("Error: Spritesheet %s has %d frames (1-%d allowed).\n", name, frameCount, MAX_SPRITESHEET_FRAMES);
+        ReleaseAssetTexture(textureHandle);
+        return SPRITESHEET_NONE;
+    }
+    SpriteFrame* frames = (SpriteFrame*)malloc((size_t)frameCount * sizeof(SpriteFrame));
+    if (frames == NULL) {
+        printf("Error: Memory allocation for spritesheet frames failed.\n");
+        ReleaseAssetTexture(textureHandle);
+        return SPRITESHEET_NONE;
+    }
+
+    for (int i = 0; i < frameCount; i++) {
+        Rectangle source = descs[i].source;
+        // Frames are checked here so drawing never has to
+        if (source.width <= 0.0f || source.height <= 0.0f || source.x < 0.0f || source.y < 0.0f ||
+            source.x + source.width > region.width || source.y + source.height > region.height) {
+            printf("Error: Frame %d of spritesheet %s lies outside its texture.\n", i, name);
+            free(frames);
+            ReleaseAssetTexture(textureHandle);
+            return SPRITESHEET_NONE;
+        }
+        source.x += region.x;
+        source.y += region.y;
+        frames[i].source = source;
+        frames[i].origin = (Vector2){ descs[i].pivot.x - descs[i].offset.x, descs[i].pivot.y - descs[i].offset.y };
+    }
+
+    int sheetId = g_spritesheets.count++;
+    Spritesheet* sheet = &g_spritesheets.sheets[sheetId];
+    strcpy(sheet->name, name);
+    sheet->texture = GetAssetTextureByHandle(textureHandle);
+    sheet->textureHandle = textureHandle;
+    sheet->frames = frames;
+    sheet->frameCount = frameCount;
+    sheet->loaded = true;
+    return sheetId;
+}
+
+// Fill descs with a row-major grid of equal frames covering the region
+static int BuildGridFrames(Rectangle region, int frameWidth, int frameHeight, int frameCount, Vector2 pivot, SpriteFrameDesc** outDescs) {
+    *outDescs = NULL;
+    if (frameWidth <= 0 || frameHeight <= 0) return 0;
+    int columns = (int)region.width / frameWidth;
+    int rows = (int)region.height / frameHeight;
+    if (columns <= 0 || rows <= 0) return 0;
+    if (frameCount <= 0 || frameCount > columns * rows) frameCount = columns * rows;
+    if (frameCount > MAX_SPRITESHEET_FRAMES) frameCount = MAX_SPRITESHEET_FRAMES;
+
+    SpriteFrameDesc* descs = (SpriteFrameDesc*)malloc((size_t)frameCount * sizeof(SpriteFrameDesc));
+    if (descs == NULL) return 0;
+    for (int i = 0; i < frameCount; i++) {
+        descs[i] = (SpriteFrameDesc){
+            { (float)((i % columns) * frameWidth), (float)((i / columns) * frameHeight), (float)frameWidth, (float)frameHeight },
+            { 0.0f, 0.0f },
+            pivot
+        };
+    }
+    *outDescs = descs;
+    return frameCount;
+}
+
+// Create a sheet from explicit frames
+int CreateSpritesheet(const char* name, const char* texturePath, const SpriteFrameDesc* frames, int frameCount) {
+    if (name == NULL || texturePath == NULL || frames == NULL) return SPRITESHEET_NONE;
+    if (!IsSpritesheetNameStorable(name)) return SPRITESHEET_NONE;
+    Rectangle region;
+    int handle = AcquireSpritesheetTexture(texturePath, &region);
+    if (handle == ASSET_TEXTURE_NONE) return SPRITESHEET_NONE;
+    return AddSpritesheet(name, handle, region, frames, frameCount);
+}
+
+// Create a sheet of equal frames laid out in rows. A frameCount of 0
+// uses every whole cell of the texture.
+int CreateGridSpritesheet(const char* name, const char* texturePath, int frameWidth, int frameHeight, int frameCount, Vector2 pivot) {
+    if (name == NULL || texturePath == NULL) return SPRITESHEET_NONE;
+    if (!IsSpritesheetNameStorable(name)) return SPRITESHEET_NONE;
+    Rectangle region;
+    int handle = AcquireSpritesheetTexture(texturePath, &region);
+    if (handle == ASSET_TEXTURE_NONE) return SPRITESHEET_NONE;
+    SpriteFrameDesc* descs = NULL;
+    int count = BuildGridFrames(region, frameWidth, frameHeight, frameCount, pivot, &descs);
+    int sheet = AddSpritesheet(name, handle, region, descs, count);
+    free(descs);
+    return sheet;
+}
+
+// Append one authored frame to a growing list
+static bool PushFrameDesc(SpriteFrameDesc** descs, int* count, int* capacity, SpriteFrameDesc desc) {
+    if (*count == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 64;
+        SpriteFrameDesc* grown = (SpriteFrameDesc*)realloc(*descs, (size_t)newCapacity * sizeof(SpriteFrameDesc));
+        if (grown == NULL) return false;
+        *descs = grown;
+        *capacity = newCapacity;
+    }
+    (*descs)[(*count)++] = desc;
+    return true;
+}
+
+// Load a sheet from a text descriptor. One directive per line, '#' starts a comment:
+//   grid <frame w> <frame h> [count [pivot x pivot y]]
+//   frame <x> <y> <w> <h> [offset x offset y [pivot x pivot y]]
+// Offsets place a trimmed frame inside its untrimmed frame; pivots are in
+// untrimmed frame coordinates.
+int LoadSpritesheet(const char* name, const char* texturePath, const char* descriptorPath) {
+    if (name == NULL || texturePath == NULL || descriptorPath == NULL) return SPRITESHEET_NONE;
+    if (!IsSpritesheetNameStorable(name)) return SPRITESHEET_NONE;
+    FILE* file = fopen(descriptorPath, "r");
+    if (file == NULL) {
+        printf("Error: Could not open spritesheet descriptor %s\n", descriptorPath);
+        return SPRITESHEET_NONE;
+    }
+    Rectangle region;
+    int handle = AcquireSpritesheetTexture(texturePath, &region);
+    if (handle == ASSET_TEXTURE_NONE) {
+        fclose(file);
+        return SPRITESHEET_NONE;
+    }
+
+    SpriteFrameDesc* descs = NULL;
+    int count = 0;
+    int capacity = 0;
+    bool ok = true;
+    char line[256];
+    for (int lineNumber = 1; ok && fgets(line, sizeof(line), file) != NULL; lineNumber++) {
+        char* comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        char directive[16];
+        if (sscanf(line, "%15s", directive) != 1) continue;
+
+        float v[8] = {0};
+        if (strcmp(directive, "grid") == 0) {
+            int fields = sscanf(line, "%*s %f %f %f %f %f", &v[0], &v[1], &v[2], &v[3], &v[4]);
+            SpriteFrameDesc* grid = NULL;
+            int gridCount = fields >= 2 ? BuildGridFrames(region, (int)v[0], (int)v[1], fields >= 3 ? (int)v[2] : 0,
+                                                          (Vector2){ v[3], v[4] }, &grid) : 0;
+            ok = gridCount > 0;
+            for (int i = 0; ok && i < gridCount; i++) {
+                ok = PushFrameDesc(&descs, &count, &capacity, grid[i]);
+            }
+            free(grid);
+        } else if (strcmp(directive, "frame") == 0) {
+            int fields = sscanf(line, "%*s %f %f %f %f %f %f %f %f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]);
+            ok = fields >= 4 && PushFrameDesc(&descs, &count, &capacity, (SpriteFrameDesc){
+                { v[0], v[1], v[2], v[3] }, { v[4], v[5] }, { v[6], v[7] }
+            });
+        } else {
+            ok = false;
+        }
+        if (!ok) printf("Error: %s:%d: bad spritesheet directive.\n", descriptorPath, lineNumber);
+    }
+    fclose(file);
+
+    if (!ok) {
+        free(descs);
+        ReleaseAssetTexture(handle);
+        return SPRITESHEET_NONE;
+    }
+    int sheet = AddSpritesheet(name, handle, region, descs, count);
+    free(descs);
+    return sheet;
+}
+
+int FindSpritesheet(const char* name) {
+    if (name == NULL) return SPRITESHEET_NONE;
+    for (int i = 0; i < g_spritesheets.count; i++) {
+        if (g_spritesheets.sheets[i].loaded && strcmp(g_spritesheets.sheets[i].name, name) == 0) return i;
+    }
+    return SPRITESHEET_NONE;
+}
+
+const Spritesheet* GetSpritesheet(int sheet) {
+    if (sheet < 0 || sheet >= g_spritesheets.count || !g_spritesheets.sheets[sheet].loaded) return NULL;
+    return &g_spritesheets.sheets[sheet];
+}
+
+// Free every sheet. Sprites still using a sheet's frames must be gone.
+void UnloadSpritesheets(void) {
+    for (int i = 0; i < g_spritesheets.count; i++) {
+        Spritesheet* sheet = &g_spritesheets.sheets[i];
+        if (!sheet->loaded) continue;
+        free(sheet->frames);
+        ReleaseAssetTexture(sheet->textureHandle);
+    }
+    memset(&g_spritesheets, 0, sizeof(SpritesheetRegistry));
+}
@@ -0,0 +1,60 @@
+// =============================================================
+// Spritesheet header
+// =============================================================
+// Spritesheet descriptors with a precomputed frame table. Each frame
+// holds its source rect on the texture and its draw origin, so drawing
+// a frame is one array index. Grid, variable-size and trimmed frames all
+// end up in the same table when the sheet is loaded.
+#ifndef SPRITESHEET_H
+#define SPRITESHEET_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+// Spritesheet constants
+#define MAX_SPRITESHEETS 32
+#define MAX_SPRITESHEET_NAME_LENGTH 64
+#define MAX_SPRITESHEET_FRAMES 4096
+#define SPRITESHEET_NONE -1
+
+// One frame as drawn
+typedef struct {
+    Rectangle source;   // Trimmed frame on the texture
+    Vector2 origin;     // Pivot relative to source, in texture pixels
+} SpriteFrame;
+
+// One frame as authored. Trimmed frames give the offset of the trimmed
+// rect inside the untrimmed frame; the pivot is in untrimmed coordinates.
+typedef struct {
+    Rectangle source;
+    Vector2 offset;
+    Vector2 pivot;
+} SpriteFrameDesc;
+
+// Loaded spritesheet
+typedef struct {
+    char name[MAX_SPRITESHEET_NAME_LENGTH];
+    Texture2D texture;
+    int textureHandle;      // AssetManager handle, released on unload
+    SpriteFrame* frames;
+    int frameCount;
+    bool loaded;
+} Spritesheet;
+
+// All loaded spritesheets
+typedef struct {
+    Spritesheet sheets[MAX_SPRITESHEETS];
+    int count;
+} SpritesheetRegistry;
+
+extern SpritesheetRegistry g_spritesheets;
+
+// Spritesheet functions. Sheets need an initialized AssetManager.
+int CreateSpritesheet(const char* name, const char* texturePath, const SpriteFrameDesc* frames, int frameCount);
+int CreateGridSpritesheet(const char* name, const char* texturePath, int frameWidth, int frameHeight, int frameCount, Vector2 pivot);
+int LoadSpritesheet(const char* name, const char* texturePath, const char* descriptorPath);
+int FindSpritesheet(const char* name);
+const Spritesheet* GetSpritesheet(int sheet);
+void UnloadSpritesheets(void);
+
+#endif // SPRITESHEET_H
@@ -0,0 +1,152 @@
+// =============================================================
+// Texture atlas source
+// =============================================================
+// Loads the atlas manifest and resolves image paths to atlas regions
+#include "texture_atlas.h"
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(sizeof(TextureAtlasHeader) == 36, "TextureAtlasHeader layout changed");
+_Static_assert(sizeof(TextureAtlasPage) == 8, "TextureAtlasPage layout changed");
+_Static_assert(sizeof(TextureAtlasEntry) == 16, "TextureAtlasEntry layout changed");
+
+TextureAtlas g_textureAtlas = {0};
+
+// The manifest is read as-is, so the host must be little-endian
+static bool IsHostLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static const char* AtlasString(const TextureAtlas* atlas, uint32_t offset) {
+    if (offset >= atlas->header->stringsSize) return NULL;
+    return atlas->strings + offset;
+}
+
+// Check that the header describes a manifest we can read in place
+static bool ValidateTextureAtlas(const MappedFile* file, const TextureAtlasHeader* header) {
+    if (file->size < sizeof(TextureAtlasHeader) || memcmp(header->magic, TEXTURE_ATLAS_MAGIC, 4) != 0) {
+        printf("Error: Not a texture atlas manifest.\n");
+        return false;
+    }
+    if (header->version == 0 || header->version > TEXTURE_ATLAS_VERSION) {
+        printf("Error: Unsupported texture atlas version %u.\n", header->version);
+        return false;
+    }
+    if (header->pagesOffset % 4 != 0 || header->entriesOffset % 4 != 0 ||
+        (uint64_t)header->pagesOffset + (uint64_t)header->pageCount * sizeof(TextureAtlasPage) > file->size ||
+        (uint64_t)header->entriesOffset + (uint64_t)header->entryCount * sizeof(TextureAtlasEntry) > file->size ||
+        (uint64_t)header->stringsOffset + header->stringsSize > file->size ||
+        header->stringsSize == 0 || file->data[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        printf("Error: Texture atlas manifest is truncated or corrupt.\n");
+        return false;
+    }
+    return true;
+}
+
+// Map a manifest written by the atlas packer
+bool LoadTextureAtlas(TextureAtlas* atlas, const char* manifestPath) {
+    if (atlas == NULL || manifestPath == NULL) return false;
+    UnloadTextureAtlas(atlas);
+    if (!IsHostLittleEndian()) {
+        printf("Error: Texture atlases are only supported on little-endian hosts.\n");
+        return false;
+    }
+
+    MappedFile file;
+    if (!MapFile(manifestPath, &file)) return false;
+    const TextureAtlasHeader* header = (const TextureAtlasHeader*)file.data;
+    if (!ValidateTextureAtlas(&file, header)) {
+        UnmapFile(&file);
+        return false;
+    }
+
+    // Every page and entry must point at a real page and string
+    TextureAtlas view = {
+        .file = file,
+        .header = header,
+        .pages = (const TextureAtlasPage*)(file.data + header->pagesOffset),
+        .entries = (const TextureAtlasEntry*)(file.data + header->entriesOffset),
+        .strings = (const char*)file.data + header->stringsOffset,
+        .loaded = true
+    };
+    for (uint32_t i = 0; i < header->pageCount; i++) {
+        if (AtlasString(&view, view.pages[i].path) == NULL) {
+            printf("Error: Texture atlas manifest is truncated or corrupt.\n");
+            UnmapFile(&file);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        const TextureAtlasEntry* entry = &view.entries[i];
+        if (entry->page >= header->pageCount || AtlasString(&view, entry->name) == NULL ||
+            (uint32_t)entry->x + entry->width > view.pages[entry->page].width ||
+            (uint32_t)entry->y + entry->height > view.pages[entry->page].height) {
+            printf("Error: Texture atlas manifest is truncated or corrupt.\n");
+            UnmapFile(&file);
+            return false;
+        }
+    }
+
+    *atlas = view;
+    printf("✓ Texture atlas loaded: %u images on %u pages\n", header->entryCount, header->pageCount);
+    return true;
+}
+
+void UnloadTextureAtlas(TextureAtlas* atlas) {
+    if (atlas == NULL || !atlas->loaded) return;
+    UnmapFile(&atlas->file);
+    memset(atlas, 0, sizeof(TextureAtlas));
+}
+
+// Find an image by the path it was packed from. Entries are sorted by
+// name, so this is a binary search.
+int FindTextureAtlasEntry(const TextureAtlas* atlas, const char* name) {
+    if (atlas == NULL || !atlas->loaded || name == NULL) return TEXTURE_ATLAS_ENTRY_NONE;
+    uint32_t low = 0;
+    uint32_t high = atlas->header->entryCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int order = strcmp(atlas->strings + atlas->entries[mid].name, name);
+        if (order == 0) return (int)mid;
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return TEXTURE_ATLAS_ENTRY_NONE;
+}
+
+static bool IsAtlasEntryValid(const TextureAtlas* atlas, int entry) {
+    return atlas != NULL && atlas->loaded && entry >= 0 && (uint32_t)entry < atlas->header->entryCount;
+}
+
+const char* GetTextureAtlasEntryName(const TextureAtlas* atlas, int entry) {
+    if (!IsAtlasEntryValid(atlas, entry)) return NULL;
+    return atlas->strings + atlas->entries[entry].name;
+}
+
+// Path of the page image holding an entry
+const char* GetTextureAtlasPagePath(const TextureAtlas* atlas, int entry) {
+    if (!IsAtlasEntryValid(atlas, entry)) return NULL;
+    return atlas->strings + atlas->pages[atlas->entries[entry].page].path;
+}
+
+// Pixel rect of an entry on its page
+Rectangle GetTextureAtlasRegion(const TextureAtlas* atlas, int entry) {
+    if (!IsAtlasEntryValid(atlas, entry)) return (Rectangle){0};
+    const TextureAtlasEntry* record = &atlas->entries[entry];
+    return (Rectangle){ record->x, record->y, record->width, record->height };
+}
+
+// Normalized UV rect of an entry on its page
+Rectangle GetTextureAtlasUV(const TextureAtlas* atlas, int entry) {
+    if (!IsAtlasEntryValid(atlas, entry)) return (Rectangle){0};
+    const TextureAtlasEntry* record = &atlas->entries[entry];
+    const TextureAtlasPage* page = &atlas->pages[record->page];
+    return (Rectangle){
+        (float)record->x / page->width, (float)record->y / page->height,
+        (float)record->width / page->width, (float)record->height / page->height
+    };
+}
@@ -0,0 +1,78 @@
+// =============================================================
+// Texture atlas header
+// =============================================================
+// Runtime side of the atlas built by tools/atlas_packer.c (`make atlas`).
+// The manifest maps each packed image path to a page and a pixel rect.
+// It is mapped and used in place; page textures are loaded on demand
+// through the AssetManager, so every sprite on a page shares one upload.
+//
+// Manifest layout, little-endian: a header, the page records, the entry
+// records sorted by name, then a string table of NUL-terminated names.
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "../util/file_utils.h"
+
+// Format constants
+#define TEXTURE_ATLAS_MAGIC "RSTA"
+#define TEXTURE_ATLAS_VERSION 1
+#define TEXTURE_ATLAS_MANIFEST_PATH "res/atlas/atlas.bin"
+#define TEXTURE_ATLAS_ENTRY_NONE -1
+
+// File header. Offsets are from the start of the file.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t pageCount;
+    uint32_t entryCount;
+    uint32_t pagesOffset;
+    uint32_t entriesOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+} TextureAtlasHeader;
+
+// One atlas page image
+typedef struct {
+    uint32_t path;      // Offset into the string table
+    uint16_t width;
+    uint16_t height;
+} TextureAtlasPage;
+
+// One packed image. The UV rect is the pixel rect over the page size.
+typedef struct {
+    uint32_t name;      // Offset into the string table; the source image path
+    uint16_t page;
+    uint16_t reserved;
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+} TextureAtlasEntry;
+
+// Loaded manifest
+typedef struct {
+    MappedFile file;
+    const TextureAtlasHeader* header;
+    const TextureAtlasPage* pages;
+    const TextureAtlasEntry* entries;
+    const char* strings;
+    bool loaded;
+} TextureAtlas;
+
+// Atlas consulted by LoadSpriteObjectTexture
+extern TextureAtlas g_textureAtlas;
+
+// Texture atlas functions
+bool LoadTextureAtlas(TextureAtlas* atlas, const char* manifestPath);
+void UnloadTextureAtlas(TextureAtlas* atlas);
+int FindTextureAtlasEntry(const TextureAtlas* atlas, const char* name);
+const char* GetTextureAtlasEntryName(const TextureAtlas* atlas, int entry);
+const char* GetTextureAtlasPagePath(const TextureAtlas* atlas, int entry);
+Rectangle GetTextureAtlasRegion(const TextureAtlas* atlas, int entry);
+Rectangle GetTextureAtlasUV(const TextureAtlas* atlas, int entry);
+
+#endif // TEXTURE_ATLAS_H
@@ -4,6 +4,7 @@
 // Manages loading and unloading of game assets
 
 #include "asset_manager.h"
+#include "hash_utils.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -19,15 +20,25 @@ void InitAssetManager(void) {
     printf("✓ Asset Manager initialized\n");
 }
 
+// Forget a texture slot whose GPU texture has been unloaded
+static void ClearAssetTextureSlot(int slot) {
+    g_assetManager.textures[slot] = (Texture2D){0};
+    g_assetManager.textureLoaded[slot] = false;
+    g_assetManager.textureRefCounts[slot] = 0;
+    g_assetManager.texturePathHashes[slot] = 0;
+    g_assetManager.texturePaths[slot][0] = '\0';
+}
+
 void UnloadAssetManager(void) {
     if (!g_assetManager.initialized) return;
     
     printf("Unloading Asset Manager...\n");
     
-    // Unload all textures
+    // Unload all textures, clearing each slot so late releases do nothing
     for (int i = 0; i < MAX_TEXTURES; i++) {
         if (g_assetManager.textureLoaded[i]) {
             UnloadTexture(g_assetManager.textures[i]);
+            ClearAssetTextureSlot(i);
         }
     }
     
@@ -56,9 +67,29 @@ void UnloadAssetManager(void) {
     printf("✓ Asset Manager unloaded\n");
 }
 
+// Paths are stored whole so lookups can compare them; longer ones are refused
+static bool IsAssetPathStorable(const char* filePath) {
+    if (strlen(filePath) < MAX_ASSET_PATH_LENGTH) return true;
+    printf("✗ Texture path is too long: %s\n", filePath);
+    return false;
+}
+
+// Record the path and first reference of a freshly loaded texture
+static void TrackAssetTexture(int slot, const char* filePath) {
+    strcpy(g_assetManager.texturePaths[slot], filePath);
+    g_assetManager.texturePathHashes[slot] = HashString(filePath);
+    g_assetManager.textureRefCounts[slot] = 1;
+    g_assetManager.textureUploads++;
+}
+
+static bool IsTextureHandleValid(int handle) {
+    return handle >= 0 && handle < MAX_TEXTURES && g_assetManager.textureLoaded[handle];
+}
+
 // Texture management
 int LoadAssetTexture(const char* name, const char* filePath) {
     if (!g_assetManager.initialized) return -1;
+    if (!IsAssetPathStorable(filePath)) return -1;
     
     for (int i = 0; i < MAX_TEXTURES; i++) {
         if (!g_assetManager.textureLoaded[i]) {
@@ -67,6 +98,7 @@ int LoadAssetTexture(const char* name, const char* filePath) {
                 strncpy(g_assetManager.textureNames[i], name, 63);
                 g_assetManager.textureNames[i][63] = '\0';
                 g_assetManager.textureLoaded[i] = true;
+                TrackAssetTexture(i, filePath);
                 printf("✓ Loaded texture: %s\n", name);
                 return i;
             } else {
@@ -91,6 +123,77 @@ Texture2D GetAssetTexture(const char* name) {
     return (Texture2D){0};
 }
 
+// Drop the reference taken by LoadAssetTexture
+void UnloadAssetTexture(const char* name) {
+    if (name == NULL) return;
+    for (int i = 0; i < MAX_TEXTURES; i++) {
+        if (g_assetManager.textureLoaded[i] && strcmp(g_assetManager.textureNames[i], name) == 0) {
+            ReleaseAssetTexture(i);
+            return;
+        }
+    }
+}
+
+// Get a shared texture by path, loading it on first use.
+// Every successful call must be paired with ReleaseAssetTexture.
+int AcquireAssetTexture(const char* filePath) {
+    if (!g_assetManager.initialized || filePath == NULL) return ASSET_TEXTURE_NONE;
+    if (!IsAssetPathStorable(filePath)) return ASSET_TEXTURE_NONE;
+    
+    uint32_t hash = HashString(filePath);
+    int freeSlot = ASSET_TEXTURE_NONE;
+    for (int i = 0; i < MAX_TEXTURES; i++) {
+        if (!g_assetManager.textureLoaded[i]) {
+            if (freeSlot == ASSET_TEXTURE_NONE) freeSlot = i;
+            continue;
+        }
+        if (g_assetManager.texturePathHashes[i] == hash && strcmp(g_assetManager.texturePaths[i], filePath) == 0) {
+            g_assetManager.textureRefCounts[i]++;
+            return i;
+        }
+    }
+    
+    if (freeSlot == ASSET_TEXTURE_NONE) {
+        printf("✗ No texture slots available for: %s\n", filePath);
+        return ASSET_TEXTURE_NONE;
+    }
+    Texture2D texture = LoadTexture(filePath);
+    if (texture.id == 0) {
+        printf("✗ Failed to load texture: %s\n", filePath);
+        return ASSET_TEXTURE_NONE;
+    }
+    g_assetManager.textures[freeSlot] = texture;
+    strncpy(g_assetManager.textureNames[freeSlot], filePath, 63);
+    g_assetManager.textureNames[freeSlot][63] = '\0';
+    g_assetManager.textureLoaded[freeSlot] = true;
+    TrackAssetTexture(freeSlot, filePath);
+    return freeSlot;
+}
+
+// Take another reference to a texture that is already held
+void RetainAssetTexture(int handle) {
+    if (!IsTextureHandleValid(handle)) return;
+    g_assetManager.textureRefCounts[handle]++;
+}
+
+// Drop a reference. The GPU texture is unloaded with the last one.
+void ReleaseAssetTexture(int handle) {
+    if (!IsTextureHandleValid(handle)) return;
+    if (--g_assetManager.textureRefCounts[handle] > 0) return;
+    UnloadTexture(g_assetManager.textures[handle]);
+    ClearAssetTextureSlot(handle);
+}
+
+Texture2D GetAssetTextureByHandle(int handle) {
+    if (!IsTextureHandleValid(handle)) return (Texture2D){0};
+    return g_assetManager.textures[handle];
+}
+
+int GetAssetTextureRefCount(int handle) {
+    if (!IsTextureHandleValid(handle)) return 0;
+    return g_assetManager.textureRefCounts[handle];
+}
+
 // Sound management
 int LoadAssetSound(const char* name, const char* filePath) {
     if (!g_assetManager.initialized) return -1;
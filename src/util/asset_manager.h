@@ -7,11 +7,14 @@
 
 #include "raylib.h"
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_TEXTURES 32
+#define MAX_TEXTURES 128
 #define MAX_SOUNDS 16
 #define MAX_MUSIC 4
 #define MAX_FONTS 8
+#define MAX_ASSET_PATH_LENGTH 256
+#define ASSET_TEXTURE_NONE -1
 
 typedef struct {
     Texture2D textures[MAX_TEXTURES];
@@ -29,6 +32,13 @@ typedef struct {
     bool musicLoaded[MAX_MUSIC];
     bool fontLoaded[MAX_FONTS];
     
+    // Textures are shared by file path. A texture stays on the GPU until
+    // its last reference is released.
+    char texturePaths[MAX_TEXTURES][MAX_ASSET_PATH_LENGTH];
+    uint32_t texturePathHashes[MAX_TEXTURES];
+    int textureRefCounts[MAX_TEXTURES];
+    int textureUploads;
+    
     bool initialized;
 } AssetManager;
 
@@ -44,6 +54,13 @@ int LoadAssetTexture(const char* name, const char* filePath);
 Texture2D GetAssetTexture(const char* name);
 void UnloadAssetTexture(const char* name);
 
+// Shared texture handles (indices into the texture table)
+int AcquireAssetTexture(const char* filePath);
+void RetainAssetTexture(int handle);
+void ReleaseAssetTexture(int handle);
+Texture2D GetAssetTextureByHandle(int handle);
+int GetAssetTextureRefCount(int handle);
+
 // Sound management
 int LoadAssetSound(const char* name, const char* filePath);
 Sound GetAssetSound(const char* name);
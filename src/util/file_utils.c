@@ -0,0 +1,86 @@
+// =============================================================
+// File Utilities Implementation
+// =============================================================
+// Read-only file mapping on POSIX and Windows
+
+#include "file_utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Map a file for reading. The view stays valid until UnmapFile.
+bool MapFile(const char* filePath, MappedFile* outFile) {
+    if (!filePath || !outFile) return false;
+    memset(outFile, 0, sizeof(MappedFile));
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("Error: Could not open %s\n", filePath);
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        printf("Error: %s is empty or unreadable\n", filePath);
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        printf("Error: Could not map %s\n", filePath);
+        return false;
+    }
+    const unsigned char* data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        printf("Error: Could not map %s\n", filePath);
+        CloseHandle(mapping);
+        return false;
+    }
+    outFile->data = data;
+    outFile->size = (size_t)size.QuadPart;
+    outFile->mapping = mapping;
+#else
+    int fd = open(filePath, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Could not open %s\n", filePath);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        printf("Error: %s is empty or unreadable\n", filePath);
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Error: Could not map %s\n", filePath);
+        return false;
+    }
+    outFile->data = (const unsigned char*)data;
+    outFile->size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+// Release a mapping made by MapFile
+void UnmapFile(MappedFile* file) {
+    if (!file || !file->data) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(file->data);
+    CloseHandle((HANDLE)file->mapping);
+#else
+    munmap((void*)file->data, file->size);
+#endif
+    memset(file, 0, sizeof(MappedFile));
+}
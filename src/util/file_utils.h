@@ -0,0 +1,23 @@
+// =============================================================
+// File Utilities Header
+// =============================================================
+// Read-only file mapping, so binary data can be used in place
+// instead of being read and parsed field by field
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// A read-only view of a whole file
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    void* mapping; // Platform mapping handle (Windows only)
+} MappedFile;
+
+// Function prototypes
+bool MapFile(const char* filePath, MappedFile* outFile);
+void UnmapFile(MappedFile* file);
+
+#endif // FILE_UTILS_H
@@ -0,0 +1,19 @@
+// =============================================================
+// Hash Utilities Header
+// =============================================================
+// String hashing shared by the name and path lookup tables
+#ifndef HASH_UTILS_H
+#define HASH_UTILS_H
+
+#include <stdint.h>
+
+// Hash a NUL-terminated string (FNV-1a, 32-bit)
+static inline uint32_t HashString(const char* string) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)string; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+#endif // HASH_UTILS_H
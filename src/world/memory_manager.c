@@ -7,6 +7,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+
+// Pools registered for PrintMemoryStats
+static MemoryPool* s_memoryPools[MAX_MEMORY_POOLS] = {0};
+static int s_memoryPoolCount = 0;
 
 bool InitMemoryManager(MemoryManager* manager) {
     if (!manager) return false;
@@ -122,4 +127,156 @@ void PrintMemoryStats(MemoryManager* manager) {
             }
         }
     }
-}
\ No newline at end of file
+    
+    PrintMemoryPoolStats();
+}
+
+// Add a slab to the pool, twice the size of the previous one
+static bool AddMemorySlab(MemoryPool* pool) {
+    if (pool->slabCount == pool->slabDirectoryCapacity) {
+        size_t capacity = pool->slabDirectoryCapacity ? pool->slabDirectoryCapacity * 2 : 8;
+        MemorySlab* slabs = (MemorySlab*)realloc(pool->slabs, capacity * sizeof(MemorySlab));
+        if (!slabs) {
+            printf("Error: Memory allocation for pool '%s' slab list failed.\n", pool->name);
+            return false;
+        }
+        pool->slabs = slabs;
+        pool->slabDirectoryCapacity = capacity;
+    }
+    
+    size_t elements = pool->slabCount > 0 ? pool->slabs[pool->slabCount - 1].elements * 2 : pool->firstSlabElements;
+    unsigned char* memory = (unsigned char*)malloc(elements * pool->elementSize);
+    if (!memory) {
+        printf("Error: Memory allocation for pool '%s' slab failed.\n", pool->name);
+        return false;
+    }
+    pool->slabs[pool->slabCount++] = (MemorySlab){ memory, elements };
+    return true;
+}
+
+bool InitMemoryPool(MemoryPool* pool, const char* name, size_t elementSize, size_t firstSlabElements) {
+    if (!pool || elementSize == 0) return false;
+    
+    memset(pool, 0, sizeof(MemoryPool));
+    strncpy(pool->name, name ? name : "pool", MEMORY_POOL_NAME_LENGTH - 1);
+    
+    // Every element must hold a free list link and keep the next one aligned
+    size_t align = _Alignof(max_align_t);
+    if (elementSize < sizeof(void*)) elementSize = sizeof(void*);
+    pool->elementSize = (elementSize + align - 1) / align * align;
+    pool->firstSlabElements = firstSlabElements > 0 ? firstSlabElements : 64;
+    pool->initialized = true;
+    
+    if (s_memoryPoolCount < MAX_MEMORY_POOLS) {
+        s_memoryPools[s_memoryPoolCount++] = pool;
+    } else {
+        printf("Warning: Memory pool '%s' is not tracked, registry is full.\n", pool->name);
+    }
+    return true;
+}
+
+// Make sure count elements fit without further slab allocations
+bool ReserveMemoryPool(MemoryPool* pool, size_t count) {
+    if (!pool || !pool->initialized) return false;
+    while (GetMemoryPoolCapacity(pool) < count) {
+        if (!AddMemorySlab(pool)) return false;
+    }
+    return true;
+}
+
+// O(1): pop the free list, otherwise carve the next fresh element
+void* PoolAlloc(MemoryPool* pool) {
+    if (!pool || !pool->initialized) return NULL;
+    
+    void* ptr = pool->freeList;
+    if (ptr) {
+        pool->freeList = *(void**)ptr;
+    } else {
+        while (pool->freshSlab < pool->slabCount && pool->freshIndex == pool->slabs[pool->freshSlab].elements) {
+            pool->freshSlab++;
+            pool->freshIndex = 0;
+        }
+        if (pool->freshSlab == pool->slabCount && !AddMemorySlab(pool)) return NULL;
+        ptr = pool->slabs[pool->freshSlab].memory + pool->freshIndex++ * pool->elementSize;
+    }
+    
+    pool->liveCount++;
+    if (pool->liveCount > pool->highWater) pool->highWater = pool->liveCount;
+    return ptr;
+}
+
+// O(1): push the element on the free list
+void PoolFree(MemoryPool* pool, void* ptr) {
+    if (!pool || !ptr) return;
+    *(void**)ptr = pool->freeList;
+    pool->freeList = ptr;
+    pool->liveCount--;
+}
+
+// Check whether ptr came from this pool. Slabs double in size, so this
+// walks O(log n) slabs.
+bool PoolOwns(const MemoryPool* pool, const void* ptr) {
+    if (!pool || !pool->initialized || !ptr) return false;
+    const unsigned char* address = (const unsigned char*)ptr;
+    for (size_t i = 0; i < pool->slabCount; i++) {
+        const MemorySlab* slab = &pool->slabs[i];
+        if (address >= slab->memory && address < slab->memory + slab->elements * pool->elementSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t GetMemoryPoolCapacity(const MemoryPool* pool) {
+    if (!pool) return 0;
+    size_t capacity = 0;
+    for (size_t i = 0; i < pool->slabCount; i++) {
+        capacity += pool->slabs[i].elements;
+    }
+    return capacity;
+}
+
+// Forget every element at once (e.g. on screen unload). Slabs are kept
+// and handed out again in address order.
+void ResetMemoryPool(MemoryPool* pool) {
+    if (!pool || !pool->initialized) return;
+    pool->freeList = NULL;
+    pool->freshSlab = 0;
+    pool->freshIndex = 0;
+    pool->liveCount = 0;
+}
+
+// Release every slab and stop tracking the pool
+void UnloadMemoryPool(MemoryPool* pool) {
+    if (!pool || !pool->initialized) return;
+    
+    for (size_t i = 0; i < pool->slabCount; i++) {
+        free(pool->slabs[i].memory);
+    }
+    free(pool->slabs);
+    
+    for (int i = 0; i < s_memoryPoolCount; i++) {
+        if (s_memoryPools[i] == pool) {
+            s_memoryPools[i] = s_memoryPools[--s_memoryPoolCount];
+            break;
+        }
+    }
+    memset(pool, 0, sizeof(MemoryPool));
+}
+
+void PrintMemoryPoolStats(void) {
+    if (s_memoryPoolCount == 0) return;
+    
+    printf("=== Memory Pool Stats ===\n");
+    for (int i = 0; i < s_memoryPoolCount; i++) {
+        const MemoryPool* pool = s_memoryPools[i];
+        size_t capacity = GetMemoryPoolCapacity(pool);
+        printf("  %s - %zu/%zu live - high-water %zu - %zu slabs - %zu bytes\n",
+               pool->name,
+               pool->liveCount,
+               capacity,
+               pool->highWater,
+               pool->slabCount,
+               capacity * pool->elementSize);
+    }
+}
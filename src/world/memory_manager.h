@@ -9,6 +9,8 @@
 #include <stdbool.h>
 
 #define MAX_ALLOCATIONS 1024
+#define MAX_MEMORY_POOLS 16
+#define MEMORY_POOL_NAME_LENGTH 32
 
 typedef struct {
     void* ptr;
@@ -26,6 +28,30 @@ typedef struct {
     bool initialized;
 } MemoryManager;
 
+// One contiguous block of pool elements
+typedef struct {
+    unsigned char* memory;
+    size_t elements;
+} MemorySlab;
+
+// Fixed-size object pool. Elements are carved from slabs that double in
+// size as the pool grows; freed elements go on an intrusive free list and
+// are reused first. Pools register themselves for PrintMemoryStats.
+typedef struct {
+    char name[MEMORY_POOL_NAME_LENGTH];
+    size_t elementSize;
+    size_t firstSlabElements;
+    MemorySlab* slabs;
+    size_t slabCount;
+    size_t slabDirectoryCapacity;
+    size_t freshSlab;   // Next never-used element is slabs[freshSlab] at freshIndex
+    size_t freshIndex;
+    void* freeList;
+    size_t liveCount;
+    size_t highWater;
+    bool initialized;
+} MemoryPool;
+
 // Function prototypes
 bool InitMemoryManager(MemoryManager* manager);
 void* ManagedAlloc(MemoryManager* manager, size_t size, const char* file, int line);
@@ -34,6 +60,17 @@ void ManagedFree(MemoryManager* manager, void* ptr);
 void UnloadMemoryManager(MemoryManager* manager);
 void PrintMemoryStats(MemoryManager* manager);
 
+// Memory pool functions
+bool InitMemoryPool(MemoryPool* pool, const char* name, size_t elementSize, size_t firstSlabElements);
+bool ReserveMemoryPool(MemoryPool* pool, size_t count);
+void* PoolAlloc(MemoryPool* pool);
+void PoolFree(MemoryPool* pool, void* ptr);
+bool PoolOwns(const MemoryPool* pool, const void* ptr);
+size_t GetMemoryPoolCapacity(const MemoryPool* pool);
+void ResetMemoryPool(MemoryPool* pool);
+void UnloadMemoryPool(MemoryPool* pool);
+void PrintMemoryPoolStats(void);
+
 // Convenience macros
 #define MANAGED_ALLOC(manager, size) ManagedAlloc(manager, size, __FILE__, __LINE__)
 #define MANAGED_REALLOC(manager, ptr, size) ManagedRealloc(manager, ptr, size, __FILE__, __LINE__)
@@ -0,0 +1,78 @@
+// =============================================================
+// Animation LOD test
+// =============================================================
+// A long step on an eager animator must report every marker it crosses,
+// on the animator list and the animator store alike. Only animators held
+// back by LOD may skip whole cycles when they catch up, and they still
+// land on the frame they would have shown.
+#include "sprite/animation_clip.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <stdlib.h>
+
+#define LOD_TEST_EVENT 9
+
+static Animator* AddTestAnimator(AnimationManager* manager, int clip, AnimationLod lod) {
+    Animator* animator = (Animator*)malloc(sizeof(Animator));
+    InitAnimator(animator, clip);
+    SetAnimatorLod(animator, lod);
+    AddAnimator(manager, animator);
+    return animator;
+}
+
+// Markers this update for one list animator or store row
+static int CountTestEvents(const AnimationManager* manager, int animator, int row) {
+    const AnimationEventBuffer* events = GetAnimationEvents(manager);
+    int count = 0;
+    for (size_t i = 0; i < events->count; i++) {
+        const AnimationEvent* event = &events->items[i];
+        if (event->eventId == LOD_TEST_EVENT && event->animator == animator && event->row == row) count++;
+    }
+    return count;
+}
+
+int main(void) {
+    InitAssetManager();
+    // Four 0.1 s frames with a marker on frame 1
+    int clip = LoadAnimationClip("lod_loop", "res/image/lod.png", 32, 32, 4, 0.1f, ANIMATION_SEQUENCE_LOOP);
+    CHECK(clip != ANIMATION_CLIP_NONE);
+    CHECK(AddAnimationClipEvent(clip, 1, LOD_TEST_EVENT));
+
+    // One 1.0 s step crosses ten frames, entering frame 1 three times
+    AnimationManager manager;
+    InitAnimationManager(&manager);
+    AddTestAnimator(&manager, clip, ANIMATION_LOD_EAGER);
+    CHECK(AddAnimatorRow(&manager.store, clip) == 0);
+    UpdateAnimators(&manager, 1.0f);
+    CHECK(CountTestEvents(&manager, 0, -1) == 3);
+    CHECK(CountTestEvents(&manager, -1, 0) == 3);
+    CHECK(manager.store.frames[0] == 2);
+    UnloadAllAnimators(&manager);
+
+    // A deferred animator holds its frame, then catches up in one cycle
+    // to the frame an eager twin shows
+    InitAnimationManager(&manager);
+    Animator* deferred = AddTestAnimator(&manager, clip, ANIMATION_LOD_DEFERRED);
+    Animator* twin = AddTestAnimator(&manager, clip, ANIMATION_LOD_EAGER);
+    for (int i = 0; i < 10; i++) {
+        UpdateAnimators(&manager, 0.1f);
+        CHECK(deferred->currentFrameIndex == 0);
+        CHECK(CountTestEvents(&manager, 0, -1) == 0);
+    }
+    CHECK(deferred->heldBack);
+    SetAnimatorLod(deferred, ANIMATION_LOD_EAGER);
+    UpdateAnimators(&manager, 0.0f);
+    CHECK(CountTestEvents(&manager, 0, -1) == 1);
+    CHECK(deferred->currentFrameIndex == twin->currentFrameIndex);
+    CHECK(!deferred->heldBack);
+
+    // Once eager again, long steps report every crossing
+    UpdateAnimators(&manager, 0.8f);
+    CHECK(CountTestEvents(&manager, 0, -1) == 2);
+    UnloadAllAnimators(&manager);
+
+    UnloadAnimationClips();
+    UnloadAssetManager();
+    return FinishTest("animation lod");
+}
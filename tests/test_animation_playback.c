@@ -0,0 +1,138 @@
+// =============================================================
+// Animation playback test
+// =============================================================
+// Registers clips once, then plays them on sprites, animators and store
+// rows for a minute of frames, switching clips as it goes. Steady-state
+// playback must not load a texture. Also checks that sprites honour the
+// clip's loop, once and pingpong types.
+#include "sprite/animation_clip.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <stdlib.h>
+
+#define PLAYBACK_TEST_SPRITES 1000
+#define PLAYBACK_TEST_ANIMATORS 64
+#define PLAYBACK_TEST_ROWS 1000
+#define PLAYBACK_TEST_FRAMES 3600
+#define PLAYBACK_TEST_FRAME_TIME 0.25f  // Exact in binary, so frame counts are too
+
+static const char* g_testClips[] = { "walk", "door", "swing" };
+
+// Step a sprite by whole frames and check where it lands
+static void CheckSpriteStep(SpriteObject* sprite, int frames, int expected, bool animating) {
+    UpdateSpriteObject(sprite, frames * PLAYBACK_TEST_FRAME_TIME);
+    CHECK(sprite->currentFrame == expected);
+    CHECK(sprite->animating == animating);
+}
+
+static void CheckClipTypes(int walk, int door, int swing) {
+    SpriteObject* sprite = CreateSpriteObject();
+    CHECK(sprite != NULL);
+    if (sprite == NULL) return;
+    sprite->visible = true;
+
+    // Loop wraps back to the first frame
+    CHECK(PlayAnimationClip(sprite, walk));
+    CheckSpriteStep(sprite, 3, 3, true);
+    CheckSpriteStep(sprite, 2, 1, true);
+    CheckSpriteStep(sprite, 41, 2, true);
+
+    // Once holds its last frame and stops
+    CHECK(PlayAnimationClip(sprite, door));
+    CheckSpriteStep(sprite, 2, 2, true);
+    CheckSpriteStep(sprite, 5, 3, false);
+    CheckSpriteStep(sprite, 1, 3, false);
+
+    // Pingpong bounces without repeating the end frames
+    CHECK(PlayAnimationClip(sprite, swing));
+    const int bounce[] = { 1, 2, 3, 2, 1, 0, 1, 2 };
+    for (int i = 0; i < 8; i++) {
+        CheckSpriteStep(sprite, 1, bounce[i], true);
+    }
+    // Long steps land where single steps would: phase 2 + 13 wraps to 3, the top frame
+    CheckSpriteStep(sprite, 13, 3, true);
+    CHECK(!sprite->reversing);
+    CheckSpriteStep(sprite, 1, 2, true);
+    CHECK(sprite->reversing);
+    CheckSpriteStep(sprite, 6, 2, true);
+    CHECK(sprite->reversing);
+
+    // A hidden sprite catches up once it is visible again
+    CHECK(PlayAnimationClip(sprite, swing));
+    sprite->visible = false;
+    CheckSpriteStep(sprite, 4, 0, true);
+    sprite->visible = true;
+    CheckSpriteStep(sprite, 0, 2, true);
+    DestroySpriteObject(sprite);
+}
+
+int main(void) {
+    InitAssetManager();
+    int walk = LoadAnimationClip("walk", "res/image/hero.png", 32, 32, 4, PLAYBACK_TEST_FRAME_TIME, ANIMATION_SEQUENCE_LOOP);
+    int door = LoadAnimationClip("door", "res/image/hero.png", 32, 32, 4, PLAYBACK_TEST_FRAME_TIME, ANIMATION_SEQUENCE_ONCE);
+    int swing = LoadAnimationClip("swing", "res/image/hero.png", 32, 32, 4, PLAYBACK_TEST_FRAME_TIME, ANIMATION_SEQUENCE_PINGPONG);
+    CHECK(walk != ANIMATION_CLIP_NONE && door != ANIMATION_CLIP_NONE && swing != ANIMATION_CLIP_NONE);
+    CHECK(AddAnimationClipEvent(walk, 1, 7));
+    // The sheet for hero.png is cut into 32x32 frames, so 64x64 clips on it are refused
+    CHECK(LoadAnimationClip("big", "res/image/hero.png", 64, 64, 4, PLAYBACK_TEST_FRAME_TIME, ANIMATION_SEQUENCE_LOOP) == ANIMATION_CLIP_NONE);
+    CHECK(g_spritesheets.count == 1);
+    CheckClipTypes(walk, door, swing);
+
+    SpriteObject* sprites[PLAYBACK_TEST_SPRITES];
+    for (int i = 0; i < PLAYBACK_TEST_SPRITES; i++) {
+        sprites[i] = CreateSpriteObject();
+        CHECK(sprites[i] != NULL);
+        if (sprites[i] == NULL) return FinishTest("animation playback");
+        sprites[i]->visible = i % 3 != 0;
+        sprites[i]->scale = (Vector2){ 1.0f, 1.0f };
+        PlayAnimationClip(sprites[i], i % 3);
+    }
+    AnimationManager manager;
+    InitAnimationManager(&manager);
+    for (int i = 0; i < PLAYBACK_TEST_ANIMATORS; i++) {
+        Animator* animator = (Animator*)malloc(sizeof(Animator));
+        InitAnimator(animator, i % 3);
+        SetAnimatorLod(animator, (AnimationLod)(i % 3));
+        AddAnimator(&manager, animator);
+    }
+    for (int i = 0; i < PLAYBACK_TEST_ROWS; i++) {
+        CHECK(AddAnimatorRow(&manager.store, i % 3) == i);
+    }
+
+    // Steady state: every clip is registered and its texture resident
+    ResetRaylibStubCounters();
+    size_t events = 0;
+    for (int frame = 0; frame < PLAYBACK_TEST_FRAMES; frame++) {
+        float deltaTime = 1.0f / 60.0f;
+        for (int i = 0; i < PLAYBACK_TEST_SPRITES; i++) {
+            // Clips are switched by ID and by name, as gameplay code would
+            if (frame % 60 == i % 60) PlayAnimationClip(sprites[i], FindAnimationClip(g_testClips[(frame + i) % 3]));
+            UpdateSpriteObject(sprites[i], deltaTime);
+            DrawSpriteObject(sprites[i]);
+        }
+        if (frame % 120 == 0) {
+            PlayAnimation(manager.animators[frame % PLAYBACK_TEST_ANIMATORS], g_testClips[frame % 3]);
+            PlayAnimatorRow(&manager.store, (size_t)frame % PLAYBACK_TEST_ROWS, FindAnimationClip(g_testClips[frame % 3]));
+        }
+        UpdateAnimators(&manager, deltaTime);
+        events += GetAnimationEvents(&manager)->count;
+        for (size_t row = NextChangedAnimatorRow(&manager.store, 0); row < manager.store.count;
+             row = NextChangedAnimatorRow(&manager.store, row + 1)) {
+            GetAnimationFrameRect(&manager, GetAnimatorRowSheetFrame(&manager.store, row));
+        }
+    }
+    printf("  %d frames: %d draws, %zu events\n", PLAYBACK_TEST_FRAMES, g_raylibStub.textureDraws, events);
+    CHECK(g_raylibStub.textureLoads == 0);
+    CHECK(g_raylibStub.textureUnloads == 0);
+    CHECK(g_raylibStub.textureDraws > 0);
+    CHECK(events > 0);
+
+    for (int i = 0; i < PLAYBACK_TEST_SPRITES; i++) {
+        UnloadSpriteObject(sprites[i]);
+    }
+    UnloadAllAnimators(&manager);
+    UnloadAnimationClips();
+    UnloadAssetManager();
+    return FinishTest("animation playback");
+}
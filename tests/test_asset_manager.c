@@ -0,0 +1,43 @@
+// =============================================================
+// Asset manager test
+// =============================================================
+// Shared textures are loaded once per path and unloaded with their last
+// reference. Releases that come after UnloadAssetManager, as from sprites
+// freed late during shutdown, must not unload anything a second time.
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+int main(void) {
+    InitAssetManager();
+    ResetRaylibStubCounters();
+    int hero = AcquireAssetTexture("res/image/hero.png");
+    CHECK(hero != ASSET_TEXTURE_NONE);
+    CHECK(AcquireAssetTexture("res/image/hero.png") == hero);
+    CHECK(GetAssetTextureRefCount(hero) == 2);
+    int tiles = AcquireAssetTexture("res/image/tiles.png");
+    CHECK(tiles != ASSET_TEXTURE_NONE && tiles != hero);
+    CHECK(g_raylibStub.textureLoads == 2);
+
+    // The last release unloads
+    ReleaseAssetTexture(tiles);
+    CHECK(g_raylibStub.textureUnloads == 1);
+    CHECK(GetAssetTextureRefCount(tiles) == 0);
+
+    // Shutdown unloads what is still held and clears its slot
+    UnloadAssetManager();
+    CHECK(g_raylibStub.textureUnloads == 2);
+    CHECK(!g_assetManager.textureLoaded[hero]);
+    CHECK(g_assetManager.textureRefCounts[hero] == 0);
+    CHECK(g_assetManager.texturePathHashes[hero] == 0);
+    ReleaseAssetTexture(hero);
+    ReleaseAssetTexture(hero);
+    CHECK(g_raylibStub.textureUnloads == 2);
+
+    // A fresh start does not find the old path
+    InitAssetManager();
+    CHECK(AcquireAssetTexture("res/image/hero.png") != ASSET_TEXTURE_NONE);
+    CHECK(g_raylibStub.textureLoads == 3);
+    UnloadAssetManager();
+    return FinishTest("asset manager");
+}
@@ -0,0 +1,186 @@
+// =============================================================
+// Baked animation test
+// =============================================================
+// Writes an animation description, bakes it with bin/anim_baker and maps
+// the blob, then checks every clip, frame and event against the text.
+// The baker must refuse bad descriptions and the loader damaged blobs.
+#include "sprite/baked_animation.h"
+#include "sprite/animation_clip.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BAKED_TEST_BAKER "bin/anim_baker"
+#define BAKED_TEST_TEXT "bin/test_animations.txt"
+#define BAKED_TEST_BLOB "bin/test_animations.bin"
+#define BAKED_TEST_BAD_TEXT "bin/test_animations_bad.txt"
+#define BAKED_TEST_BAD_BLOB "bin/test_animations_bad.bin"
+#define BAKED_TEST_CLIPS 300
+
+static const char* g_testSheets[] = { "a", "b", "c" };
+static const char* g_testTypes[] = { "loop", "once", "pingpong", "" };
+static const char* g_testFrameTimes[] = { "0.05", "0.06", "0.07", "0.08" };
+
+// Clip i is fully determined by i
+static int TestFirstFrame(int i) { return i % 10; }
+static int TestFrameCount(int i) { return 1 + i % 6; }
+static bool TestHasEvents(int i) { return i % 5 == 0; }
+
+static bool WriteTestText(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return false;
+    fputs(text, file);
+    fclose(file);
+    return true;
+}
+
+static bool WriteTestDescription(void) {
+    FILE* file = fopen(BAKED_TEST_TEXT, "w");
+    if (file == NULL) return false;
+    fprintf(file, "# Baked animation test fixture\n");
+    fprintf(file, "sheet a res/image/a.png 16 16\n");
+    fprintf(file, "sheet b res/image/b.png 8 8 20 4 4  # pivoted\n");
+    fprintf(file, "sheet c res/image/c.png 8 8 0\n");
+    for (int i = 0; i < BAKED_TEST_CLIPS; i++) {
+        int frames = TestFrameCount(i);
+        fprintf(file, "clip clip_%d %s %d %d %s %s\n", i, g_testSheets[i % 3], TestFirstFrame(i), frames,
+                g_testFrameTimes[i % 4], g_testTypes[i % 4]);
+        if (TestHasEvents(i)) {
+            fprintf(file, "event %d %d\nevent 0 %d\nevent %d %d\n", frames - 1, i * 10 + 1, i * 10 + 2, frames - 1, i * 10 + 3);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static int RunBaker(const char* input, const char* output) {
+    char command[256];
+    snprintf(command, sizeof(command), "%s %s %s > /dev/null", BAKED_TEST_BAKER, input, output);
+    return system(command);
+}
+
+// Markers are sorted by frame, keeping the written order within a frame
+static bool IsEventIntact(const AnimationClip* clip, int i) {
+    if (!TestHasEvents(i)) return clip->eventCount == 0;
+    int last = TestFrameCount(i) - 1;
+    int first = last > 0 ? i * 10 + 2 : i * 10 + 1;
+    int second = last > 0 ? i * 10 + 1 : i * 10 + 2;
+    return clip->eventCount == 3 &&
+           clip->events[0].frame == 0 && clip->events[0].eventId == first &&
+           clip->events[1].frame == last && clip->events[1].eventId == second &&
+           clip->events[2].frame == last && clip->events[2].eventId == i * 10 + 3;
+}
+
+static bool IsClipIntact(const AnimationClip* clip, int i) {
+    char name[MAX_ANIMATION_NAME_LENGTH];
+    snprintf(name, sizeof(name), "clip_%d", i);
+    const Spritesheet* sheet = GetSpritesheet(clip->spritesheet);
+    AnimationSequenceType type = i % 4 == 3 ? ANIMATION_SEQUENCE_LOOP : (AnimationSequenceType)(i % 4);
+    if (strcmp(clip->name, name) != 0 || clip->ownsTables || sheet == NULL || strcmp(sheet->name, g_testSheets[i % 3]) != 0 ||
+        clip->firstFrame != TestFirstFrame(i) || clip->sequence.frameCount != TestFrameCount(i) ||
+        clip->sequence.sequenceType != type || clip->frameTime != strtof(g_testFrameTimes[i % 4], NULL)) {
+        return false;
+    }
+    // Frames are read in place from the mapping
+    const unsigned char* frames = (const unsigned char*)clip->sequence.frames;
+    if (frames < g_bakedAnimations.file.data || frames >= g_bakedAnimations.file.data + g_bakedAnimations.file.size) return false;
+    for (int k = 0; k < clip->sequence.frameCount; k++) {
+        const AnimationFrame* frame = &clip->sequence.frames[k];
+        if (frame->frameIndex != TestFirstFrame(i) + k || frame->duration != clip->frameTime) return false;
+    }
+    return IsEventIntact(clip, i);
+}
+
+// A damaged blob is refused and registers nothing
+static void CheckRejected(const unsigned char* data, size_t size) {
+    FILE* file = fopen(BAKED_TEST_BAD_BLOB, "wb");
+    CHECK(file != NULL);
+    if (file == NULL) return;
+    fwrite(data, 1, size, file);
+    fclose(file);
+    CHECK(!LoadBakedAnimations(&g_bakedAnimations, BAKED_TEST_BAD_BLOB));
+    CHECK(!g_bakedAnimations.loaded);
+    CHECK(g_animationClips.count == 0);
+}
+
+int main(void) {
+    CHECK(WriteTestDescription());
+    CHECK(RunBaker(BAKED_TEST_TEXT, BAKED_TEST_BLOB) == 0);
+
+    // A clip past the end of its sheet, and an event past the end of its clip
+    CHECK(WriteTestText(BAKED_TEST_BAD_TEXT, "sheet a res/image/a.png 16 16 4\nclip z a 2 3 0.1\n"));
+    CHECK(RunBaker(BAKED_TEST_BAD_TEXT, BAKED_TEST_BAD_BLOB) != 0);
+    CHECK(WriteTestText(BAKED_TEST_BAD_TEXT, "sheet a res/image/a.png 16 16 4\nclip z a 0 3 0.1\nevent 3 1\n"));
+    CHECK(RunBaker(BAKED_TEST_BAD_TEXT, BAKED_TEST_BAD_BLOB) != 0);
+
+    InitAssetManager();
+    int textureLoads = g_raylibStub.textureLoads;
+    CHECK(LoadBakedAnimations(&g_bakedAnimations, BAKED_TEST_BLOB));
+    CHECK(g_raylibStub.textureLoads == textureLoads + 3);
+    CHECK(!LoadBakedAnimations(&g_bakedAnimations, BAKED_TEST_BLOB));
+    CHECK(g_animationClips.count == BAKED_TEST_CLIPS);
+
+    size_t mismatches = 0;
+    char name[MAX_ANIMATION_NAME_LENGTH];
+    for (int i = 0; i < BAKED_TEST_CLIPS; i++) {
+        snprintf(name, sizeof(name), "clip_%d", i);
+        const AnimationClip* clip = GetAnimationClip(FindAnimationClip(name));
+        if (clip == NULL || !IsClipIntact(clip, i)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // Sheet frame counts and pivots come through too
+    const Spritesheet* pivoted = GetSpritesheet(FindSpritesheet("b"));
+    CHECK(pivoted != NULL && pivoted->frameCount == 20 && pivoted->frames[0].origin.x == 4.0f);
+    const Spritesheet* filled = GetSpritesheet(FindSpritesheet("c"));
+    CHECK(filled != NULL && filled->frameCount == (STUB_TEXTURE_SIZE / 8) * (STUB_TEXTURE_SIZE / 8));
+    // Baked tables are read-only
+    CHECK(!AddAnimationClipEvent(0, 0, 1));
+
+    UnloadAnimationClips();
+    UnloadBakedAnimations(&g_bakedAnimations);
+    UnloadSpritesheets();
+
+    // Damaged copies of the good blob
+    FILE* file = fopen(BAKED_TEST_BLOB, "rb");
+    CHECK(file != NULL);
+    if (file != NULL) {
+        fseek(file, 0, SEEK_END);
+        size_t size = (size_t)ftell(file);
+        rewind(file);
+        unsigned char* blob = (unsigned char*)malloc(size);
+        CHECK(blob != NULL && fread(blob, 1, size, file) == size);
+        fclose(file);
+        if (blob != NULL) {
+            BakedAnimationHeader* header = (BakedAnimationHeader*)blob;
+            CheckRejected(blob, size - 10);
+            CheckRejected(blob, sizeof(BakedAnimationHeader) - 1);
+
+            BakedAnimationClip* clips = (BakedAnimationClip*)(blob + header->clipsOffset);
+            clips[7].sheet = 9;
+            CheckRejected(blob, size);
+            clips[7].sheet = 1;
+            clips[8].frames = header->frameCount;
+            CheckRejected(blob, size);
+            clips[8].frames = 0;
+            clips[9].type = 7;
+            CheckRejected(blob, size);
+            clips[9].type = ANIMATION_SEQUENCE_LOOP;
+            header->version = BAKED_ANIMATION_VERSION + 1;
+            CheckRejected(blob, size);
+            header->version = BAKED_ANIMATION_VERSION;
+            memcpy(header->magic, "XXXX", 4);
+            CheckRejected(blob, size);
+            free(blob);
+        }
+    }
+
+    UnloadAssetManager();
+    remove(BAKED_TEST_TEXT);
+    remove(BAKED_TEST_BLOB);
+    remove(BAKED_TEST_BAD_TEXT);
+    remove(BAKED_TEST_BAD_BLOB);
+    return FinishTest("baked animation");
+}
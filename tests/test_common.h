@@ -0,0 +1,39 @@
+// =============================================================
+// Headless test helpers
+// =============================================================
+// Shared by the tests/test_*.c programs behind `make test`. Each test is
+// a standalone program linked against tools/raylib_stub.c; it prints a
+// line per failed check and exits non-zero if any failed.
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <stdio.h>
+#include <time.h>
+
+static int g_testFailures = 0;
+
+// Record a failed check without stopping the test
+#define CHECK(condition) do { \
+        if (!(condition)) { \
+            printf("✗ %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            g_testFailures++; \
+        } \
+    } while (0)
+
+static inline double TestSeconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Print the result line and turn it into the exit status
+static inline int FinishTest(const char* name) {
+    if (g_testFailures > 0) {
+        printf("✗ %s: %d check(s) failed\n", name, g_testFailures);
+        return 1;
+    }
+    printf("✓ %s\n", name);
+    return 0;
+}
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,141 @@
+// =============================================================
+// Entity command test
+// =============================================================
+// Records spawns, despawns and changes into command buffers and flushes
+// them, on both storage layouts. A large despawn batch is compacted in
+// one ordered pass, so survivors keep their relative order; a small one
+// is swap-removed. Either way handles, names, queries and component
+// columns must agree with the rows afterwards.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+#define COMMAND_TEST_ENTITIES 4096
+
+static EntityHandle g_handles[COMMAND_TEST_ENTITIES];
+
+// Despawn every third entity from inside an update
+static void Cull(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)deltaTime;
+    EntityManager* manager = (EntityManager*)userData;
+    for (size_t i = 0; i < count; i++) {
+        if (entities[i]->id % 3 == 0) RecordDespawnEntity(&manager->commands, entities[i]->handle);
+    }
+}
+
+static void FillWorld(EntityManager* manager, EntityBehaviourId cull, EntityComponentId tag) {
+    for (int i = 0; i < COMMAND_TEST_ENTITIES; i++) {
+        Entity* entity = CreateEntity();
+        entity->id = i;
+        snprintf(entity->name, MAX_ENTITY_NAME_LENGTH, "entity_%d", i);
+        entity->isActive = true;
+        entity->position = (Vector2){ (float)i, 0.0f };
+        entity->behaviourId = cull;
+        entity->signature = i % 2 == 0 ? ENTITY_SIGNATURE_BIT(tag) : 0;
+        g_handles[i] = AddEntity(manager, entity);
+    }
+}
+
+// Rows, slots, names, the query and the position column all agree
+static void CheckRows(EntityManager* manager, EntityQueryId tagged) {
+    size_t mismatches = 0;
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        Entity* entity = GetEntityAtRow(manager, row);
+        if (entity == NULL || GetEntity(manager, entity->handle) != entity ||
+            GetEntityByName(manager, entity->name) != entity) {
+            mismatches++;
+            continue;
+        }
+        if (manager->useComponentStore) {
+            EntityChunk* chunk = GetEntityChunk(manager, row);
+            if (chunk->positions[row & ENTITY_CHUNK_MASK].x != entity->position.x) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    size_t rowCount = 0;
+    const uint32_t* rows = GetEntityQueryRows(manager, tagged, &rowCount);
+    EntityView view = GetEntityQueryView(manager, tagged);
+    size_t expected = 0;
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        if (GetEntityAtRow(manager, row)->signature != 0) expected++;
+    }
+    CHECK(rowCount == expected && view.count == expected);
+    mismatches = 0;
+    for (size_t i = 0; i < view.count; i++) {
+        if (rows[i] >= manager->entityCount || GetEntityAtRow(manager, rows[i]) != view.items[i]) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+static bool IsRowOrderAscending(const EntityManager* manager) {
+    for (size_t row = 1; row < manager->entityCount; row++) {
+        if (GetEntityAtRow(manager, row - 1)->id > GetEntityAtRow(manager, row)->id) return false;
+    }
+    return true;
+}
+
+static void RunCommands(bool componentStore) {
+    EntityManager manager;
+    InitEntityManager(&manager);
+    EntityComponentId tag = RegisterEntityComponent(&manager, "tag");
+    EntityQueryId tagged = RegisterEntityQuery(&manager, ENTITY_SIGNATURE_BIT(tag), 0);
+    EntityBehaviourId cull = RegisterEntityBehaviour(&manager, &(EntityBehaviour){
+        .name = "cull", .UpdateBatch = Cull, .userData = &manager });
+    FillWorld(&manager, cull, tag);
+    if (componentStore) EnableEntityComponentStore(&manager);
+
+    // A third of the world despawns during an update: one compaction pass
+    UpdateEntities(&manager, 1.0f / 60.0f);
+    CHECK(manager.commands.count == 0);
+    CHECK(manager.entityCount == COMMAND_TEST_ENTITIES - (COMMAND_TEST_ENTITIES + 2) / 3);
+    CHECK(IsRowOrderAscending(&manager));
+    CHECK(GetEntity(&manager, g_handles[0]) == NULL && GetEntityByName(&manager, "entity_3") == NULL);
+    CHECK(GetEntity(&manager, g_handles[1]) != NULL);
+    CheckRows(&manager, tagged);
+    size_t survivors = manager.entityCount;
+
+    // A few despawns are swap-removed. Commands on a despawned entity and
+    // repeated or stale despawns are ignored.
+    EntityCommandBuffer buffer;
+    InitEntityCommandBuffer(&buffer);
+    RecordDespawnEntity(&buffer, g_handles[1]);
+    RecordDespawnEntity(&buffer, g_handles[1]);
+    RecordDespawnEntity(&buffer, g_handles[3]);
+    RecordDespawnEntity(&buffer, g_handles[2]);
+    RecordSetEntityPosition(&buffer, g_handles[2], (Vector2){ -1.0f, -1.0f });
+    RecordSetEntityPosition(&buffer, g_handles[4], (Vector2){ 7.0f, 8.0f });
+    RecordSetEntityActive(&buffer, g_handles[5], false);
+    RecordSetEntityBehaviour(&buffer, g_handles[5], ENTITY_BEHAVIOUR_NONE);
+    RecordChangeEntityComponents(&buffer, g_handles[4], 0, ENTITY_SIGNATURE_BIT(tag));
+    RecordChangeEntityComponents(&buffer, g_handles[5], ENTITY_SIGNATURE_BIT(tag), 0);
+    Entity* spawned = CreateEntity();
+    spawned->id = COMMAND_TEST_ENTITIES;
+    snprintf(spawned->name, MAX_ENTITY_NAME_LENGTH, "spawned");
+    spawned->isActive = true;
+    spawned->signature = ENTITY_SIGNATURE_BIT(tag);
+    RecordSpawnEntity(&buffer, spawned);
+    FlushEntityCommands(&manager, &buffer);
+    CHECK(buffer.count == 0);
+    CHECK(manager.entityCount == survivors - 2 + 1);
+    CHECK(GetEntity(&manager, g_handles[1]) == NULL && GetEntity(&manager, g_handles[2]) == NULL);
+    Entity* moved = GetEntity(&manager, g_handles[4]);
+    CHECK(moved != NULL && moved->position.x == 7.0f && moved->signature == 0);
+    Entity* changed = GetEntity(&manager, g_handles[5]);
+    CHECK(changed != NULL && !changed->isActive && changed->behaviourId == ENTITY_BEHAVIOUR_NONE &&
+          changed->signature == ENTITY_SIGNATURE_BIT(tag));
+    CHECK(GetEntityByName(&manager, "spawned") == spawned);
+    CheckRows(&manager, tagged);
+    FreeEntityCommandBuffer(&buffer);
+
+    FreeEntityManager(&manager);
+}
+
+int main(void) {
+    InitAssetManager();
+    RunCommands(false);
+    RunCommands(true);
+    UnloadAssetManager();
+    return FinishTest("entity commands");
+}
@@ -0,0 +1,78 @@
+// =============================================================
+// Entity grid test
+// =============================================================
+// Moves entities from a behaviour's UpdateBatch, which writes positions
+// directly, and checks that rect, radius and pair queries made after
+// UpdateEntities see where the entities are now, not where the last
+// rebuild left them.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+#define GRID_TEST_ENTITIES 100
+#define GRID_TEST_SIZE 8.0f
+#define GRID_TEST_SPACING 100.0f
+#define GRID_TEST_STEP 1000.0f
+
+// Every member moves one step to the right
+static void Slide(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)deltaTime;
+    (void)userData;
+    for (size_t i = 0; i < count; i++) {
+        entities[i]->position.x += GRID_TEST_STEP;
+    }
+}
+
+static size_t CountInRect(EntityManager* manager, float x, float y) {
+    Entity* found[GRID_TEST_ENTITIES];
+    Rectangle area = { x, y, GRID_TEST_SIZE, GRID_TEST_SIZE };
+    return QueryEntitiesInRect(manager, area, found, GRID_TEST_ENTITIES);
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager manager;
+    InitEntityManager(&manager);
+    SetEntityGridCellSize(&manager, GRID_TEST_SIZE * 2.0f);
+    EntityBehaviourId slide = RegisterEntityBehaviour(&manager, &(EntityBehaviour){ .name = "slide", .UpdateBatch = Slide });
+
+    // A row of boxes, the odd ones stacked onto the even ones before them
+    for (int i = 0; i < GRID_TEST_ENTITIES; i++) {
+        Entity* entity = CreateEntity();
+        entity->id = i;
+        snprintf(entity->name, MAX_ENTITY_NAME_LENGTH, "box_%d", i);
+        entity->isActive = true;
+        entity->position = (Vector2){ (float)(i / 2) * GRID_TEST_SPACING, 0.0f };
+        entity->width = GRID_TEST_SIZE;
+        entity->height = GRID_TEST_SIZE;
+        entity->behaviourId = i % 2 == 0 ? slide : ENTITY_BEHAVIOUR_NONE;
+        AddEntity(&manager, entity);
+    }
+    EntityPair pairs[GRID_TEST_ENTITIES];
+    CHECK(CountInRect(&manager, 0.0f, 0.0f) == 2);
+    CHECK(FindEntityCollisionPairs(&manager, pairs, GRID_TEST_ENTITIES) == GRID_TEST_ENTITIES / 2);
+
+    // The sliders leave their stacks; the grid was clean before the update
+    UpdateEntities(&manager, 1.0f / 60.0f);
+    CHECK(CountInRect(&manager, 0.0f, 0.0f) == 1);
+    CHECK(CountInRect(&manager, GRID_TEST_STEP, 0.0f) == 2);
+    // The last slider is past the end of the row, alone
+    Entity* found[GRID_TEST_ENTITIES];
+    float last = (float)(GRID_TEST_ENTITIES / 2 - 1) * GRID_TEST_SPACING + GRID_TEST_STEP;
+    Vector2 center = { last + GRID_TEST_SIZE * 0.5f, GRID_TEST_SIZE * 0.5f };
+    size_t near = QueryEntitiesInRadius(&manager, center, 1.0f, found, GRID_TEST_ENTITIES);
+    CHECK(near == 1 && found[0]->id == GRID_TEST_ENTITIES - 2);
+    // Slid boxes land on the spots of stacks ten places on
+    size_t landed = FindEntityCollisionPairs(&manager, pairs, GRID_TEST_ENTITIES);
+    CHECK(landed == (size_t)(GRID_TEST_ENTITIES / 2 - GRID_TEST_STEP / GRID_TEST_SPACING));
+
+    // Positions written outside an update need an explicit rebuild
+    GetEntityByID(&manager, 1)->position.y = GRID_TEST_SPACING;
+    RebuildEntitySpatialGrid(&manager);
+    CHECK(CountInRect(&manager, 0.0f, GRID_TEST_SPACING) == 1);
+
+    FreeEntityManager(&manager);
+    UnloadAssetManager();
+    return FinishTest("entity grid");
+}
@@ -0,0 +1,120 @@
+// =============================================================
+// Entity prefab test
+// =============================================================
+// Registers a prefab with a type, behaviour, signature and shared
+// sprite, instantiates it in bulk and checks that every instance is a
+// full member of the manager and holds its own texture reference.
+// Also covers the entity limit, deferred spawns during an update and
+// prefabs that are refused.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+#define PREFAB_TEST_INSTANCES 1000
+#define PREFAB_TEST_SPAWNS 4
+
+static EntityPrefabId g_goblin;
+
+// The first member spawns a few more goblins while entities update
+static void Spawn(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)entities;
+    (void)deltaTime;
+    EntityManager* manager = (EntityManager*)userData;
+    if (count == 0) return;
+    EntityHandle handles[PREFAB_TEST_SPAWNS];
+    CHECK(InstantiatePrefab(manager, g_goblin, PREFAB_TEST_SPAWNS, NULL, handles) == PREFAB_TEST_SPAWNS);
+    CHECK(handles[0].generation == 0);
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager manager;
+    InitEntityManager(&manager);
+    EntityComponentId tag = RegisterEntityComponent(&manager, "tag");
+    EntityQueryId tagged = RegisterEntityQuery(&manager, ENTITY_SIGNATURE_BIT(tag), 0);
+    EntityBehaviourId walk = RegisterEntityBehaviour(&manager, &(EntityBehaviour){ .name = "walk" });
+    int texture = AcquireAssetTexture("res/image/goblin.png");
+    CHECK(texture != ASSET_TEXTURE_NONE);
+
+    EntityPrefab prefab = {0};
+    snprintf(prefab.entity.name, MAX_ENTITY_NAME_LENGTH, "goblin");
+    prefab.entity.entityType = "enemy";
+    prefab.entity.behaviourId = walk;
+    prefab.entity.signature = ENTITY_SIGNATURE_BIT(tag);
+    prefab.entity.isActive = true;
+    prefab.entity.position = (Vector2){ 5.0f, 6.0f };
+    prefab.entity.hitbox = (Hitbox_t){ 1, 2, 6, 10 };
+    prefab.sprite = (SpriteObject){ .textureHandle = texture, .sharedTexture = true, .visible = true,
+                                    .texture = GetAssetTextureByHandle(texture), .position = { 2.0f, 3.0f } };
+    prefab.hasSprite = true;
+    g_goblin = RegisterEntityPrefab(&manager, "goblin", &prefab);
+    CHECK(g_goblin != ENTITY_PREFAB_NONE);
+    CHECK(FindEntityPrefab(&manager, "goblin") == g_goblin);
+    CHECK(RegisterEntityPrefab(&manager, "goblin", &prefab) == ENTITY_PREFAB_NONE);
+    CHECK(GetAssetTextureRefCount(texture) == 2);
+    ReleaseAssetTexture(texture);
+
+    // Owned textures cannot be shared by instances
+    EntityPrefab owned = prefab;
+    owned.sprite.sharedTexture = false;
+    CHECK(RegisterEntityPrefab(&manager, "owned", &owned) == ENTITY_PREFAB_NONE);
+
+    Vector2 positions[PREFAB_TEST_INSTANCES];
+    EntityHandle handles[PREFAB_TEST_INSTANCES];
+    for (int i = 0; i < PREFAB_TEST_INSTANCES; i++) {
+        positions[i] = (Vector2){ (float)i * 10.0f, (float)-i };
+    }
+    CHECK(InstantiatePrefab(&manager, g_goblin, PREFAB_TEST_INSTANCES, positions, handles) == PREFAB_TEST_INSTANCES);
+    CHECK(manager.entityCount == PREFAB_TEST_INSTANCES);
+    size_t mismatches = 0;
+    for (int i = 0; i < PREFAB_TEST_INSTANCES; i++) {
+        const Entity* entity = GetEntity(&manager, handles[i]);
+        if (entity == NULL || entity->position.x != positions[i].x || entity->position.y != positions[i].y ||
+            entity->hitbox.h != 10 || entity->sprite == NULL ||
+            entity->sprite->position.x != positions[i].x + 2.0f || entity->sprite->position.y != positions[i].y + 3.0f ||
+            entity->sprite->textureHandle != texture) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(GetAssetTextureRefCount(texture) == 1 + PREFAB_TEST_INSTANCES);
+    CHECK(GetEntityViewByType(&manager, FindEntityType(&manager, "enemy")).count == PREFAB_TEST_INSTANCES);
+    CHECK(GetEntityViewByBehaviour(&manager, walk).count == PREFAB_TEST_INSTANCES);
+    CHECK(GetEntityQueryView(&manager, tagged).count == PREFAB_TEST_INSTANCES);
+    CHECK(GetEntityByName(&manager, "goblin") != NULL);
+
+    // Without positions every instance starts at the template's
+    CHECK(InstantiatePrefab(&manager, g_goblin, 1, NULL, handles) == 1);
+    const Entity* placed = GetEntity(&manager, handles[0]);
+    CHECK(placed != NULL && placed->position.x == 5.0f && placed->sprite->position.x == 7.0f);
+    CHECK(InstantiatePrefab(&manager, ENTITY_PREFAB_NONE, 1, NULL, NULL) == 0);
+
+    // Instances spawned during an update arrive when it ends
+    size_t before = manager.entityCount;
+    EntityBehaviourId spawn = RegisterEntityBehaviour(&manager, &(EntityBehaviour){
+        .name = "spawn", .UpdateBatch = Spawn, .userData = &manager });
+    SetEntityBehaviour(&manager, GetEntity(&manager, handles[0]), spawn);
+    UpdateEntities(&manager, 1.0f / 60.0f);
+    CHECK(manager.entityCount == before + PREFAB_TEST_SPAWNS);
+    CHECK(GetEntityQueryView(&manager, tagged).count == before + PREFAB_TEST_SPAWNS);
+
+    // Removing the instances drops their references; the prefab keeps one
+    UnloadAllEntities(&manager);
+    CHECK(GetAssetTextureRefCount(texture) == 1);
+    FreeEntityManager(&manager);
+    CHECK(GetAssetTextureRefCount(texture) == 0);
+
+    // A capped manager creates what fits
+    EntityManager capped;
+    CHECK(InitEntityManagerWithCapacity(&capped, 16, 10));
+    prefab.hasSprite = false;
+    prefab.entity.behaviourId = ENTITY_BEHAVIOUR_NONE;
+    EntityPrefabId plain = RegisterEntityPrefab(&capped, "plain", &prefab);
+    CHECK(InstantiatePrefab(&capped, plain, 20, NULL, NULL) == 10);
+    CHECK(capped.entityCount == 10);
+    FreeEntityManager(&capped);
+
+    UnloadAssetManager();
+    return FinishTest("entity prefabs");
+}
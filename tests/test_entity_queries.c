@@ -0,0 +1,122 @@
+// =============================================================
+// Entity query test
+// =============================================================
+// Registers cached signature queries before and after entities exist,
+// then adds, removes and re-signs entities, including from inside an
+// update, and checks after each step that every query holds exactly the
+// matching entities and that its rows point back at them.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+#define QUERY_TEST_ENTITIES 1000
+
+static EntityComponentId g_position;
+static EntityComponentId g_velocity;
+static EntityComponentId g_frozen;
+
+// Query contents must match a scan of every entity
+static void CheckQuery(const EntityManager* manager, EntityQueryId queryId) {
+    const EntityQuery* query = &manager->queries[queryId];
+    EntityView view = GetEntityQueryView(manager, queryId);
+    size_t rowCount = 0;
+    const uint32_t* rows = GetEntityQueryRows(manager, queryId, &rowCount);
+    CHECK(rowCount == view.count);
+
+    size_t expected = 0;
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        EntitySignature signature = GetEntityAtRow(manager, row)->signature;
+        if ((signature & query->required) == query->required && (signature & query->excluded) == 0) expected++;
+    }
+    CHECK(view.count == expected);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < view.count; i++) {
+        const Entity* entity = view.items[i];
+        bool matches = (entity->signature & query->required) == query->required && (entity->signature & query->excluded) == 0;
+        if (!matches || rows[i] >= manager->entityCount || GetEntityAtRow(manager, rows[i]) != entity) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+// Every movable entity that is not frozen stops moving
+static void Freeze(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)deltaTime;
+    EntityManager* manager = (EntityManager*)userData;
+    for (size_t i = 0; i < count; i++) {
+        if (entities[i]->id % 2 == 0) AddEntityComponents(manager, entities[i], ENTITY_SIGNATURE_BIT(g_frozen));
+    }
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager manager;
+    InitEntityManager(&manager);
+    g_position = RegisterEntityComponent(&manager, "position");
+    g_velocity = RegisterEntityComponent(&manager, "velocity");
+    g_frozen = RegisterEntityComponent(&manager, "frozen");
+    CHECK(g_position == 0 && g_velocity == 1 && g_frozen == 2);
+    CHECK(RegisterEntityComponent(&manager, "velocity") == g_velocity);
+    CHECK(FindEntityComponent(&manager, "missing") == ENTITY_COMPONENT_NONE);
+    EntitySignature moving = ENTITY_SIGNATURE_BIT(g_position) | ENTITY_SIGNATURE_BIT(g_velocity);
+
+    // Half the entities exist before the queries, half after
+    EntityQueryId placed = RegisterEntityQuery(&manager, ENTITY_SIGNATURE_BIT(g_position), 0);
+    for (int i = 0; i < QUERY_TEST_ENTITIES; i++) {
+        if (i == QUERY_TEST_ENTITIES / 2) {
+            CheckQuery(&manager, placed);
+        }
+        Entity* entity = CreateEntity();
+        entity->id = i;
+        entity->isActive = true;
+        entity->signature = i % 3 == 0 ? moving : ENTITY_SIGNATURE_BIT(g_position);
+        if (i % 5 == 0) entity->signature |= ENTITY_SIGNATURE_BIT(g_frozen);
+        AddEntity(&manager, entity);
+    }
+    EntityQueryId movers = RegisterEntityQuery(&manager, moving, ENTITY_SIGNATURE_BIT(g_frozen));
+    CHECK(movers != ENTITY_QUERY_NONE && movers != placed);
+    CHECK(RegisterEntityQuery(&manager, moving, ENTITY_SIGNATURE_BIT(g_frozen)) == movers);
+    CheckQuery(&manager, placed);
+    CheckQuery(&manager, movers);
+    CHECK(GetEntityQueryView(&manager, placed).count == QUERY_TEST_ENTITIES);
+
+    // Components come and go one entity at a time
+    for (int i = 0; i < QUERY_TEST_ENTITIES; i += 7) {
+        Entity* entity = GetEntityByID(&manager, i);
+        if (i % 2 == 0) AddEntityComponents(&manager, entity, ENTITY_SIGNATURE_BIT(g_velocity));
+        else RemoveEntityComponents(&manager, entity, ENTITY_SIGNATURE_BIT(g_frozen));
+    }
+    SetEntitySignature(&manager, GetEntityByID(&manager, 1), 0);
+    CheckQuery(&manager, placed);
+    CheckQuery(&manager, movers);
+    CHECK(GetEntityQueryView(&manager, placed).count == QUERY_TEST_ENTITIES - 1);
+
+    // Removals move other entities into the freed rows
+    for (int i = 0; i < QUERY_TEST_ENTITIES; i += 4) {
+        RemoveEntity(&manager, i);
+    }
+    CheckQuery(&manager, placed);
+    CheckQuery(&manager, movers);
+
+    // Changes made by a behaviour land once the update is over
+    EntityBehaviourId freeze = RegisterEntityBehaviour(&manager, &(EntityBehaviour){
+        .name = "freeze", .UpdateBatch = Freeze, .userData = &manager });
+    EntityView view = GetEntityQueryView(&manager, movers);
+    size_t before = view.count;
+    for (size_t i = 0; i < view.count; i++) {
+        SetEntityBehaviour(&manager, view.items[i], freeze);
+    }
+    UpdateEntities(&manager, 1.0f / 60.0f);
+    CheckQuery(&manager, placed);
+    CheckQuery(&manager, movers);
+    CHECK(GetEntityQueryView(&manager, movers).count < before);
+
+    // A query that can never match is allowed but empty
+    EntityQueryId never = RegisterEntityQuery(&manager, ENTITY_SIGNATURE_BIT(g_frozen), ENTITY_SIGNATURE_BIT(g_frozen));
+    CHECK(never != ENTITY_QUERY_NONE && GetEntityQueryView(&manager, never).count == 0);
+
+    FreeEntityManager(&manager);
+    UnloadAssetManager();
+    return FinishTest("entity queries");
+}
@@ -0,0 +1,138 @@
+// =============================================================
+// Entity simulation LOD test
+// =============================================================
+// Places entities at set distances from a simulation region and checks
+// that each tier is updated at its rate with the time accumulated since
+// its last run, that sleeping entities are skipped until woken, and that
+// an entity moved by its behaviour is re-tiered from where it is now.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+
+#define SIMULATION_TEST_PER_TIER 10
+#define SIMULATION_TEST_ENTITIES (SIMULATION_TEST_PER_TIER * ENTITY_SIMULATION_TIER_COUNT)
+#define SIMULATION_TEST_STEP 0.25f  // Exact in binary, so accumulated steps are too
+#define SIMULATION_TEST_FAR 5000.0f
+
+// Distance from the region for each tier
+static const float g_tierDistances[ENTITY_SIMULATION_TIER_COUNT] = { 50.0f, 150.0f, 300.0f, 1000.0f };
+
+static float g_elapsed[SIMULATION_TEST_ENTITIES];
+static int g_calls[SIMULATION_TEST_ENTITIES];
+static int g_leaver = -1;
+
+// Count calls and time per entity; the leaver walks out of range
+static void Tick(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)userData;
+    for (size_t i = 0; i < count; i++) {
+        g_elapsed[entities[i]->id] += deltaTime;
+        g_calls[entities[i]->id]++;
+        if (entities[i]->id == g_leaver) entities[i]->position.x = SIMULATION_TEST_FAR;
+    }
+}
+
+static void ResetCounts(void) {
+    for (int i = 0; i < SIMULATION_TEST_ENTITIES; i++) {
+        g_elapsed[i] = 0.0f;
+        g_calls[i] = 0;
+    }
+}
+
+static void RunFrames(EntityManager* manager, int frames) {
+    for (int i = 0; i < frames; i++) {
+        UpdateEntities(manager, SIMULATION_TEST_STEP);
+    }
+}
+
+// Every entity of a tier has the same call count and elapsed time
+static void CheckTier(int tier, int calls, float elapsed) {
+    size_t mismatches = 0;
+    for (int i = tier * SIMULATION_TEST_PER_TIER; i < (tier + 1) * SIMULATION_TEST_PER_TIER; i++) {
+        if (i == g_leaver) continue;
+        if (g_calls[i] != calls || g_elapsed[i] != elapsed) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager manager;
+    InitEntityManager(&manager);
+    EntityBehaviourId tick = RegisterEntityBehaviour(&manager, &(EntityBehaviour){ .name = "tick", .UpdateBatch = Tick });
+    for (int i = 0; i < SIMULATION_TEST_ENTITIES; i++) {
+        Entity* entity = CreateEntity();
+        entity->id = i;
+        entity->isActive = true;
+        entity->position = (Vector2){ g_tierDistances[i / SIMULATION_TEST_PER_TIER], (float)i };
+        entity->width = 1.0f;
+        entity->height = 1.0f;
+        entity->behaviourId = tick;
+        AddEntity(&manager, entity);
+    }
+
+    // Intervals are rounded up to powers of two: 3 becomes 4
+    EntitySimulationSettings settings = { { 100.0f, 200.0f, 400.0f }, { 1, 2, 3 } };
+    EnableEntitySimulationLod(&manager, &settings);
+    CHECK(manager.simulation.settings.interval[ENTITY_SIMULATION_DISTANT] == 4);
+    Vector2 region = { 0.0f, 0.0f };
+    SetEntitySimulationRegions(&manager, &region, 1);
+
+    // Everything runs at full rate until the first refresh
+    RunFrames(&manager, 4);
+    for (int tier = 0; tier < ENTITY_SIMULATION_TIER_COUNT; tier++) {
+        CheckTier(tier, 4, 1.0f);
+    }
+    EntitySimulationStats stats = GetEntitySimulationStats(&manager);
+    for (int tier = 0; tier < ENTITY_SIMULATION_TIER_COUNT; tier++) {
+        CHECK(stats.population[tier] == SIMULATION_TEST_PER_TIER);
+    }
+
+    // Over two refresh periods every awake tier sees the same time in
+    // fewer, longer steps
+    ResetCounts();
+    RunFrames(&manager, 8);
+    CheckTier(ENTITY_SIMULATION_FULL, 8, 2.0f);
+    CheckTier(ENTITY_SIMULATION_REDUCED, 4, 2.0f);
+    CheckTier(ENTITY_SIMULATION_DISTANT, 2, 2.0f);
+    CheckTier(ENTITY_SIMULATION_SLEEPING, 0, 0.0f);
+    stats = GetEntitySimulationStats(&manager);
+    CHECK(stats.updated[ENTITY_SIMULATION_FULL] == SIMULATION_TEST_PER_TIER);
+    CHECK(stats.updated[ENTITY_SIMULATION_DISTANT] == SIMULATION_TEST_PER_TIER);
+
+    // A woken sleeper runs at full rate until its wake time runs out
+    int sleeper = ENTITY_SIMULATION_SLEEPING * SIMULATION_TEST_PER_TIER;
+    WakeEntity(&manager, GetEntityByID(&manager, sleeper), 1.5f);
+    ResetCounts();
+    RunFrames(&manager, 12);
+    CHECK(g_calls[sleeper] == 8);
+    CHECK(GetEntityByID(&manager, sleeper)->simulationTier == ENTITY_SIMULATION_SLEEPING);
+
+    // An entity that walks out of range in its own update goes to sleep
+    // at the next refresh
+    g_leaver = 0;
+    RunFrames(&manager, 4);
+    CHECK(GetEntityByID(&manager, g_leaver)->simulationTier == ENTITY_SIMULATION_SLEEPING);
+
+    // One moved in from outside wakes up at the next refresh
+    Entity* arrival = GetEntityByID(&manager, sleeper + 1);
+    SetEntityPosition(&manager, arrival, (Vector2){ 10.0f, 10.0f });
+    RunFrames(&manager, 4);
+    CHECK(arrival->simulationTier == ENTITY_SIMULATION_FULL);
+    stats = GetEntitySimulationStats(&manager);
+    CHECK(stats.population[ENTITY_SIMULATION_FULL] == SIMULATION_TEST_PER_TIER);
+    CHECK(stats.population[ENTITY_SIMULATION_SLEEPING] == SIMULATION_TEST_PER_TIER);
+
+    // Turned off, every entity runs every frame again
+    DisableEntitySimulationLod(&manager);
+    g_leaver = -1;
+    ResetCounts();
+    RunFrames(&manager, 2);
+    for (int tier = 0; tier < ENTITY_SIMULATION_TIER_COUNT; tier++) {
+        CheckTier(tier, 2, 0.5f);
+    }
+
+    FreeEntityManager(&manager);
+    UnloadAssetManager();
+    return FinishTest("entity simulation");
+}
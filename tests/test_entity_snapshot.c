@@ -0,0 +1,165 @@
+// =============================================================
+// Entity snapshot test
+// =============================================================
+// Saves 100k entities, unloads them and loads them back the way a level
+// reload would, then checks every field survived, that the round trip
+// is under the 50 ms budget, that each texture is loaded once and that
+// damaged files are refused.
+#include "entity/entity_snapshot.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <string.h>
+
+#define SNAPSHOT_TEST_ENTITIES 100000
+#define SNAPSHOT_TEST_BUDGET 0.050
+#define SNAPSHOT_TEST_PATH "bin/test_snapshot.bin"
+#define SNAPSHOT_TEST_BAD_PATH "bin/test_snapshot_bad.bin"
+
+static const char* g_testTypes[] = { "enemy", "bullet", "pickup" };
+
+static void NoUpdate(Entity** entities, size_t count, float deltaTime, void* userData) {
+    (void)entities;
+    (void)count;
+    (void)deltaTime;
+    (void)userData;
+}
+
+// Entity i is fully determined by i, so loaded entities can be checked
+// without keeping the originals around
+static void FillWorld(EntityManager* manager, EntityBehaviourId walk) {
+    for (int i = 0; i < SNAPSHOT_TEST_ENTITIES; i++) {
+        Entity* entity = CreateEntity();
+        entity->id = i;
+        snprintf(entity->name, MAX_ENTITY_NAME_LENGTH, "entity_%d", i);
+        entity->entityType = g_testTypes[i % 3];
+        entity->behaviourId = i % 5 == 0 ? walk : ENTITY_BEHAVIOUR_NONE;
+        entity->isActive = i % 2 == 0;
+        entity->position = (Vector2){ (float)i, (float)-i };
+        entity->width = 8.0f;
+        entity->height = 12.0f;
+        entity->hitbox = (Hitbox_t){ 1, 2, 6, 10 };
+        if (i % 2 == 1) {
+            SpriteObject* sprite = CreateSpriteObject();
+            sprite->id = i;
+            strcpy(sprite->name, "sprite");
+            LoadSpriteObjectTexture(sprite, i % 4 == 1 ? "res/image/a.png" : "res/image/b.png");
+            sprite->position = (Vector2){ (float)i, 3.0f };
+            sprite->scale = (Vector2){ 2.0f, 2.0f };
+            sprite->tint = (Color){ 10, 20, 30, 40 };
+            sprite->visible = true;
+            sprite->totalFrames = 4;
+            sprite->currentFrame = i % 4;
+            sprite->frameTime = 0.25f;
+            entity->sprite = sprite;
+        }
+        AddEntity(manager, entity);
+    }
+}
+
+static bool IsSpriteIntact(const SpriteObject* sprite, int i) {
+    if (i % 2 == 0) return sprite == NULL;
+    return sprite != NULL && sprite->id == i && strcmp(sprite->name, "sprite") == 0 && sprite->sharedTexture &&
+           sprite->position.x == (float)i && sprite->scale.x == 2.0f && sprite->tint.a == 40 && sprite->visible &&
+           sprite->totalFrames == 4 && sprite->currentFrame == i % 4 && sprite->frameTime == 0.25f;
+}
+
+static void CheckWorld(const EntityManager* manager, EntityBehaviourId walk) {
+    CHECK(manager->entityCount == SNAPSHOT_TEST_ENTITIES);
+    size_t mismatches = 0;
+    char name[MAX_ENTITY_NAME_LENGTH];
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        const Entity* entity = GetEntityAtRow(manager, row);
+        int i = (int)row;
+        snprintf(name, sizeof(name), "entity_%d", i);
+        bool intact = entity->id == i && strcmp(entity->name, name) == 0 && entity->nameHash == HashEntityName(name) &&
+                      entity->typeId != ENTITY_TYPE_NONE && entity->entityType == manager->types[entity->typeId].name &&
+                      strcmp(entity->entityType, g_testTypes[i % 3]) == 0 &&
+                      entity->behaviourId == (i % 5 == 0 ? walk : ENTITY_BEHAVIOUR_NONE) &&
+                      entity->isActive == (i % 2 == 0) && entity->position.x == (float)i && entity->position.y == (float)-i &&
+                      entity->width == 8.0f && entity->height == 12.0f && entity->hitbox.x == 1 && entity->hitbox.h == 10 &&
+                      IsSpriteIntact(entity->sprite, i);
+        if (!intact) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    const Entity* named = GetEntityByName(manager, "entity_12345");
+    CHECK(named != NULL && named->id == 12345);
+    CHECK(GetEntityViewByBehaviour(manager, walk).count == SNAPSHOT_TEST_ENTITIES / 5);
+    CHECK(GetEntityViewByType(manager, FindEntityType(manager, "enemy")).count == (SNAPSHOT_TEST_ENTITIES + 2) / 3);
+}
+
+static void CheckRejected(const void* data, size_t size) {
+    FILE* file = fopen(SNAPSHOT_TEST_BAD_PATH, "wb");
+    CHECK(file != NULL);
+    if (file == NULL) return;
+    fwrite(data, 1, size, file);
+    fclose(file);
+    EntityManager manager;
+    InitEntityManager(&manager);
+    CHECK(LoadEntitySnapshot(&manager, SNAPSHOT_TEST_BAD_PATH) == 0);
+    CHECK(manager.entityCount == 0);
+    FreeEntityManager(&manager);
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager world;
+    InitEntityManager(&world);
+    EntityBehaviourId walk = RegisterEntityBehaviour(&world, &(EntityBehaviour){ .name = "walk", .UpdateBatch = NoUpdate });
+    FillWorld(&world, walk);
+    int textureLoads = g_raylibStub.textureLoads;
+
+    // Save, clear the level and load it back
+    double start = TestSeconds();
+    CHECK(SaveEntitySnapshot(&world, SNAPSHOT_TEST_PATH));
+    double saved = TestSeconds();
+    UnloadAllEntities(&world);
+    double loadStart = TestSeconds();
+    CHECK(LoadEntitySnapshot(&world, SNAPSHOT_TEST_PATH) == SNAPSHOT_TEST_ENTITIES);
+    double loaded = TestSeconds();
+    double roundTrip = (saved - start) + (loaded - loadStart);
+    printf("  %d entities: save %.2f ms, load %.2f ms\n", SNAPSHOT_TEST_ENTITIES,
+           (saved - start) * 1000.0, (loaded - loadStart) * 1000.0);
+    CHECK(roundTrip < SNAPSHOT_TEST_BUDGET);
+    // Unloading released both textures, so each is loaded once more
+    CHECK(g_raylibStub.textureLoads == textureLoads + 2);
+    CheckWorld(&world, walk);
+
+    // Behaviours are matched by name, so other registration orders work
+    EntityManager other;
+    InitEntityManager(&other);
+    RegisterEntityBehaviour(&other, &(EntityBehaviour){ .name = "idle", .UpdateBatch = NoUpdate });
+    EntityBehaviourId otherWalk = RegisterEntityBehaviour(&other, &(EntityBehaviour){ .name = "walk", .UpdateBatch = NoUpdate });
+    UnloadAllEntities(&world);
+    CHECK(LoadEntitySnapshot(&other, SNAPSHOT_TEST_PATH) == SNAPSHOT_TEST_ENTITIES);
+    CheckWorld(&other, otherWalk);
+    FreeEntityManager(&other);
+
+    // Bad magic, an older and a future version and a file cut off mid-record
+    EntitySnapshotHeader header = { .version = ENTITY_SNAPSHOT_VERSION };
+    memcpy(header.magic, "XXXX", 4);
+    CheckRejected(&header, sizeof(header));
+    memcpy(header.magic, ENTITY_SNAPSHOT_MAGIC, 4);
+    header.version = ENTITY_SNAPSHOT_VERSION - 1;
+    CheckRejected(&header, sizeof(header));
+    header.version = ENTITY_SNAPSHOT_VERSION + 1;
+    CheckRejected(&header, sizeof(header));
+    header = (EntitySnapshotHeader){
+        .version = ENTITY_SNAPSHOT_VERSION,
+        .headerSize = sizeof(EntitySnapshotHeader),
+        .recordSize = sizeof(EntitySnapshotRecord),
+        .entityCount = 2,
+        .recordsOffset = sizeof(EntitySnapshotHeader)
+    };
+    memcpy(header.magic, ENTITY_SNAPSHOT_MAGIC, 4);
+    unsigned char truncated[sizeof(EntitySnapshotHeader) + sizeof(EntitySnapshotRecord)] = {0};
+    memcpy(truncated, &header, sizeof(header));
+    CheckRejected(truncated, sizeof(truncated));
+
+    FreeEntityManager(&world);
+    UnloadAssetManager();
+    remove(SNAPSHOT_TEST_PATH);
+    remove(SNAPSHOT_TEST_BAD_PATH);
+    return FinishTest("entity snapshot");
+}
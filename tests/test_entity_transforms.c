@@ -0,0 +1,135 @@
+// =============================================================
+// Entity transform test
+// =============================================================
+// Builds a forest of parented entities and checks after every change
+// that entity and sprite positions match world transforms worked out
+// from scratch, and that an update recomputes only the subtrees under
+// nodes that changed. Also covers reparenting, cycles and removing a
+// parent from under its children.
+#include "entity/entity_manager.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <math.h>
+
+#define TRANSFORM_TEST_TREES 100
+#define TRANSFORM_TEST_FANOUT 4
+// A root, its arms and their hands
+#define TRANSFORM_TEST_TREE_SIZE (1 + TRANSFORM_TEST_FANOUT + TRANSFORM_TEST_FANOUT * TRANSFORM_TEST_FANOUT)
+#define TRANSFORM_TEST_EPSILON 0.001f
+
+static Entity* g_roots[TRANSFORM_TEST_TREES];
+static Entity* g_arms[TRANSFORM_TEST_TREES][TRANSFORM_TEST_FANOUT];
+
+static EntityTransform MakeTransform(float x, float y, float rotation, float scale) {
+    return (EntityTransform){ { x, y }, rotation, { scale, scale } };
+}
+
+static Entity* AddTransformEntity(EntityManager* manager, int id, Entity* parent, EntityTransform local) {
+    Entity* entity = CreateEntity();
+    entity->id = id;
+    entity->isActive = true;
+    if (id % 2 == 0) {
+        entity->sprite = CreateSpriteObject();
+        entity->sprite->scale = (Vector2){ 1.0f, 1.0f };
+    }
+    AddEntity(manager, entity);
+    CHECK(AttachEntityTransform(manager, entity, local));
+    if (parent != NULL) CHECK(SetEntityParent(manager, entity, parent));
+    return entity;
+}
+
+// World transform worked out from the locals, ignoring the cache
+static EntityTransform ExpectedWorld(const EntityTransformHierarchy* transforms, uint32_t node) {
+    const EntityTransformNode* entry = &transforms->nodes[node];
+    if (entry->parent == ENTITY_TRANSFORM_NONE) return entry->local;
+    return CombineEntityTransforms(ExpectedWorld(transforms, entry->parent), entry->local);
+}
+
+static bool IsNear(float a, float b) {
+    return fabsf(a - b) <= TRANSFORM_TEST_EPSILON * fmaxf(1.0f, fabsf(b));
+}
+
+static void CheckWorld(const EntityManager* manager) {
+    size_t mismatches = 0;
+    for (size_t row = 0; row < manager->entityCount; row++) {
+        const Entity* entity = GetEntityAtRow(manager, row);
+        EntityTransform expected = ExpectedWorld(&manager->transforms, entity->transformNode);
+        bool near = IsNear(entity->position.x, expected.position.x) && IsNear(entity->position.y, expected.position.y);
+        if (entity->sprite != NULL) {
+            near = near && IsNear(entity->sprite->position.x, expected.position.x) &&
+                   IsNear(entity->sprite->rotation, expected.rotation) && IsNear(entity->sprite->scale.x, expected.scale.x);
+        }
+        if (!near) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void) {
+    InitAssetManager();
+    EntityManager manager;
+    InitEntityManager(&manager);
+    int id = 0;
+    for (int t = 0; t < TRANSFORM_TEST_TREES; t++) {
+        g_roots[t] = AddTransformEntity(&manager, id++, NULL, MakeTransform((float)t * 100.0f, 0.0f, (float)t, 1.0f));
+        for (int a = 0; a < TRANSFORM_TEST_FANOUT; a++) {
+            g_arms[t][a] = AddTransformEntity(&manager, id++, g_roots[t], MakeTransform(10.0f, (float)a, 90.0f * a, 2.0f));
+            for (int h = 0; h < TRANSFORM_TEST_FANOUT; h++) {
+                AddTransformEntity(&manager, id++, g_arms[t][a], MakeTransform(1.0f, (float)h, 0.0f, 0.5f));
+            }
+        }
+    }
+    UpdateEntities(&manager, 1.0f / 60.0f);
+    CHECK(manager.transforms.changedCount == (size_t)TRANSFORM_TEST_TREES * TRANSFORM_TEST_TREE_SIZE);
+    CheckWorld(&manager);
+
+    // Nothing changed, nothing is recomputed
+    UpdateEntityTransforms(&manager);
+    CHECK(manager.transforms.changedCount == 0);
+
+    // A turned root carries its whole tree and nothing else
+    SetEntityLocalTransform(&manager, g_roots[7], MakeTransform(5.0f, 5.0f, 90.0f, 1.0f));
+    UpdateEntityTransforms(&manager);
+    CHECK(manager.transforms.changedCount == TRANSFORM_TEST_TREE_SIZE);
+    CheckWorld(&manager);
+    EntityTransform arm = GetEntityWorldTransform(&manager, g_arms[7][0]);
+    CHECK(IsNear(arm.position.x, 5.0f) && IsNear(arm.position.y, 15.0f) && IsNear(arm.rotation, 90.0f));
+
+    // An arm and a hand inside it make one subtree; two arms make two
+    SetEntityLocalTransform(&manager, g_arms[3][1], MakeTransform(0.0f, 20.0f, 45.0f, 1.0f));
+    Entity* hand = GetEntityByID(&manager, g_arms[3][1]->id + 1);
+    SetEntityLocalTransform(&manager, hand, MakeTransform(3.0f, 0.0f, 0.0f, 1.0f));
+    SetEntityLocalTransform(&manager, g_arms[4][2], MakeTransform(1.0f, 1.0f, 0.0f, 1.0f));
+    UpdateEntityTransforms(&manager);
+    CHECK(manager.transforms.changedCount == 2 * (1 + TRANSFORM_TEST_FANOUT));
+    CheckWorld(&manager);
+
+    // Cycles are refused; a moved arm follows its new root
+    CHECK(!SetEntityParent(&manager, g_roots[3], hand));
+    CHECK(SetEntityParent(&manager, g_arms[0][0], g_roots[1]));
+    UpdateEntityTransforms(&manager);
+    CheckWorld(&manager);
+    EntityTransform moved = GetEntityWorldTransform(&manager, g_arms[0][0]);
+    EntityTransform root = GetEntityWorldTransform(&manager, g_roots[1]);
+    EntityTransform expected = CombineEntityTransforms(root, GetEntityLocalTransform(&manager, g_arms[0][0]));
+    CHECK(IsNear(moved.position.x, expected.position.x) && IsNear(moved.position.y, expected.position.y));
+
+    // Children of a removed root stay where they are, as roots
+    Vector2 before = g_arms[2][3]->position;
+    RemoveEntity(&manager, g_roots[2]->id);
+    UpdateEntityTransforms(&manager);
+    CheckWorld(&manager);
+    CHECK(IsNear(g_arms[2][3]->position.x, before.x) && IsNear(g_arms[2][3]->position.y, before.y));
+    CHECK(SetEntityParent(&manager, g_arms[2][3], NULL));
+
+    // Entities without a transform cannot be parented
+    Entity* loose = CreateEntity();
+    loose->id = id++;
+    AddEntity(&manager, loose);
+    CHECK(!SetEntityParent(&manager, loose, g_roots[0]));
+    CHECK(!SetEntityParent(&manager, g_arms[1][0], loose));
+
+    FreeEntityManager(&manager);
+    UnloadAssetManager();
+    return FinishTest("entity transforms");
+}
@@ -0,0 +1,139 @@
+// =============================================================
+// Sprite batch test
+// =============================================================
+// Queues sprites with interleaved textures, layers and blend modes and
+// checks that SortSpriteBatch orders them by (layer, texture, blend mode),
+// keeps equal keys in the order they were added, and builds one command
+// per texture run. Submitting the batch to the raylib stub must bind
+// textures exactly as often as the stats say.
+#include "sprite/sprite_batch.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <stdlib.h>
+
+#define BATCH_TEST_RANDOM_ITEMS 10000
+
+typedef struct {
+    int layer;
+    unsigned int textureId;
+    int blendMode;
+    uint32_t index;
+} BatchTestItem;
+
+static uint32_t g_testSeed = 2024u;
+
+static uint32_t TestRandom(void) {
+    g_testSeed = g_testSeed * 1664525u + 1013904223u;
+    return g_testSeed >> 8;
+}
+
+static Texture2D TestTexture(unsigned int id) {
+    return (Texture2D){ id, 32, 32, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+}
+
+static void AddTestItem(SpriteBatch* batch, const BatchTestItem* item) {
+    Rectangle source = { 0.0f, 0.0f, 32.0f, 32.0f };
+    Rectangle dest = { (float)item->index, 0.0f, 32.0f, 32.0f };
+    AddSpriteBatchItem(batch, TestTexture(item->textureId), source, dest, (Vector2){0}, 0.0f, WHITE,
+                       item->layer, item->blendMode);
+}
+
+// Reference order: by key, then by the order items were added
+static int CompareTestItems(const void* a, const void* b) {
+    const BatchTestItem* x = (const BatchTestItem*)a;
+    const BatchTestItem* y = (const BatchTestItem*)b;
+    if (x->layer != y->layer) return x->layer < y->layer ? -1 : 1;
+    if (x->textureId != y->textureId) return x->textureId < y->textureId ? -1 : 1;
+    if (x->blendMode != y->blendMode) return x->blendMode < y->blendMode ? -1 : 1;
+    return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+// Sort the batch and check it against the reference order, run count and
+// bind count, then submit it to the stub and check what it drew
+static void CheckSortedBatch(SpriteBatch* batch, BatchTestItem* items, size_t count) {
+    SortSpriteBatch(batch);
+    qsort(items, count, sizeof(BatchTestItem), CompareTestItems);
+
+    size_t misplaced = 0;
+    size_t runs = 0;
+    size_t binds = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (batch->order[i] != items[i].index) misplaced++;
+        bool textureChanged = i == 0 || items[i].textureId != items[i - 1].textureId;
+        if (textureChanged || items[i].blendMode != items[i - 1].blendMode) runs++;
+        if (textureChanged) binds++;
+    }
+    CHECK(misplaced == 0);
+    CHECK(batch->commandCount == runs);
+
+    SpriteBatchStats stats = GetSpriteBatchStats(batch);
+    CHECK(stats.sprites == count);
+    CHECK(stats.drawCalls == runs);
+    CHECK(stats.textureBinds == binds);
+
+    size_t covered = 0;
+    for (size_t c = 0; c < batch->commandCount; c++) {
+        const SpriteBatchCommand* command = &batch->commands[c];
+        CHECK(command->first == covered);
+        covered += command->count;
+    }
+    CHECK(covered == count);
+
+    ResetRaylibStubCounters();
+    SubmitSpriteBatch(batch);
+    CHECK(g_raylibStub.textureDraws == (int)count);
+    CHECK(g_raylibStub.textureBinds == (int)stats.textureBinds);
+}
+
+int main(void) {
+    SpriteBatch batch;
+    InitSpriteBatch(&batch);
+
+    // A hand-checked frame: two layers, two textures, one additive sprite.
+    // Sorted it is 1 4 | 6 | 3 | 2 7 | 0 5: five runs and four binds.
+    BatchTestItem frame[] = {
+        { 1, 2, BLEND_ALPHA, 0 },
+        { 0, 1, BLEND_ALPHA, 1 },
+        { 1, 1, BLEND_ALPHA, 2 },
+        { 0, 2, BLEND_ALPHA, 3 },
+        { 0, 1, BLEND_ALPHA, 4 },
+        { 1, 2, BLEND_ALPHA, 5 },
+        { 0, 1, BLEND_ADDITIVE, 6 },
+        { 1, 1, BLEND_ALPHA, 7 },
+    };
+    size_t frameCount = sizeof(frame) / sizeof(frame[0]);
+    BeginSpriteBatch(&batch);
+    for (size_t i = 0; i < frameCount; i++) {
+        AddTestItem(&batch, &frame[i]);
+    }
+    CheckSortedBatch(&batch, frame, frameCount);
+    const uint32_t expected[] = { 1, 4, 6, 3, 2, 7, 0, 5 };
+    for (size_t i = 0; i < frameCount; i++) {
+        CHECK(batch.order[i] == expected[i]);
+    }
+    CHECK(batch.commandCount == 5);
+    CHECK(GetSpriteBatchStats(&batch).textureBinds == 4);
+    CHECK(GetSpriteBatchStats(&batch).blendChanges == 2);
+    CHECK(g_raylibStub.blendModes == 1);
+
+    // A large frame with random layers (some negative), textures and blend modes
+    BatchTestItem* items = (BatchTestItem*)malloc(BATCH_TEST_RANDOM_ITEMS * sizeof(BatchTestItem));
+    CHECK(items != NULL);
+    if (items != NULL) {
+        BeginSpriteBatch(&batch);
+        for (uint32_t i = 0; i < BATCH_TEST_RANDOM_ITEMS; i++) {
+            items[i] = (BatchTestItem){
+                (int)(TestRandom() % 5) - 2,
+                1 + TestRandom() % 8,
+                TestRandom() % 4 == 0 ? BLEND_ADDITIVE : BLEND_ALPHA,
+                i
+            };
+            AddTestItem(&batch, &items[i]);
+        }
+        CheckSortedBatch(&batch, items, BATCH_TEST_RANDOM_ITEMS);
+        free(items);
+    }
+
+    FreeSpriteBatch(&batch);
+    return FinishTest("sprite batch");
+}
@@ -0,0 +1,125 @@
+// =============================================================
+// Sprite culling test
+// =============================================================
+// Checks the world rect a camera sees, then spreads moving, static,
+// hidden and rotated sprites over a field and checks that drawing a view
+// queues exactly the visible sprites a brute-force overlap test finds,
+// counting the rest as culled. Static sprites are found again once moved
+// and marked dirty.
+#include "sprite/sprite_manager.h"
+#include "2d/camera/game_camera.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <math.h>
+
+#define CULLING_TEST_COLUMNS 15
+#define CULLING_TEST_SPRITES (CULLING_TEST_COLUMNS * CULLING_TEST_COLUMNS)
+#define CULLING_TEST_SPACING 64.0f
+#define CULLING_TEST_SIZE 32.0f
+#define CULLING_TEST_SCREEN_WIDTH 320.0f
+#define CULLING_TEST_SCREEN_HEIGHT 180.0f
+#define CULLING_TEST_TEXTURE "res/image/tiles.png"
+#define CULLING_TEST_EPSILON 0.001f
+
+static bool IsNearRect(Rectangle rect, float x, float y, float width, float height) {
+    return fabsf(rect.x - x) <= CULLING_TEST_EPSILON && fabsf(rect.y - y) <= CULLING_TEST_EPSILON &&
+           fabsf(rect.width - width) <= CULLING_TEST_EPSILON && fabsf(rect.height - height) <= CULLING_TEST_EPSILON;
+}
+
+// Visible sprites overlapping the view, tested one by one
+static size_t CountInView(const SpriteManager* manager, Rectangle view) {
+    size_t count = 0;
+    for (int i = 0; i < manager->spriteCount; i++) {
+        const SpriteObject* sprite = manager->sprites[i];
+        if (!sprite->visible) continue;
+        Rectangle source = GetSpriteObjectSourceRec(sprite);
+        Rectangle dest = { sprite->position.x, sprite->position.y, source.width * sprite->scale.x, source.height * sprite->scale.y };
+        if (IsRectangleInView(GetSpriteDrawBounds(dest, GetSpriteObjectOrigin(sprite), sprite->rotation), view)) count++;
+    }
+    return count;
+}
+
+// Every visible moving sprite and every static one is drawn or culled
+static size_t CountCandidates(const SpriteManager* manager) {
+    size_t count = 0;
+    for (int i = 0; i < manager->spriteCount; i++) {
+        if (manager->sprites[i]->visible || manager->sprites[i]->isStatic) count++;
+    }
+    return count;
+}
+
+static void CheckView(SpriteManager* manager, Rectangle view) {
+    size_t expected = CountInView(manager, view);
+    ResetRaylibStubCounters();
+    DrawSpritesInView(manager, view);
+    SpriteBatchStats stats = GetSpriteBatchStats(&g_spriteBatch);
+    CHECK(stats.sprites == expected);
+    CHECK(stats.culled == CountCandidates(manager) - expected);
+    CHECK(g_raylibStub.textureDraws == (int)expected);
+}
+
+int main(void) {
+    InitAssetManager();
+
+    // A camera centred on the screen sees a zoomed-down rect around its target
+    Vector2 center = { CULLING_TEST_SCREEN_WIDTH * 0.5f, CULLING_TEST_SCREEN_HEIGHT * 0.5f };
+    GameCamera camera = InitGameCamera((Vector2){ 400.0f, 300.0f }, center, 0.0f, 1.0f);
+    Rectangle view = GetGameCameraViewRect(&camera, CULLING_TEST_SCREEN_WIDTH, CULLING_TEST_SCREEN_HEIGHT);
+    CHECK(IsNearRect(view, 240.0f, 210.0f, 320.0f, 180.0f));
+    SetGameCameraZoom(&camera, 2.0f);
+    view = GetGameCameraViewRect(&camera, CULLING_TEST_SCREEN_WIDTH, CULLING_TEST_SCREEN_HEIGHT);
+    CHECK(IsNearRect(view, 320.0f, 255.0f, 160.0f, 90.0f));
+    // A quarter turn swaps the extents about the target
+    GameCamera turned = InitGameCamera((Vector2){ 400.0f, 300.0f }, center, 90.0f, 1.0f);
+    Rectangle turnedView = GetGameCameraViewRect(&turned, CULLING_TEST_SCREEN_WIDTH, CULLING_TEST_SCREEN_HEIGHT);
+    CHECK(IsNearRect(turnedView, 310.0f, 140.0f, 180.0f, 320.0f));
+    CHECK(IsNearRect(GetGameCameraViewRect(NULL, 1.0f, 1.0f), 0.0f, 0.0f, 0.0f, 0.0f));
+
+    // A field of sprites: every third static, every seventh hidden and
+    // every fifth turned about its center
+    SpriteManager manager;
+    InitSpriteManager(&manager);
+    for (int i = 0; i < CULLING_TEST_SPRITES; i++) {
+        SpriteObject* sprite = CreateSpriteObject();
+        CHECK(sprite != NULL && LoadSpriteObjectTexture(sprite, CULLING_TEST_TEXTURE));
+        SetSpriteTextureRegion(sprite, (Rectangle){ 0.0f, 0.0f, CULLING_TEST_SIZE, CULLING_TEST_SIZE });
+        sprite->id = i;
+        sprite->visible = i % 7 != 0;
+        sprite->scale = (Vector2){ 1.0f, 1.0f };
+        sprite->position = (Vector2){ (float)(i % CULLING_TEST_COLUMNS) * CULLING_TEST_SPACING,
+                                      (float)(i / CULLING_TEST_COLUMNS) * CULLING_TEST_SPACING };
+        if (i % 5 == 0) {
+            sprite->origin = (Vector2){ CULLING_TEST_SIZE * 0.5f, CULLING_TEST_SIZE * 0.5f };
+            sprite->rotation = 45.0f;
+        }
+        AddSprite(&manager, sprite);
+        SetSpriteStatic(&manager, sprite, i % 3 == 0);
+    }
+    CHECK(manager.spriteCount == CULLING_TEST_SPRITES);
+
+    // Camera views, a view on cell edges, one past the field and one over all of it
+    CheckView(&manager, view);
+    CheckView(&manager, turnedView);
+    CheckView(&manager, (Rectangle){ 256.0f, 256.0f, 256.0f, 256.0f });
+    CheckView(&manager, (Rectangle){ 5000.0f, 5000.0f, 100.0f, 100.0f });
+    CheckView(&manager, (Rectangle){ -100.0f, -100.0f, 2000.0f, 2000.0f });
+
+    // A static sprite moved into the view is found once marked dirty
+    Rectangle far = { 5000.0f, 5000.0f, 100.0f, 100.0f };
+    SpriteObject* moved = manager.sprites[3];
+    CHECK(moved->isStatic && moved->visible);
+    moved->position = (Vector2){ 5020.0f, 5020.0f };
+    MarkStaticSpritesDirty(&manager);
+    CheckView(&manager, far);
+    CHECK(GetSpriteBatchStats(&g_spriteBatch).sprites == 1);
+
+    // Hidden, it is counted as culled instead
+    SetSpriteVisible(moved, false);
+    CheckView(&manager, far);
+    CHECK(GetSpriteBatchStats(&g_spriteBatch).sprites == 0);
+
+    UnloadAllSprites(&manager);
+    UnloadAssetManager();
+    return FinishTest("sprite culling");
+}
@@ -0,0 +1,123 @@
+// =============================================================
+// Spritesheet test
+// =============================================================
+// Loads a sheet from a descriptor mixing grid and trimmed frames and
+// checks the frame table, the pivots sprites draw with and that bad
+// descriptors are refused without holding on to their texture. Names
+// that would be cut off are refused too, including the sheet names
+// LoadAnimationClip derives from texture paths.
+#include "sprite/spritesheet.h"
+#include "sprite/animation_clip.h"
+#include "util/asset_manager.h"
+#include "../tools/raylib_stub.h"
+#include "test_common.h"
+#include <string.h>
+
+#define SHEET_TEST_DESCRIPTOR "bin/test_sheet.txt"
+#define SHEET_TEST_BAD_DESCRIPTOR "bin/test_sheet_bad.txt"
+#define SHEET_TEST_TEXTURE "res/image/hero.png"
+#define SHEET_TEST_BAD_TEXTURE "res/image/bad.png"
+
+static bool WriteTestText(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return false;
+    fputs(text, file);
+    fclose(file);
+    return true;
+}
+
+static bool IsFrame(const SpriteFrame* frame, Rectangle source, Vector2 origin) {
+    return frame->source.x == source.x && frame->source.y == source.y && frame->source.width == source.width &&
+           frame->source.height == source.height && frame->origin.x == origin.x && frame->origin.y == origin.y;
+}
+
+// A bad descriptor is refused and its texture let go
+static void CheckRejected(const char* text) {
+    CHECK(WriteTestText(SHEET_TEST_BAD_DESCRIPTOR, text));
+    int sheets = g_spritesheets.count;
+    CHECK(LoadSpritesheet("bad", SHEET_TEST_BAD_TEXTURE, SHEET_TEST_BAD_DESCRIPTOR) == SPRITESHEET_NONE);
+    CHECK(g_spritesheets.count == sheets);
+    CHECK(g_raylibStub.textureLoads - g_raylibStub.textureUnloads == 1);
+}
+
+int main(void) {
+    InitAssetManager();
+    ResetRaylibStubCounters();
+    CHECK(WriteTestText(SHEET_TEST_DESCRIPTOR,
+        "# Two grid frames pivoted at the feet, then a trimmed frame and a plain one\n"
+        "grid 64 64 2 32 60\n"
+        "\n"
+        "frame 128 0 20 30 6 4 16 32  # trimmed 6 px from the left, 4 from the top\n"
+        "frame 160 0 10 10\n"));
+    int sheetId = LoadSpritesheet("hero", SHEET_TEST_TEXTURE, SHEET_TEST_DESCRIPTOR);
+    CHECK(sheetId != SPRITESHEET_NONE);
+    CHECK(FindSpritesheet("hero") == sheetId);
+    const Spritesheet* sheet = GetSpritesheet(sheetId);
+    CHECK(sheet != NULL && sheet->frameCount == 4);
+    if (sheet == NULL || sheet->frameCount != 4) return FinishTest("spritesheet");
+    CHECK(IsFrame(&sheet->frames[0], (Rectangle){ 0, 0, 64, 64 }, (Vector2){ 32, 60 }));
+    CHECK(IsFrame(&sheet->frames[1], (Rectangle){ 64, 0, 64, 64 }, (Vector2){ 32, 60 }));
+    // The pivot moves with the trim, so the frame still lands where the untrimmed one would
+    CHECK(IsFrame(&sheet->frames[2], (Rectangle){ 128, 0, 20, 30 }, (Vector2){ 10, 28 }));
+    CHECK(IsFrame(&sheet->frames[3], (Rectangle){ 160, 0, 10, 10 }, (Vector2){ 0, 0 }));
+    CHECK(g_raylibStub.textureLoads == 1);
+
+    // Sprites draw the frame's rect around its pivot, scaled with them
+    SpriteObject* sprite = CreateSpriteObject();
+    CHECK(sprite != NULL && SetSpriteSpritesheet(sprite, sheetId));
+    sprite->visible = true;
+    sprite->scale = (Vector2){ 2.0f, 2.0f };
+    SetSpriteAnimationFrame(sprite, 2);
+    Rectangle source = GetSpriteObjectSourceRec(sprite);
+    Vector2 origin = GetSpriteObjectOrigin(sprite);
+    CHECK(source.x == 128.0f && source.width == 20.0f);
+    CHECK(origin.x == 20.0f && origin.y == 56.0f);
+    DrawSpriteObject(sprite);
+    CHECK(g_raylibStub.textureDraws == 1);
+    CHECK(GetAssetTextureRefCount(sheet->textureHandle) == 2);
+    UnloadSpriteObject(sprite);
+
+    // A grid sheet with no count takes every whole cell
+    int grid = CreateGridSpritesheet("grid", SHEET_TEST_TEXTURE, 32, 32, 0, (Vector2){ 16, 16 });
+    const Spritesheet* gridSheet = GetSpritesheet(grid);
+    CHECK(gridSheet != NULL && gridSheet->frameCount == (STUB_TEXTURE_SIZE / 32) * (STUB_TEXTURE_SIZE / 32));
+    CHECK(g_raylibStub.textureLoads == 1);
+
+    // Unknown directives, short frames, frames off the texture and grids
+    // with no whole cell are refused
+    CheckRejected("tile 0 0 8 8\n");
+    CheckRejected("frame 0 0 8\n");
+    CheckRejected("frame 250 0 10 10\n");
+    CheckRejected("grid 512 512\n");
+    CHECK(LoadSpritesheet("bad", SHEET_TEST_BAD_TEXTURE, "bin/missing.txt") == SPRITESHEET_NONE);
+
+    // Names that would be cut off are refused before any texture is loaded
+    char longName[MAX_SPRITESHEET_NAME_LENGTH + 1];
+    memset(longName, 'n', MAX_SPRITESHEET_NAME_LENGTH);
+    longName[MAX_SPRITESHEET_NAME_LENGTH] = '\0';
+    int loads = g_raylibStub.textureLoads;
+    int sheets = g_spritesheets.count;
+    SpriteFrameDesc frame = { { 0, 0, 8, 8 }, { 0, 0 }, { 0, 0 } };
+    CHECK(CreateSpritesheet(longName, SHEET_TEST_BAD_TEXTURE, &frame, 1) == SPRITESHEET_NONE);
+    CHECK(CreateGridSpritesheet(longName, SHEET_TEST_BAD_TEXTURE, 8, 8, 0, (Vector2){ 0, 0 }) == SPRITESHEET_NONE);
+    CHECK(LoadSpritesheet(longName, SHEET_TEST_BAD_TEXTURE, SHEET_TEST_DESCRIPTOR) == SPRITESHEET_NONE);
+    CHECK(FindSpritesheet(longName) == SPRITESHEET_NONE);
+
+    // Clips name their sheet after the texture path: a 69-character path
+    // used by three clips must not leave three cut-off sheets behind
+    const char* longPath = "res/image/characters/the_hero_of_the_story/walk_cycle_facing_left.png";
+    CHECK(strlen(longPath) == 69);
+    CHECK(LoadAnimationClip("walk_1", longPath, 32, 32, 4, 0.1f, ANIMATION_SEQUENCE_LOOP) == ANIMATION_CLIP_NONE);
+    CHECK(LoadAnimationClip("walk_2", longPath, 32, 32, 4, 0.1f, ANIMATION_SEQUENCE_LOOP) == ANIMATION_CLIP_NONE);
+    CHECK(LoadAnimationClip("walk_3", longPath, 32, 32, 4, 0.1f, ANIMATION_SEQUENCE_LOOP) == ANIMATION_CLIP_NONE);
+    CHECK(g_spritesheets.count == sheets);
+    CHECK(g_raylibStub.textureLoads == loads);
+
+    UnloadAnimationClips();
+    UnloadSpritesheets();
+    CHECK(g_raylibStub.textureLoads == g_raylibStub.textureUnloads);
+    UnloadAssetManager();
+    remove(SHEET_TEST_DESCRIPTOR);
+    remove(SHEET_TEST_BAD_DESCRIPTOR);
+    return FinishTest("spritesheet");
+}
@@ -0,0 +1,380 @@
+// =============================================================
+// Animation baker
+// =============================================================
+// Offline tool behind `make anim`. Compiles a text description of
+// spritesheets, clips and event markers into the blob read in place by
+// src/sprite/baked_animation.c.
+//
+// Usage: anim_baker <description> <output file>
+//
+// Description format, one record per line, '#' starts a comment:
+//   sheet <name> <texture> <frame width> <frame height> [frame count [pivot x pivot y]]
+//   clip <name> <sheet> <first frame> <frame count> <frame time> [loop|once|pingpong]
+//   event <frame> <event id>
+// A sheet without a frame count fills its texture. Events belong to the
+// clip above them; frames are counted from the start of the clip.
+
+#include "sprite/baked_animation.h"
+#include "sprite/spritesheet.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Baker constants
+#define MAX_BAKER_LINE_LENGTH 1024
+#define MAX_BAKER_TOKENS 8
+
+typedef struct {
+    char name[MAX_SPRITESHEET_NAME_LENGTH];
+    char texture[MAX_BAKER_LINE_LENGTH];
+    BakedSpritesheet record;
+} BakerSheet;
+
+typedef struct {
+    char name[MAX_ANIMATION_NAME_LENGTH];
+    int firstFrame;
+    BakedAnimationClip record;
+} BakerClip;
+
+// An event with the clip it belongs to and its position in the file, so
+// sorting keeps markers on the same frame in the order they were written
+typedef struct {
+    uint32_t clip;
+    uint32_t order;
+    BakedAnimationEvent record;
+} BakerEvent;
+
+static BakerSheet* g_sheets = NULL;
+static size_t g_sheetCount = 0;
+static size_t g_sheetCapacity = 0;
+static BakerClip* g_clips = NULL;
+static size_t g_clipCount = 0;
+static size_t g_clipCapacity = 0;
+static BakerEvent* g_events = NULL;
+static size_t g_eventCount = 0;
+static size_t g_eventCapacity = 0;
+
+static bool IsHostLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+// Make room for one more item in a growable array
+static bool GrowArray(void** items, size_t count, size_t* capacity, size_t itemSize) {
+    if (count < *capacity) return true;
+    size_t newCapacity = *capacity ? *capacity * 2 : 64;
+    void* grown = realloc(*items, newCapacity * itemSize);
+    if (grown == NULL) {
+        printf("Error: Out of memory while baking animations.\n");
+        return false;
+    }
+    *items = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static int FindSheet(const char* name) {
+    for (size_t i = 0; i < g_sheetCount; i++) {
+        if (strcmp(g_sheets[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+static bool HasClip(const char* name) {
+    for (size_t i = 0; i < g_clipCount; i++) {
+        if (strcmp(g_clips[i].name, name) == 0) return true;
+    }
+    return false;
+}
+
+// Parse a whole token as a number within [min, max]
+static bool ParseInt(const char* token, long min, long max, long* outValue) {
+    char* end;
+    long value = strtol(token, &end, 10);
+    if (end == token || *end != '\0' || value < min || value > max) return false;
+    *outValue = value;
+    return true;
+}
+
+static bool ParseFloat(const char* token, float* outValue) {
+    char* end;
+    float value = strtof(token, &end);
+    if (end == token || *end != '\0') return false;
+    *outValue = value;
+    return true;
+}
+
+static bool ParseSheet(char** tokens, int tokenCount, const char* where) {
+    if (tokenCount != 5 && tokenCount != 6 && tokenCount != 8) {
+        printf("Error: %s: expected sheet <name> <texture> <frame width> <frame height> [frame count [pivot x pivot y]]\n", where);
+        return false;
+    }
+    if (strlen(tokens[1]) >= MAX_SPRITESHEET_NAME_LENGTH || FindSheet(tokens[1]) >= 0) {
+        printf("Error: %s: sheet name %s is too long or already used.\n", where, tokens[1]);
+        return false;
+    }
+    long frameWidth, frameHeight;
+    long frameCount = 0;
+    float pivotX = 0.0f;
+    float pivotY = 0.0f;
+    if (!ParseInt(tokens[3], 1, UINT16_MAX, &frameWidth) || !ParseInt(tokens[4], 1, UINT16_MAX, &frameHeight) ||
+        (tokenCount > 5 && !ParseInt(tokens[5], 0, MAX_SPRITESHEET_FRAMES, &frameCount)) ||
+        (tokenCount > 6 && (!ParseFloat(tokens[6], &pivotX) || !ParseFloat(tokens[7], &pivotY)))) {
+        printf("Error: %s: invalid sheet size, frame count or pivot.\n", where);
+        return false;
+    }
+    if (!GrowArray((void**)&g_sheets, g_sheetCount, &g_sheetCapacity, sizeof(BakerSheet))) return false;
+    BakerSheet* sheet = &g_sheets[g_sheetCount++];
+    strcpy(sheet->name, tokens[1]);
+    strcpy(sheet->texture, tokens[2]);
+    sheet->record = (BakedSpritesheet){
+        0, 0, (uint16_t)frameWidth, (uint16_t)frameHeight, (uint32_t)frameCount, pivotX, pivotY
+    };
+    return true;
+}
+
+static bool ParseClip(char** tokens, int tokenCount, const char* where) {
+    if (tokenCount != 6 && tokenCount != 7) {
+        printf("Error: %s: expected clip <name> <sheet> <first frame> <frame count> <frame time> [loop|once|pingpong]\n", where);
+        return false;
+    }
+    if (strlen(tokens[1]) >= MAX_ANIMATION_NAME_LENGTH || HasClip(tokens[1])) {
+        printf("Error: %s: clip name %s is too long or already used.\n", where, tokens[1]);
+        return false;
+    }
+    int sheet = FindSheet(tokens[2]);
+    if (sheet < 0) {
+        printf("Error: %s: unknown sheet %s.\n", where, tokens[2]);
+        return false;
+    }
+    long firstFrame, frameCount;
+    float frameTime;
+    if (!ParseInt(tokens[3], 0, MAX_SPRITESHEET_FRAMES - 1, &firstFrame) ||
+        !ParseInt(tokens[4], 1, MAX_SPRITESHEET_FRAMES, &frameCount) ||
+        !ParseFloat(tokens[5], &frameTime) || !(frameTime > 0.0f)) {
+        printf("Error: %s: invalid first frame, frame count or frame time.\n", where);
+        return false;
+    }
+    uint32_t sheetFrames = g_sheets[sheet].record.frameCount;
+    if (sheetFrames > 0 && (uint32_t)(firstFrame + frameCount) > sheetFrames) {
+        printf("Error: %s: clip %s lies outside sheet %s.\n", where, tokens[1], tokens[2]);
+        return false;
+    }
+    AnimationSequenceType type = ANIMATION_SEQUENCE_LOOP;
+    if (tokenCount == 7) {
+        if (strcmp(tokens[6], "once") == 0) {
+            type = ANIMATION_SEQUENCE_ONCE;
+        } else if (strcmp(tokens[6], "pingpong") == 0) {
+            type = ANIMATION_SEQUENCE_PINGPONG;
+        } else if (strcmp(tokens[6], "loop") != 0) {
+            printf("Error: %s: unknown clip type %s.\n", where, tokens[6]);
+            return false;
+        }
+    }
+    if (!GrowArray((void**)&g_clips, g_clipCount, &g_clipCapacity, sizeof(BakerClip))) return false;
+    BakerClip* clip = &g_clips[g_clipCount++];
+    strcpy(clip->name, tokens[1]);
+    clip->firstFrame = (int)firstFrame;
+    clip->record = (BakedAnimationClip){ 0 };
+    clip->record.sheet = (uint16_t)sheet;
+    clip->record.type = (uint8_t)type;
+    clip->record.frameCount = (uint32_t)frameCount;
+    clip->record.frameTime = frameTime;
+    return true;
+}
+
+static bool ParseEvent(char** tokens, int tokenCount, const char* where) {
+    if (tokenCount != 3) {
+        printf("Error: %s: expected event <frame> <event id>\n", where);
+        return false;
+    }
+    if (g_clipCount == 0) {
+        printf("Error: %s: event before any clip.\n", where);
+        return false;
+    }
+    const BakerClip* clip = &g_clips[g_clipCount - 1];
+    long frame, eventId;
+    if (!ParseInt(tokens[1], 0, (long)clip->record.frameCount - 1, &frame) ||
+        !ParseInt(tokens[2], INT32_MIN, INT32_MAX, &eventId)) {
+        printf("Error: %s: event frame must be within clip %s and the ID a 32-bit integer.\n", where, clip->name);
+        return false;
+    }
+    if (!GrowArray((void**)&g_events, g_eventCount, &g_eventCapacity, sizeof(BakerEvent))) return false;
+    g_events[g_eventCount] = (BakerEvent){ (uint32_t)(g_clipCount - 1), (uint32_t)g_eventCount, { (int)frame, (int)eventId } };
+    g_eventCount++;
+    return true;
+}
+
+static bool ParseDescription(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Error: Could not open %s\n", path);
+        return false;
+    }
+    char line[MAX_BAKER_LINE_LENGTH];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char where[MAX_BAKER_LINE_LENGTH + 32];
+        snprintf(where, sizeof(where), "%s:%d", path, lineNumber);
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            printf("Error: %s: line too long.\n", where);
+            ok = false;
+            break;
+        }
+        char* comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+
+        // Split on whitespace; texture paths may not contain spaces
+        char* tokens[MAX_BAKER_TOKENS + 1];
+        int tokenCount = 0;
+        for (char* token = strtok(line, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n")) {
+            if (tokenCount > MAX_BAKER_TOKENS) break;
+            tokens[tokenCount++] = token;
+        }
+        if (tokenCount == 0) continue;
+        if (strcmp(tokens[0], "sheet") == 0) {
+            ok = ParseSheet(tokens, tokenCount, where);
+        } else if (strcmp(tokens[0], "clip") == 0) {
+            ok = ParseClip(tokens, tokenCount, where);
+        } else if (strcmp(tokens[0], "event") == 0) {
+            ok = ParseEvent(tokens, tokenCount, where);
+        } else {
+            printf("Error: %s: unknown record %s.\n", where, tokens[0]);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// Group events by clip, then by frame, keeping file order within a frame
+static int CompareEvents(const void* a, const void* b) {
+    const BakerEvent* left = (const BakerEvent*)a;
+    const BakerEvent* right = (const BakerEvent*)b;
+    if (left->clip != right->clip) return left->clip < right->clip ? -1 : 1;
+    if (left->record.frame != right->record.frame) return left->record.frame < right->record.frame ? -1 : 1;
+    return left->order < right->order ? -1 : (left->order > right->order);
+}
+
+static uint32_t AppendString(char* strings, size_t* offset, const char* value) {
+    size_t length = strlen(value) + 1;
+    memcpy(strings + *offset, value, length);
+    uint32_t start = (uint32_t)*offset;
+    *offset += length;
+    return start;
+}
+
+// Write the blob: header, sheets, clips, frames, events, strings
+static bool WriteBlob(const char* outputPath) {
+    size_t frameCount = 0;
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < g_sheetCount; i++) stringsSize += strlen(g_sheets[i].name) + strlen(g_sheets[i].texture) + 2;
+    for (size_t i = 0; i < g_clipCount; i++) {
+        stringsSize += strlen(g_clips[i].name) + 1;
+        frameCount += g_clips[i].record.frameCount;
+    }
+    if (stringsSize == 0) stringsSize = 1;
+
+    BakedAnimationHeader header = {0};
+    memcpy(header.magic, BAKED_ANIMATION_MAGIC, 4);
+    header.version = BAKED_ANIMATION_VERSION;
+    header.headerSize = sizeof(BakedAnimationHeader);
+    header.sheetCount = (uint32_t)g_sheetCount;
+    header.clipCount = (uint32_t)g_clipCount;
+    header.frameCount = (uint32_t)frameCount;
+    header.eventCount = (uint32_t)g_eventCount;
+    header.sheetsOffset = sizeof(BakedAnimationHeader);
+    header.clipsOffset = header.sheetsOffset + header.sheetCount * sizeof(BakedSpritesheet);
+    header.framesOffset = header.clipsOffset + header.clipCount * sizeof(BakedAnimationClip);
+    header.eventsOffset = header.framesOffset + header.frameCount * sizeof(BakedAnimationFrame);
+    header.stringsOffset = header.eventsOffset + header.eventCount * sizeof(BakedAnimationEvent);
+    header.stringsSize = (uint32_t)stringsSize;
+
+    BakedSpritesheet* sheets = (BakedSpritesheet*)calloc(g_sheetCount + 1, sizeof(BakedSpritesheet));
+    BakedAnimationClip* clips = (BakedAnimationClip*)calloc(g_clipCount + 1, sizeof(BakedAnimationClip));
+    BakedAnimationFrame* frames = (BakedAnimationFrame*)calloc(frameCount + 1, sizeof(BakedAnimationFrame));
+    BakedAnimationEvent* events = (BakedAnimationEvent*)calloc(g_eventCount + 1, sizeof(BakedAnimationEvent));
+    char* strings = (char*)calloc(stringsSize, 1);
+    if (sheets == NULL || clips == NULL || frames == NULL || events == NULL || strings == NULL) {
+        printf("Error: Out of memory while writing %s\n", outputPath);
+        free(sheets);
+        free(clips);
+        free(frames);
+        free(events);
+        free(strings);
+        return false;
+    }
+
+    size_t stringOffset = 0;
+    for (size_t i = 0; i < g_sheetCount; i++) {
+        sheets[i] = g_sheets[i].record;
+        sheets[i].name = AppendString(strings, &stringOffset, g_sheets[i].name);
+        sheets[i].texture = AppendString(strings, &stringOffset, g_sheets[i].texture);
+    }
+
+    // Frames are precomputed, so clips point straight at their run
+    qsort(g_events, g_eventCount, sizeof(BakerEvent), CompareEvents);
+    size_t frameOffset = 0;
+    size_t eventOffset = 0;
+    for (size_t i = 0; i < g_clipCount; i++) {
+        BakedAnimationClip* clip = &clips[i];
+        *clip = g_clips[i].record;
+        clip->name = AppendString(strings, &stringOffset, g_clips[i].name);
+        clip->frames = (uint32_t)frameOffset;
+        for (uint32_t f = 0; f < clip->frameCount; f++) {
+            frames[frameOffset++] = (BakedAnimationFrame){ g_clips[i].firstFrame + (int)f, clip->frameTime };
+        }
+        clip->events = (uint32_t)eventOffset;
+        while (eventOffset < g_eventCount && g_events[eventOffset].clip == i) {
+            events[eventOffset] = g_events[eventOffset].record;
+            eventOffset++;
+        }
+        clip->eventCount = (uint32_t)eventOffset - clip->events;
+    }
+
+    FILE* file = fopen(outputPath, "wb");
+    bool ok = file != NULL &&
+              fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(sheets, sizeof(BakedSpritesheet), g_sheetCount, file) == g_sheetCount &&
+              fwrite(clips, sizeof(BakedAnimationClip), g_clipCount, file) == g_clipCount &&
+              fwrite(frames, sizeof(BakedAnimationFrame), frameCount, file) == frameCount &&
+              fwrite(events, sizeof(BakedAnimationEvent), g_eventCount, file) == g_eventCount &&
+              fwrite(strings, 1, stringsSize, file) == stringsSize;
+    if (file != NULL && fclose(file) != 0) ok = false;
+    if (!ok) printf("Error: Could not write %s\n", outputPath);
+
+    free(sheets);
+    free(clips);
+    free(frames);
+    free(events);
+    free(strings);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Usage: %s <description> <output file>\n", argv[0]);
+        return 1;
+    }
+    if (!IsHostLittleEndian()) {
+        printf("Error: Baked animations can only be written on little-endian hosts.\n");
+        return 1;
+    }
+
+    bool ok = ParseDescription(argv[1]);
+    if (ok && g_sheetCount > UINT16_MAX) {
+        printf("Error: Too many sheets.\n");
+        ok = false;
+    }
+    if (ok) ok = WriteBlob(argv[2]);
+    if (ok) {
+        printf("Baked %zu clips on %zu sheets with %zu events into %s\n", g_clipCount, g_sheetCount, g_eventCount, argv[2]);
+    }
+
+    free(g_sheets);
+    free(g_clips);
+    free(g_events);
+    return ok ? 0 : 1;
+}
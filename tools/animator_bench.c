@@ -0,0 +1,297 @@
+// =============================================================
+// Animator benchmark
+// =============================================================
+// Headless benchmark behind `make bench`. Times 100k animators on the
+// AnimatorStore kernel against the Animator* loop in UpdateAnimators,
+// and checks that both paths, and the SSE2 and scalar kernels, show the
+// same frames and emit the same events.
+//
+// Usage: animator_bench
+
+#include "sprite/animation_clip.h"
+#include "util/asset_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ANIMATORS 100000
+#define BENCH_FRAMES 100
+#define BENCH_TRIALS 5
+#define BENCH_CHECK_FRAMES 600
+#define BENCH_MANAGERS ((BENCH_ANIMATORS + MAX_ANIMATIONS - 1) / MAX_ANIMATIONS)
+
+static uint32_t g_benchSeed = 12345u;
+
+// Small deterministic generator, so runs are comparable
+static uint32_t BenchRandom(void) {
+    g_benchSeed = g_benchSeed * 1664525u + 1013904223u;
+    return g_benchSeed >> 8;
+}
+
+static double BenchSeconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// One clip of each type. Frame times and speeds are powers of two, so
+// with a 1/64 s step both paths do exact arithmetic and must agree.
+static int g_benchClips[3];
+static const float g_benchSpeeds[] = { 1.0f, 0.5f, 2.0f };
+
+static bool LoadBenchClips(void) {
+    g_benchClips[0] = LoadAnimationClip("bench_loop", "res/image/bench.png", 32, 32, 8, 0.125f, ANIMATION_SEQUENCE_LOOP);
+    g_benchClips[1] = LoadAnimationClip("bench_once", "res/image/bench.png", 32, 32, 6, 0.25f, ANIMATION_SEQUENCE_ONCE);
+    g_benchClips[2] = LoadAnimationClip("bench_pingpong", "res/image/bench.png", 32, 32, 5, 0.0625f, ANIMATION_SEQUENCE_PINGPONG);
+    return g_benchClips[0] != ANIMATION_CLIP_NONE && g_benchClips[1] != ANIMATION_CLIP_NONE &&
+           g_benchClips[2] != ANIMATION_CLIP_NONE &&
+           AddAnimationClipEvent(g_benchClips[0], 2, 1) && AddAnimationClipEvent(g_benchClips[0], 5, 2) &&
+           AddAnimationClipEvent(g_benchClips[1], 5, 3) &&
+           AddAnimationClipEvent(g_benchClips[2], 0, 4) && AddAnimationClipEvent(g_benchClips[2], 4, 5);
+}
+
+// Animator i plays the same clip at the same speed on both paths
+static int BenchClip(size_t i) { return g_benchClips[i % 3]; }
+static float BenchSpeed(size_t i) { return g_benchSpeeds[(i / 3) % 3]; }
+
+// The Animator* loop: UpdateAnimators holds MAX_ANIMATIONS animators, so
+// the list path is spread over as many managers as it takes
+static AnimationManager* CreateListAnimators(size_t count) {
+    AnimationManager* managers = (AnimationManager*)malloc(BENCH_MANAGERS * sizeof(AnimationManager));
+    if (managers == NULL) return NULL;
+    for (size_t m = 0; m < BENCH_MANAGERS; m++) {
+        InitAnimationManager(&managers[m]);
+    }
+    for (size_t i = 0; i < count; i++) {
+        Animator* animator = (Animator*)malloc(sizeof(Animator));
+        InitAnimator(animator, BenchClip(i));
+        SetAnimationSpeed(animator, BenchSpeed(i));
+        AddAnimator(&managers[i / MAX_ANIMATIONS], animator);
+    }
+    return managers;
+}
+
+static void FreeListAnimators(AnimationManager* managers) {
+    for (size_t m = 0; m < BENCH_MANAGERS; m++) {
+        UnloadAllAnimators(&managers[m]);
+    }
+    free(managers);
+}
+
+static bool CreateStoreAnimators(AnimatorStore* store, size_t count) {
+    InitAnimatorStore(store);
+    if (!ReserveAnimatorRows(store, count)) return false;
+    for (size_t i = 0; i < count; i++) {
+        int row = AddAnimatorRow(store, BenchClip(i));
+        if (row < 0) return false;
+        SetAnimatorRowSpeed(store, (size_t)row, BenchSpeed(i));
+    }
+    return true;
+}
+
+// Update the list path; returns the events it emitted
+static size_t UpdateListAnimators(AnimationManager* managers, float deltaTime) {
+    size_t events = 0;
+    for (size_t m = 0; m < BENCH_MANAGERS; m++) {
+        UpdateAnimators(&managers[m], deltaTime);
+        events += managers[m].events.count;
+    }
+    return events;
+}
+
+static size_t UpdateStoreAnimators(AnimatorStore* store, AnimationEventBuffer* events, float deltaTime) {
+    UpdateAnimatorStore(store, deltaTime);
+    ClearAnimationEvents(events);
+    EmitAnimatorStoreEvents(store, events);
+    return events->count;
+}
+
+static bool IsSameEvent(const AnimationEvent* a, const AnimationEvent* b, int animator) {
+    return a->eventId == b->eventId && a->clip == b->clip && a->frame == b->frame && animator == b->row;
+}
+
+// Step both paths in exact time and compare every frame and event
+static bool CheckListAgainstStore(size_t count) {
+    AnimationManager* managers = CreateListAnimators(count);
+    AnimatorStore store;
+    AnimationEventBuffer events = {0};
+    if (managers == NULL || !CreateStoreAnimators(&store, count)) return false;
+
+    size_t frameMismatches = 0;
+    size_t eventMismatches = 0;
+    size_t eventCount = 0;
+    for (int frame = 0; frame < BENCH_CHECK_FRAMES; frame++) {
+        UpdateListAnimators(managers, 1.0f / 64.0f);
+        eventCount += UpdateStoreAnimators(&store, &events, 1.0f / 64.0f);
+        size_t next = 0;
+        for (size_t m = 0; m < BENCH_MANAGERS; m++) {
+            const AnimationEventBuffer* listEvents = &managers[m].events;
+            for (size_t e = 0; e < listEvents->count; e++, next++) {
+                const AnimationEvent* event = &listEvents->items[e];
+                int animator = (int)(m * MAX_ANIMATIONS) + event->animator;
+                if (next >= events.count || !IsSameEvent(event, &events.items[next], animator)) eventMismatches++;
+            }
+        }
+        if (next != events.count) eventMismatches++;
+        for (size_t i = 0; i < count; i++) {
+            const Animator* animator = managers[i / MAX_ANIMATIONS].animators[i % MAX_ANIMATIONS];
+            frameMismatches += animator->currentFrameIndex != store.frames[i];
+        }
+    }
+    printf("  %7zu animators, %d frames: %zu events, %zu frame and %zu event mismatches\n", count,
+           BENCH_CHECK_FRAMES, eventCount, frameMismatches, eventMismatches);
+
+    FreeListAnimators(managers);
+    FreeAnimatorStore(&store);
+    FreeAnimationEvents(&events);
+    return frameMismatches == 0 && eventMismatches == 0;
+}
+
+static bool IsSameStoreState(const AnimatorStore* a, const AnimatorStore* b) {
+    size_t rows = a->count;
+    size_t words = ANIMATOR_CHANGED_WORDS(rows);
+    return memcmp(a->timers, b->timers, rows * sizeof(float)) == 0 &&
+           memcmp(a->phases, b->phases, rows * sizeof(float)) == 0 &&
+           memcmp(a->advanced, b->advanced, rows * sizeof(float)) == 0 &&
+           memcmp(a->frames, b->frames, rows * sizeof(int32_t)) == 0 &&
+           memcmp(a->changed, b->changed, words * sizeof(uint64_t)) == 0 &&
+           memcmp(a->entered, b->entered, words * sizeof(uint64_t)) == 0 &&
+           memcmp(a->pending, b->pending, words * sizeof(uint64_t)) == 0;
+}
+
+static bool IsSameEventBuffer(const AnimationEventBuffer* a, const AnimationEventBuffer* b) {
+    return a->count == b->count && (a->count == 0 || memcmp(a->items, b->items, a->count * sizeof(AnimationEvent)) == 0);
+}
+
+// Step the SSE2 and scalar kernels with uneven steps, LOD and restarts,
+// and require bit-identical state and events after every update
+static bool CheckKernels(size_t count) {
+    AnimatorStore vector;
+    AnimatorStore scalar;
+    AnimationEventBuffer vectorEvents = {0};
+    AnimationEventBuffer scalarEvents = {0};
+    if (!CreateStoreAnimators(&vector, count) || !CreateStoreAnimators(&scalar, count)) return false;
+    scalar.scalarKernel = true;
+    for (size_t i = 0; i < count; i++) {
+        AnimationLod lod = (AnimationLod)(BenchRandom() % 3);
+        SetAnimatorRowLod(&vector, i, lod);
+        SetAnimatorRowLod(&scalar, i, lod);
+    }
+
+    size_t mismatches = 0;
+    size_t eventCount = 0;
+    for (int frame = 0; frame < BENCH_CHECK_FRAMES; frame++) {
+        // Mostly frame-sized steps, with the odd hitch
+        float deltaTime = frame % 97 == 0 ? 0.75f : (50.0f + (float)(BenchRandom() % 40)) / 3600.0f;
+        size_t restart = BenchRandom() % count;
+        PlayAnimatorRow(&vector, restart, BenchClip(restart));
+        PlayAnimatorRow(&scalar, restart, BenchClip(restart));
+        eventCount += UpdateStoreAnimators(&vector, &vectorEvents, deltaTime);
+        UpdateStoreAnimators(&scalar, &scalarEvents, deltaTime);
+        mismatches += !IsSameStoreState(&vector, &scalar) || !IsSameEventBuffer(&vectorEvents, &scalarEvents);
+    }
+    printf("  %7zu animators, %d frames: %zu events, %zu frames differ\n", count, BENCH_CHECK_FRAMES, eventCount, mismatches);
+
+    FreeAnimatorStore(&vector);
+    FreeAnimatorStore(&scalar);
+    FreeAnimationEvents(&vectorEvents);
+    FreeAnimationEvents(&scalarEvents);
+    return mismatches == 0;
+}
+
+// Run BENCH_FRAMES store updates at 60 fps, timing the kernel and the
+// event pass separately
+static void TimeStoreAnimators(AnimatorStore* store, AnimationEventBuffer* events, double* kernelTime, double* eventTime) {
+    *kernelTime = 0.0;
+    *eventTime = 0.0;
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        double start = BenchSeconds();
+        UpdateAnimatorStore(store, 1.0f / 60.0f);
+        double updated = BenchSeconds();
+        ClearAnimationEvents(events);
+        EmitAnimatorStoreEvents(store, events);
+        *kernelTime += updated - start;
+        *eventTime += BenchSeconds() - updated;
+    }
+}
+
+// Time the list path, the SSE2 kernel and the scalar kernel at 60 fps
+static bool BenchUpdatePaths(size_t count) {
+    AnimationManager* managers = CreateListAnimators(count);
+    AnimatorStore vector;
+    AnimatorStore scalar;
+    AnimationEventBuffer events = {0};
+    if (managers == NULL || !CreateStoreAnimators(&vector, count) || !CreateStoreAnimators(&scalar, count)) return false;
+    scalar.scalarKernel = true;
+
+    double listTime = 0.0;
+    double vectorTime = 0.0;
+    double vectorEventTime = 0.0;
+    double scalarTime = 0.0;
+    double scalarEventTime = 0.0;
+    for (int trial = 0; trial < BENCH_TRIALS; trial++) {
+        double start = BenchSeconds();
+        for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+            UpdateListAnimators(managers, 1.0f / 60.0f);
+        }
+        double elapsed = BenchSeconds() - start;
+        if (trial == 0 || elapsed < listTime) listTime = elapsed;
+
+        double kernel;
+        double emit;
+        TimeStoreAnimators(&vector, &events, &kernel, &emit);
+        if (trial == 0 || kernel + emit < vectorTime + vectorEventTime) {
+            vectorTime = kernel;
+            vectorEventTime = emit;
+        }
+        TimeStoreAnimators(&scalar, &events, &kernel, &emit);
+        if (trial == 0 || kernel + emit < scalarTime + scalarEventTime) {
+            scalarTime = kernel;
+            scalarEventTime = emit;
+        }
+    }
+    double storeTime = vectorTime + vectorEventTime;
+    printf("  %7zu animators: pointer loop %6.2f ms, store %6.2f ms (%.1fx) per frame\n", count,
+           listTime * 1e3 / BENCH_FRAMES, storeTime * 1e3 / BENCH_FRAMES, listTime / storeTime);
+    printf("                     SSE2 kernel %6.2f ms + events %6.2f ms, scalar kernel %6.2f ms + events %6.2f ms\n",
+           vectorTime * 1e3 / BENCH_FRAMES, vectorEventTime * 1e3 / BENCH_FRAMES,
+           scalarTime * 1e3 / BENCH_FRAMES, scalarEventTime * 1e3 / BENCH_FRAMES);
+
+    FreeListAnimators(managers);
+    FreeAnimatorStore(&vector);
+    FreeAnimatorStore(&scalar);
+    FreeAnimationEvents(&events);
+    return true;
+}
+
+int main(void) {
+    bool ok = true;
+    InitAssetManager();
+    if (!LoadBenchClips()) {
+        printf("Error: Failed to register the benchmark clips.\n");
+        return 1;
+    }
+
+    printf("Animator update (pointer loop against the animator store)\n");
+    if (!BenchUpdatePaths(BENCH_ANIMATORS)) {
+        printf("Error: Failed to set up the animators.\n");
+        ok = false;
+    }
+
+    printf("Animator paths (list and store show the same frames and events)\n");
+    if (!CheckListAgainstStore(BENCH_ANIMATORS)) {
+        printf("Error: The animator list and store disagree.\n");
+        ok = false;
+    }
+
+    printf("Animator kernels (SSE2 against scalar)\n");
+    if (!CheckKernels(BENCH_ANIMATORS)) {
+        printf("Error: The SSE2 and scalar kernels disagree.\n");
+        ok = false;
+    }
+
+    UnloadAnimationClips();
+    UnloadAssetManager();
+    return ok ? 0 : 1;
+}
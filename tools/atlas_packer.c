@@ -0,0 +1,449 @@
+// =============================================================
+// Texture atlas packer
+// =============================================================
+// Offline tool behind `make atlas`. Packs every PNG under an image
+// directory onto atlas pages with a MaxRects packer (best short side
+// fit) and writes the pages plus the manifest read by
+// src/sprite/texture_atlas.c.
+//
+// Usage: atlas_packer <image dir> <output dir> [page size] [padding]
+// The output directory must already exist.
+
+#include "raylib.h"
+#include "sprite/texture_atlas.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Packer constants
+#define DEFAULT_PAGE_SIZE 2048
+#define DEFAULT_PADDING 2
+#define MAX_PAGE_SIZE 16384
+#define MAX_ATLAS_PAGES 64
+#define MAX_ATLAS_PATH_LENGTH 512
+
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} PackRect;
+
+// One page being packed. Free space is kept as maximal free rectangles,
+// which may overlap each other.
+typedef struct {
+    PackRect* freeRects;
+    size_t freeCount;
+    size_t freeCapacity;
+    int usedWidth;    // Bounding box of everything placed so far
+    int usedHeight;
+    int width;        // Final page size, set once packing is done
+    int height;
+    size_t usedArea;  // Pixels covered by images, without padding
+} PackPage;
+
+typedef struct {
+    char name[MAX_ATLAS_PATH_LENGTH];
+    Image image;
+    int page;
+    PackRect rect;
+} PackImage;
+
+static PackPage g_pages[MAX_ATLAS_PAGES];
+static int g_pageCount = 0;
+
+static bool IsHostLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static bool PushFreeRect(PackPage* page, PackRect rect) {
+    if (page->freeCount == page->freeCapacity) {
+        size_t capacity = page->freeCapacity ? page->freeCapacity * 2 : 64;
+        PackRect* rects = (PackRect*)realloc(page->freeRects, capacity * sizeof(PackRect));
+        if (rects == NULL) {
+            printf("Error: Out of memory while packing.\n");
+            return false;
+        }
+        page->freeRects = rects;
+        page->freeCapacity = capacity;
+    }
+    page->freeRects[page->freeCount++] = rect;
+    return true;
+}
+
+static bool ContainsRect(PackRect outer, PackRect inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+// Best short side fit: the free rect leaving the smallest leftover on
+// its tighter side. Returns false when nothing fits.
+static bool FindPosition(const PackPage* page, int width, int height, PackRect* outRect) {
+    int bestShort = INT_MAX;
+    int bestLong = INT_MAX;
+    for (size_t i = 0; i < page->freeCount; i++) {
+        PackRect free = page->freeRects[i];
+        if (free.width < width || free.height < height) continue;
+        int leftoverX = free.width - width;
+        int leftoverY = free.height - height;
+        int shortSide = leftoverX < leftoverY ? leftoverX : leftoverY;
+        int longSide = leftoverX < leftoverY ? leftoverY : leftoverX;
+        if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+            bestShort = shortSide;
+            bestLong = longSide;
+            *outRect = (PackRect){ free.x, free.y, width, height };
+        }
+    }
+    return bestShort != INT_MAX;
+}
+
+// Carve a placed rect out of every free rect it overlaps, then drop
+// free rects that are contained in another one
+static bool PlaceRect(PackPage* page, PackRect used) {
+    size_t count = page->freeCount;
+    for (size_t i = 0; i < count; i++) {
+        PackRect free = page->freeRects[i];
+        if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+            used.y >= free.y + free.height || used.y + used.height <= free.y) {
+            continue;
+        }
+        bool ok = true;
+        if (used.x > free.x) {
+            ok &= PushFreeRect(page, (PackRect){ free.x, free.y, used.x - free.x, free.height });
+        }
+        if (used.x + used.width < free.x + free.width) {
+            int right = used.x + used.width;
+            ok &= PushFreeRect(page, (PackRect){ right, free.y, free.x + free.width - right, free.height });
+        }
+        if (used.y > free.y) {
+            ok &= PushFreeRect(page, (PackRect){ free.x, free.y, free.width, used.y - free.y });
+        }
+        if (used.y + used.height < free.y + free.height) {
+            int bottom = used.y + used.height;
+            ok &= PushFreeRect(page, (PackRect){ free.x, bottom, free.width, free.y + free.height - bottom });
+        }
+        if (!ok) return false;
+        // Mark the split rect for removal
+        page->freeRects[i].width = 0;
+    }
+
+    // Containment is transitive, so rects already dropped can be skipped
+    for (size_t i = 0; i < page->freeCount; i++) {
+        PackRect rect = page->freeRects[i];
+        if (rect.width <= 0) continue;
+        for (size_t j = 0; j < page->freeCount; j++) {
+            PackRect other = page->freeRects[j];
+            if (j == i || other.width <= 0 || !ContainsRect(other, rect)) continue;
+            // Of two identical rects, keep the first
+            if (!ContainsRect(rect, other) || j < i) {
+                page->freeRects[i].width = 0;
+                break;
+            }
+        }
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < page->freeCount; i++) {
+        if (page->freeRects[i].width > 0) page->freeRects[kept++] = page->freeRects[i];
+    }
+    page->freeCount = kept;
+
+    if (used.x + used.width > page->usedWidth) page->usedWidth = used.x + used.width;
+    if (used.y + used.height > page->usedHeight) page->usedHeight = used.y + used.height;
+    return true;
+}
+
+static bool AddPage(int width, int height, int maxPages) {
+    if (g_pageCount >= maxPages) return false;
+    PackPage* page = &g_pages[g_pageCount];
+    page->freeCount = 0;
+    page->usedWidth = 0;
+    page->usedHeight = 0;
+    page->usedArea = 0;
+    if (!PushFreeRect(page, (PackRect){ 0, 0, width, height })) return false;
+    g_pageCount++;
+    return true;
+}
+
+// Place an image on the first page it fits on, opening a page if needed
+static bool PackImageRect(PackImage* image, int width, int height, int padding, int maxPages) {
+    // Padding only separates images, so it may hang off the page edge
+    int paddedWidth = image->image.width + padding < width ? image->image.width + padding : width;
+    int paddedHeight = image->image.height + padding < height ? image->image.height + padding : height;
+    if (image->image.width > width || image->image.height > height) return false;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        for (int p = 0; p < g_pageCount; p++) {
+            PackRect rect;
+            if (!FindPosition(&g_pages[p], paddedWidth, paddedHeight, &rect)) continue;
+            if (!PlaceRect(&g_pages[p], rect)) return false;
+            image->page = p;
+            image->rect = (PackRect){ rect.x, rect.y, image->image.width, image->image.height };
+            g_pages[p].usedArea += (size_t)image->image.width * image->image.height;
+            return true;
+        }
+        if (!AddPage(width, height, maxPages)) return false;
+    }
+    return false;
+}
+
+// Pack every image onto pages of one size, starting over from empty pages
+static bool PackAllImages(PackImage* images, int imageCount, int width, int height, int padding, int maxPages) {
+    g_pageCount = 0;
+    for (int i = 0; i < imageCount; i++) {
+        if (!PackImageRect(&images[i], width, height, padding, maxPages)) return false;
+    }
+    return true;
+}
+
+// Largest side first, then largest area
+static int CompareImagesBySize(const void* a, const void* b) {
+    const PackImage* left = (const PackImage*)a;
+    const PackImage* right = (const PackImage*)b;
+    int leftSide = left->image.width > left->image.height ? left->image.width : left->image.height;
+    int rightSide = right->image.width > right->image.height ? right->image.width : right->image.height;
+    if (leftSide != rightSide) return rightSide - leftSide;
+    long long leftArea = (long long)left->image.width * left->image.height;
+    long long rightArea = (long long)right->image.width * right->image.height;
+    return (leftArea < rightArea) - (leftArea > rightArea);
+}
+
+static int CompareImagesByName(const void* a, const void* b) {
+    return strcmp(((const PackImage*)a)->name, ((const PackImage*)b)->name);
+}
+
+static int RoundUpToPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+// Copy every image onto its page and export the pages
+static bool WritePages(PackImage* images, int imageCount, const char* outputDir, char pagePaths[][MAX_ATLAS_PATH_LENGTH]) {
+    for (int p = 0; p < g_pageCount; p++) {
+        PackPage* page = &g_pages[p];
+        Color* pixels = (Color*)calloc((size_t)page->width * page->height, sizeof(Color));
+        if (pixels == NULL) {
+            printf("Error: Out of memory while writing atlas pages.\n");
+            return false;
+        }
+        for (int i = 0; i < imageCount; i++) {
+            if (images[i].page != p) continue;
+            const Color* source = (const Color*)images[i].image.data;
+            PackRect rect = images[i].rect;
+            for (int row = 0; row < rect.height; row++) {
+                memcpy(&pixels[(size_t)(rect.y + row) * page->width + rect.x],
+                       &source[(size_t)row * rect.width], (size_t)rect.width * sizeof(Color));
+            }
+        }
+        Image pageImage = { pixels, page->width, page->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        snprintf(pagePaths[p], MAX_ATLAS_PATH_LENGTH, "%s/atlas_%d.png", outputDir, p);
+        bool exported = ExportImage(pageImage, pagePaths[p]);
+        free(pixels);
+        if (!exported) {
+            printf("Error: Could not write %s\n", pagePaths[p]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write the manifest: header, pages, entries sorted by name, strings
+static bool WriteManifest(const PackImage* images, int imageCount, const char* outputDir,
+                          char pagePaths[][MAX_ATLAS_PATH_LENGTH]) {
+    size_t stringsSize = 0;
+    for (int p = 0; p < g_pageCount; p++) stringsSize += strlen(pagePaths[p]) + 1;
+    for (int i = 0; i < imageCount; i++) stringsSize += strlen(images[i].name) + 1;
+
+    TextureAtlasHeader header = {0};
+    memcpy(header.magic, TEXTURE_ATLAS_MAGIC, 4);
+    header.version = TEXTURE_ATLAS_VERSION;
+    header.headerSize = sizeof(TextureAtlasHeader);
+    header.pageCount = (uint32_t)g_pageCount;
+    header.entryCount = (uint32_t)imageCount;
+    header.pagesOffset = sizeof(TextureAtlasHeader);
+    header.entriesOffset = header.pagesOffset + header.pageCount * sizeof(TextureAtlasPage);
+    header.stringsOffset = header.entriesOffset + header.entryCount * sizeof(TextureAtlasEntry);
+    header.stringsSize = (uint32_t)stringsSize;
+
+    TextureAtlasPage* pages = (TextureAtlasPage*)calloc((size_t)g_pageCount, sizeof(TextureAtlasPage));
+    TextureAtlasEntry* entries = (TextureAtlasEntry*)calloc((size_t)imageCount + 1, sizeof(TextureAtlasEntry));
+    char* strings = (char*)malloc(stringsSize);
+    if (pages == NULL || entries == NULL || strings == NULL) {
+        printf("Error: Out of memory while writing the atlas manifest.\n");
+        free(pages);
+        free(entries);
+        free(strings);
+        return false;
+    }
+
+    size_t offset = 0;
+    for (int p = 0; p < g_pageCount; p++) {
+        size_t length = strlen(pagePaths[p]) + 1;
+        memcpy(strings + offset, pagePaths[p], length);
+        pages[p] = (TextureAtlasPage){ (uint32_t)offset, (uint16_t)g_pages[p].width, (uint16_t)g_pages[p].height };
+        offset += length;
+    }
+    for (int i = 0; i < imageCount; i++) {
+        size_t length = strlen(images[i].name) + 1;
+        memcpy(strings + offset, images[i].name, length);
+        const PackRect rect = images[i].rect;
+        entries[i] = (TextureAtlasEntry){
+            (uint32_t)offset, (uint16_t)images[i].page, 0,
+            (uint16_t)rect.x, (uint16_t)rect.y, (uint16_t)rect.width, (uint16_t)rect.height
+        };
+        offset += length;
+    }
+
+    char manifestPath[MAX_ATLAS_PATH_LENGTH];
+    snprintf(manifestPath, sizeof(manifestPath), "%s/atlas.bin", outputDir);
+    FILE* file = fopen(manifestPath, "wb");
+    bool ok = file != NULL &&
+              fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(pages, sizeof(TextureAtlasPage), (size_t)g_pageCount, file) == (size_t)g_pageCount &&
+              fwrite(entries, sizeof(TextureAtlasEntry), (size_t)imageCount, file) == (size_t)imageCount &&
+              fwrite(strings, 1, stringsSize, file) == stringsSize;
+    if (file != NULL && fclose(file) != 0) ok = false;
+    if (!ok) printf("Error: Could not write %s\n", manifestPath);
+
+    free(pages);
+    free(entries);
+    free(strings);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Usage: %s <image dir> <output dir> [page size] [padding]\n", argv[0]);
+        return 1;
+    }
+    const char* inputDir = argv[1];
+    const char* outputDir = argv[2];
+    int pageSize = argc > 3 ? atoi(argv[3]) : DEFAULT_PAGE_SIZE;
+    int padding = argc > 4 ? atoi(argv[4]) : DEFAULT_PADDING;
+    if (pageSize <= 0 || pageSize > MAX_PAGE_SIZE || padding < 0) {
+        printf("Error: Page size must be 1-%d and padding non-negative.\n", MAX_PAGE_SIZE);
+        return 1;
+    }
+    if (!IsHostLittleEndian()) {
+        printf("Error: The atlas manifest can only be written on little-endian hosts.\n");
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    FilePathList files = LoadDirectoryFilesEx(inputDir, ".png", true);
+    PackImage* images = (PackImage*)calloc(files.count + 1, sizeof(PackImage));
+    if (images == NULL) {
+        printf("Error: Out of memory.\n");
+        UnloadDirectoryFiles(files);
+        return 1;
+    }
+
+    // Load every image as RGBA8; names use forward slashes, as in the game's paths
+    int imageCount = 0;
+    size_t sourceBytes = 0;
+    for (unsigned int i = 0; i < files.count; i++) {
+        PackImage* image = &images[imageCount];
+        if (strlen(files.paths[i]) >= MAX_ATLAS_PATH_LENGTH) {
+            printf("Warning: Skipping %s, path too long.\n", files.paths[i]);
+            continue;
+        }
+        strcpy(image->name, files.paths[i]);
+        for (char* c = image->name; *c != '\0'; c++) {
+            if (*c == '\\') *c = '/';
+        }
+        image->image = LoadImage(files.paths[i]);
+        if (image->image.data == NULL) {
+            printf("Warning: Skipping %s, could not load it.\n", image->name);
+            continue;
+        }
+        ImageFormat(&image->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        // What the images cost as separate textures
+        sourceBytes += (size_t)image->image.width * image->image.height * sizeof(Color);
+        imageCount++;
+    }
+    UnloadDirectoryFiles(files);
+    if (imageCount == 0) {
+        printf("Error: No PNG images found under %s\n", inputDir);
+        free(images);
+        return 1;
+    }
+
+    for (int i = 0; i < imageCount; i++) {
+        if (images[i].image.width > pageSize || images[i].image.height > pageSize) {
+            printf("Error: %s (%dx%d) does not fit on a %dx%d page.\n",
+                   images[i].name, images[i].image.width, images[i].image.height, pageSize, pageSize);
+            for (int j = 0; j < imageCount; j++) UnloadImage(images[j].image);
+            free(images);
+            return 1;
+        }
+    }
+    qsort(images, (size_t)imageCount, sizeof(PackImage), CompareImagesBySize);
+
+    // MaxRects spreads images over an empty page, so first look for the
+    // smallest power-of-two page that holds everything, growing it one
+    // side at a time. Only if none does, fill as many full pages as needed.
+    size_t paddedArea = 0;
+    for (int i = 0; i < imageCount; i++) {
+        paddedArea += (size_t)(images[i].image.width + padding) * (images[i].image.height + padding);
+    }
+    int width = 1;
+    while ((size_t)width * width < paddedArea && width < pageSize) width <<= 1;
+    if (width > pageSize) width = pageSize;
+    int height = width;
+    bool ok = false;
+    while (!ok && (width < pageSize || height < pageSize)) {
+        ok = PackAllImages(images, imageCount, width, height, padding, 1);
+        if (ok) break;
+        if (width <= height && width < pageSize) {
+            width = width * 2 < pageSize ? width * 2 : pageSize;
+        } else {
+            height = height * 2 < pageSize ? height * 2 : pageSize;
+        }
+    }
+    if (!ok) {
+        ok = PackAllImages(images, imageCount, pageSize, pageSize, padding, MAX_ATLAS_PAGES);
+        if (!ok) {
+            printf("Error: Images do not fit on %d pages of %dx%d.\n", MAX_ATLAS_PAGES, pageSize, pageSize);
+        }
+    }
+
+    // Trim each page to the power of two around what it holds
+    size_t pageBytes = 0;
+    size_t usedArea = 0;
+    for (int p = 0; p < g_pageCount; p++) {
+        g_pages[p].width = RoundUpToPowerOfTwo(g_pages[p].usedWidth);
+        g_pages[p].height = RoundUpToPowerOfTwo(g_pages[p].usedHeight);
+        if (g_pages[p].width > pageSize) g_pages[p].width = pageSize;
+        if (g_pages[p].height > pageSize) g_pages[p].height = pageSize;
+        pageBytes += (size_t)g_pages[p].width * g_pages[p].height * sizeof(Color);
+        usedArea += g_pages[p].usedArea;
+    }
+
+    static char pagePaths[MAX_ATLAS_PAGES][MAX_ATLAS_PATH_LENGTH];
+    if (ok) {
+        qsort(images, (size_t)imageCount, sizeof(PackImage), CompareImagesByName);
+        ok = WritePages(images, imageCount, outputDir, pagePaths) &&
+             WriteManifest(images, imageCount, outputDir, pagePaths);
+    }
+
+    if (ok) {
+        printf("Packed %d images onto %d page(s):\n", imageCount, g_pageCount);
+        for (int p = 0; p < g_pageCount; p++) {
+            double area = (double)g_pages[p].width * g_pages[p].height;
+            printf("  %s  %dx%d  %.1f%% used\n", pagePaths[p], g_pages[p].width, g_pages[p].height,
+                   100.0 * (double)g_pages[p].usedArea / area);
+        }
+        printf("Packing efficiency: %.1f%%\n", 100.0 * (double)(usedArea * sizeof(Color)) / (double)pageBytes);
+        printf("Textures: %d -> %d (%.1f%% fewer)\n", imageCount, g_pageCount,
+               100.0 * (double)(imageCount - g_pageCount) / imageCount);
+        printf("Texture memory: %zu KiB -> %zu KiB\n", sourceBytes / 1024, pageBytes / 1024);
+    }
+
+    for (int i = 0; i < imageCount; i++) UnloadImage(images[i].image);
+    for (int p = 0; p < MAX_ATLAS_PAGES; p++) free(g_pages[p].freeRects);
+    free(images);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+// =============================================================
+// Entity benchmark
+// =============================================================
+// Headless benchmark behind `make bench`. Links the engine sources
+// against tools/raylib_stub.c and times the EntityManager paths that
+// scale with entity count.
+//
+// Usage: entity_bench
+
+#include "entity/entity_manager.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Timed sections run this many times and report the fastest
+#define BENCH_TRIALS 5
+
+static uint32_t g_benchSeed = 12345u;
+
+// Small deterministic generator, so runs are comparable
+static uint32_t BenchRandom(void) {
+    g_benchSeed = g_benchSeed * 1664525u + 1013904223u;
+    return g_benchSeed >> 8;
+}
+
+static double BenchSeconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void ShuffleHandles(EntityHandle* handles, size_t count) {
+    for (size_t i = count; i > 1; i--) {
+        size_t j = BenchRandom() % i;
+        EntityHandle swap = handles[i - 1];
+        handles[i - 1] = handles[j];
+        handles[j] = swap;
+    }
+}
+
+// Add, look up and remove count entities in random order. Returns false
+// if a lookup misses or a stale handle still resolves.
+static bool BenchHandles(size_t count) {
+    EntityManager manager;
+    InitEntityManager(&manager);
+    EntityHandle* handles = (EntityHandle*)malloc(count * sizeof(EntityHandle));
+    if (handles == NULL) return false;
+
+    double start = BenchSeconds();
+    for (size_t i = 0; i < count; i++) {
+        Entity* entity = CreateEntity();
+        entity->id = (int)i;
+        handles[i] = AddEntity(&manager, entity);
+    }
+    double added = BenchSeconds();
+
+    ShuffleHandles(handles, count);
+    size_t found = 0;
+    double lookupStart = BenchSeconds();
+    for (size_t i = 0; i < count; i++) {
+        found += GetEntity(&manager, handles[i]) != NULL;
+    }
+    double looked = BenchSeconds();
+
+    for (size_t i = 0; i < count; i++) {
+        RemoveEntityByHandle(&manager, handles[i]);
+    }
+    double removed = BenchSeconds();
+
+    size_t stale = 0;
+    for (size_t i = 0; i < count; i++) {
+        stale += GetEntity(&manager, handles[i]) != NULL;
+    }
+    printf("  %7zu entities: add %6.1f ns, lookup %6.1f ns, remove %6.1f ns per entity\n", count,
+           (added - start) * 1e9 / count, (looked - lookupStart) * 1e9 / count, (removed - looked) * 1e9 / count);
+
+    free(handles);
+    FreeEntityManager(&manager);
+    return found == count && stale == 0;
+}
+
+// Move every active entity by a fixed velocity, frames times, through the
+// old layout (one heap allocation per entity, next to its sprite, reached
+// through a pointer array) and through the component store. The pointer
+// array is shuffled, as spawn and despawn churn leaves it out of heap
+// order. Returns the speedup of the component store.
+static double BenchUpdateLayouts(size_t count, int frames) {
+    const Vector2 velocity = { 30.0f, -12.0f };
+    const float deltaTime = 1.0f / 60.0f;
+
+    Entity** byRow = (Entity**)malloc(count * sizeof(Entity*));
+    Entity** scattered = (Entity**)malloc(count * sizeof(Entity*));
+    SpriteObject** sprites = (SpriteObject**)malloc(count * sizeof(SpriteObject*));
+    EntityManager manager;
+    InitEntityManagerWithCapacity(&manager, count, 0);
+    for (size_t i = 0; i < count; i++) {
+        scattered[i] = byRow[i] = (Entity*)calloc(1, sizeof(Entity));
+        sprites[i] = (SpriteObject*)calloc(1, sizeof(SpriteObject));
+        scattered[i]->isActive = i % 8 != 0;
+        scattered[i]->position = (Vector2){ (float)(BenchRandom() % 4096), (float)(BenchRandom() % 4096) };
+        Entity* entity = CreateEntity();
+        *entity = *scattered[i];
+        AddEntity(&manager, entity);
+    }
+    EnableEntityComponentStore(&manager);
+    for (size_t i = count; i > 1; i--) {
+        size_t j = BenchRandom() % i;
+        Entity* swap = scattered[i - 1];
+        scattered[i - 1] = scattered[j];
+        scattered[j] = swap;
+    }
+
+    // Best of several trials, for both layouts
+    const Vector2 step = { velocity.x * deltaTime, velocity.y * deltaTime };
+    double pointerTime = 0.0;
+    double storeTime = 0.0;
+    for (int trial = 0; trial < BENCH_TRIALS; trial++) {
+        double start = BenchSeconds();
+        for (int frame = 0; frame < frames; frame++) {
+            for (size_t i = 0; i < count; i++) {
+                Entity* entity = scattered[i];
+                if (!entity->isActive) continue;
+                entity->position.x += step.x;
+                entity->position.y += step.y;
+            }
+        }
+        double elapsed = BenchSeconds() - start;
+        if (trial == 0 || elapsed < pointerTime) pointerTime = elapsed;
+
+        start = BenchSeconds();
+        for (int frame = 0; frame < frames; frame++) {
+            EntityComponentSpan span;
+            for (size_t s = 0; GetEntityComponentSpan(&manager, s, &span); s++) {
+                // Inactive rows add zero instead of branching, so the loop stays tight
+                for (size_t base = 0; base < span.count; base += ENTITY_ACTIVE_WORD_BITS) {
+                    uint64_t bits = span.active[base / ENTITY_ACTIVE_WORD_BITS];
+                    size_t rows = span.count - base < ENTITY_ACTIVE_WORD_BITS ? span.count - base : ENTITY_ACTIVE_WORD_BITS;
+                    Vector2* positions = span.positions + base;
+                    for (size_t r = 0; r < rows; r++) {
+                        bool active = (bits >> r) & 1u;
+                        positions[r].x += active ? step.x : 0.0f;
+                        positions[r].y += active ? step.y : 0.0f;
+                    }
+                }
+            }
+        }
+        elapsed = BenchSeconds() - start;
+        if (trial == 0 || elapsed < storeTime) storeTime = elapsed;
+    }
+
+    // Both layouts must end up in the same place
+    SyncEntityViews(&manager);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Entity* entity = GetEntityAtRow(&manager, i);
+        mismatches += entity->position.x != byRow[i]->position.x || entity->position.y != byRow[i]->position.y;
+    }
+    printf("  %7zu entities: pointer loop %6.2f ms, component store %6.2f ms per frame (%.1fx)\n", count,
+           pointerTime * 1e3 / frames, storeTime * 1e3 / frames, pointerTime / storeTime);
+    if (mismatches > 0) printf("Error: %zu entities ended up in different places.\n", mismatches);
+
+    for (size_t i = 0; i < count; i++) {
+        free(byRow[i]);
+        free(sprites[i]);
+    }
+    free(byRow);
+    free(scattered);
+    free(sprites);
+    FreeEntityManager(&manager);
+    return mismatches == 0 ? pointerTime / storeTime : 0.0;
+}
+
+// The scan GetEntityByName did before the name index
+static Entity* FindEntityByNameScan(const EntityManager* manager, const char* name) {
+    for (size_t i = 0; i < manager->entityCount; i++) {
+        Entity* entity = GetEntityAtRow(manager, i);
+        if (strcmp(entity->name, name) == 0) return entity;
+    }
+    return NULL;
+}
+
+// Look up random names through the index and through a linear scan.
+// Returns false if the two disagree.
+static bool BenchNameLookup(size_t count, size_t lookups) {
+    EntityManager manager;
+    InitEntityManagerWithCapacity(&manager, count, 0);
+    for (size_t i = 0; i < count; i++) {
+        Entity* entity = CreateEntity();
+        snprintf(entity->name, MAX_ENTITY_NAME_LENGTH, "entity_%zu", i);
+        AddEntity(&manager, entity);
+    }
+    char (*names)[MAX_ENTITY_NAME_LENGTH] = (char (*)[MAX_ENTITY_NAME_LENGTH])malloc(lookups * sizeof(*names));
+    for (size_t i = 0; i < lookups; i++) {
+        snprintf(names[i], MAX_ENTITY_NAME_LENGTH, "entity_%u", (unsigned)(BenchRandom() % count));
+    }
+
+    Entity** indexed = (Entity**)malloc(lookups * sizeof(Entity*));
+    double start = BenchSeconds();
+    for (size_t i = 0; i < lookups; i++) {
+        indexed[i] = GetEntityByName(&manager, names[i]);
+    }
+    double indexTime = BenchSeconds() - start;
+
+    size_t mismatches = 0;
+    start = BenchSeconds();
+    for (size_t i = 0; i < lookups; i++) {
+        Entity* found = FindEntityByNameScan(&manager, names[i]);
+        mismatches += found == NULL || found != indexed[i];
+    }
+    double scanTime = BenchSeconds() - start;
+    printf("  %7zu entities: index %8.1f ns, scan %10.1f ns per lookup (%.0fx)\n", count,
+           indexTime * 1e9 / lookups, scanTime * 1e9 / lookups, scanTime / indexTime);
+
+    free(indexed);
+    free(names);
+    FreeEntityManager(&manager);
+    return mismatches == 0;
+}
+
+// The all-pairs test the demo screens did by hand, with the grid's
+// touching-counts-as-overlap rule
+static size_t CountPairsBruteForce(const Rectangle* bounds, size_t count) {
+    size_t pairs = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            pairs += bounds[i].x <= bounds[j].x + bounds[j].width && bounds[j].x <= bounds[i].x + bounds[i].width &&
+                     bounds[i].y <= bounds[j].y + bounds[j].height && bounds[j].y <= bounds[i].y + bounds[i].height;
+        }
+    }
+    return pairs;
+}
+
+// Move count entities at constant density for a few frames and find
+// collision pairs through the grid; optionally check the last frame
+// against brute force. Returns false if the pair counts differ.
+static bool BenchBroadphase(size_t count, bool bruteForce) {
+    const int frames = 10;
+    const float worldSize = sqrtf((float)count) * 48.0f;
+    EntityManager manager;
+    InitEntityManagerWithCapacity(&manager, count, 0);
+    SetEntityGridCellSize(&manager, 32.0f);
+    Entity** entities = (Entity**)malloc(count * sizeof(Entity*));
+    Vector2* velocities = (Vector2*)malloc(count * sizeof(Vector2));
+    Rectangle* bounds = (Rectangle*)malloc(count * sizeof(Rectangle));
+    for (size_t i = 0; i < count; i++) {
+        Entity* entity = CreateEntity();
+        entity->isActive = true;
+        entity->position = (Vector2){ (float)(BenchRandom() % (uint32_t)worldSize), (float)(BenchRandom() % (uint32_t)worldSize) };
+        entity->hitbox = (Hitbox_t){ 0, 0, 16, 16 };
+        velocities[i] = (Vector2){ (float)(BenchRandom() % 9) - 4.0f, (float)(BenchRandom() % 9) - 4.0f };
+        entities[i] = entity;
+        AddEntity(&manager, entity);
+    }
+
+    size_t pairs = 0;
+    double start = BenchSeconds();
+    for (int frame = 0; frame < frames; frame++) {
+        for (size_t i = 0; i < count; i++) {
+            Vector2 position = entities[i]->position;
+            SetEntityPosition(&manager, entities[i], (Vector2){ position.x + velocities[i].x, position.y + velocities[i].y });
+        }
+        pairs = FindEntityCollisionPairs(&manager, NULL, 0);
+    }
+    double gridTime = (BenchSeconds() - start) / frames;
+
+    bool ok = true;
+    if (bruteForce) {
+        for (size_t i = 0; i < count; i++) bounds[i] = GetEntityBounds(entities[i]);
+        start = BenchSeconds();
+        size_t expected = CountPairsBruteForce(bounds, count);
+        double bruteTime = BenchSeconds() - start;
+        printf("  %7zu entities: grid %7.2f ms per frame (%.1f ns per entity), %zu pairs; brute force %.2f ms (%.0fx)\n", count,
+               gridTime * 1e3, gridTime * 1e9 / count, pairs, bruteTime * 1e3, bruteTime / gridTime);
+        ok = expected == pairs;
+    } else {
+        printf("  %7zu entities: grid %7.2f ms per frame (%.1f ns per entity), %zu pairs\n", count,
+               gridTime * 1e3, gridTime * 1e9 / count, pairs);
+    }
+
+    free(entities);
+    free(velocities);
+    free(bounds);
+    FreeEntityManager(&manager);
+    return ok;
+}
+
+int main(void) {
+    bool ok = true;
+
+    printf("Handle storage (random-order lookup and remove)\n");
+    const size_t handleCounts[] = { 1000, 10000, 100000 };
+    for (size_t i = 0; i < sizeof(handleCounts) / sizeof(handleCounts[0]); i++) {
+        if (!BenchHandles(handleCounts[i])) {
+            printf("Error: Handle lookups returned the wrong entities.\n");
+            ok = false;
+        }
+    }
+
+    // The component store has to be at least 4x the old layout at 50k
+    printf("Update throughput (move active entities)\n");
+    double speedup = BenchUpdateLayouts(50000, 100);
+    if (speedup < 4.0) {
+        printf("Error: Component store update is %.1fx the pointer loop, below the 4x target.\n", speedup);
+        ok = false;
+    }
+
+    printf("Name lookup (hash index against linear scan)\n");
+    if (!BenchNameLookup(255, 100000) || !BenchNameLookup(65536, 2000)) {
+        printf("Error: Name index and scan found different entities.\n");
+        ok = false;
+    }
+
+    // Per-entity cost should stay flat as the count grows
+    printf("Broadphase (moving entities, rebuild and pairs every frame)\n");
+    const size_t broadphaseCounts[] = { 5000, 10000, 20000 };
+    for (size_t i = 0; i < sizeof(broadphaseCounts) / sizeof(broadphaseCounts[0]); i++) {
+        if (!BenchBroadphase(broadphaseCounts[i], broadphaseCounts[i] == 20000)) {
+            printf("Error: Grid and brute force found different pair counts.\n");
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// =============================================================
+// Headless raylib stand-in
+// =============================================================
+// Definitions for the raylib calls made by the engine sources that
+// benches and tests link. Textures get fresh IDs and a fixed size and
+// nothing touches the disk; audio and fonts are empty handles.
+#include "raylib_stub.h"
+#include <string.h>
+
+RaylibStubCounters g_raylibStub = {0};
+
+void ResetRaylibStubCounters(void) {
+    unsigned int lastTextureId = g_raylibStub.lastTextureId;
+    memset(&g_raylibStub, 0, sizeof(g_raylibStub));
+    // Keep IDs unique across resets
+    g_raylibStub.lastTextureId = lastTextureId;
+}
+
+// Textures
+Texture2D LoadTexture(const char* fileName) {
+    (void)fileName;
+    g_raylibStub.textureLoads++;
+    return (Texture2D){ ++g_raylibStub.lastTextureId, STUB_TEXTURE_SIZE, STUB_TEXTURE_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+}
+
+void UnloadTexture(Texture2D texture) {
+    (void)texture;
+    g_raylibStub.textureUnloads++;
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    (void)source; (void)dest; (void)origin; (void)rotation; (void)tint;
+    g_raylibStub.textureDraws++;
+    if (texture.id != g_raylibStub.lastDrawnTextureId) g_raylibStub.textureBinds++;
+    g_raylibStub.lastDrawnTextureId = texture.id;
+}
+
+// Render state
+void BeginBlendMode(int mode) { (void)mode; g_raylibStub.blendModes++; }
+void EndBlendMode(void) {}
+void BeginMode2D(Camera2D camera) { (void)camera; }
+void EndMode2D(void) {}
+
+// Fonts
+Font LoadFontEx(const char* fileName, int fontSize, int* codepoints, int codepointCount) {
+    (void)fileName; (void)fontSize; (void)codepoints; (void)codepointCount;
+    return (Font){0};
+}
+void UnloadFont(Font font) { (void)font; }
+Font GetFontDefault(void) { return (Font){0}; }
+
+// Audio
+Sound LoadSound(const char* fileName) { (void)fileName; return (Sound){0}; }
+void UnloadSound(Sound sound) { (void)sound; }
+void PlaySound(Sound sound) { (void)sound; }
+Music LoadMusicStream(const char* fileName) { (void)fileName; return (Music){0}; }
+void UnloadMusicStream(Music music) { (void)music; }
+void PlayMusicStream(Music music) { (void)music; }
+void StopMusicStream(Music music) { (void)music; }
@@ -0,0 +1,29 @@
+// =============================================================
+// Headless raylib stand-in header
+// =============================================================
+// Counters kept by tools/raylib_stub.c. Benches and tests link the stub
+// instead of raylib, so they run without a window, GPU or audio device,
+// and can check how often the engine loads, releases and draws textures.
+#ifndef RAYLIB_STUB_H
+#define RAYLIB_STUB_H
+
+#include "raylib.h"
+
+// Size of every texture the stub "loads"
+#define STUB_TEXTURE_SIZE 256
+
+typedef struct {
+    int textureLoads;   // LoadTexture calls, the only engine path that reads image files
+    int textureUnloads;
+    int textureDraws;   // DrawTexturePro calls
+    int textureBinds;   // Draws with a different texture than the draw before
+    int blendModes;     // BeginBlendMode calls
+    unsigned int lastTextureId;
+    unsigned int lastDrawnTextureId;
+} RaylibStubCounters;
+
+extern RaylibStubCounters g_raylibStub;
+
+void ResetRaylibStubCounters(void);
+
+#endif // RAYLIB_STUB_H